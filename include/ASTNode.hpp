@@ -1,7 +1,11 @@
 #pragma once
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
 #include <memory>
+#include <memory_resource>
 #include <utility>
 #include <vector>
 
@@ -10,7 +14,7 @@
 
 namespace frontend {
 
-enum class NodeType {
+enum class NodeType : std::uint8_t {
     Identifier,
     NumericLiteral,
     StringLiteral,
@@ -42,33 +46,85 @@ enum class NodeType {
     NotEquals
 };
 
+class ASTNode;
+class Expression;
+// The children of the node classes, as the owning pointers that hold them (see Visitor.hpp).
+struct ChildSlots;
+
+// Deletes heap-allocated nodes. Nodes allocated in an Arena are left alone,
+// they are freed together with the arena (see NodeFactory). Subtrees are
+// deleted from an explicit stack, so any depth is safe to destroy.
+struct NodeDeleter {
+    void operator()(ASTNode* node) const noexcept;
+};
+
+// The stack of NodeDeleter, linked through the nodes themselves so that deleting
+// never allocates: a node waiting for deletion keeps the next one in place of its
+// offset, which nothing reads any more.
+class PendingNodes {
+public:
+    bool empty() const noexcept { return m_top == nullptr; }
+    void push(ASTNode* node) noexcept;
+    ASTNode* pop() noexcept;
+
+private:
+    ASTNode* m_top = nullptr;
+};
+
+template <typename T>
+using NodePtr = std::unique_ptr<T, NodeDeleter>;
+
+// Uses the same memory resource as the nodes it holds.
+using NodeList = std::pmr::vector<NodePtr<Expression>>;
+
 // Base class.
 class ASTNode {
 public:
     ASTNode(NodeType type, std::size_t from, std::size_t to) noexcept
-        : m_nodeType(type), m_from(from), m_to(to) {}
+        : m_nodeType(type), m_inArena(false), m_from(from), m_to(to) {}
     ASTNode(ASTNode&&) noexcept = default;
     ASTNode& operator=(ASTNode&&) noexcept = default;
     ASTNode(const ASTNode&) = delete;
     ASTNode& operator=(const ASTNode&) = delete;
     virtual ~ASTNode() = default;
+    friend class NodeFactory;
     NodeType nodeType() const noexcept { return m_nodeType; }
     std::size_t from() const noexcept { return m_from; }
     std::size_t to() const noexcept { return m_to; }
+    bool inArena() const noexcept { return m_inArena; }
     virtual void dump(std::ostream& os, std::size_t indent) const = 0;
-    
+
+    // Move the node when an edit before it, or inside it, changes the source length.
+    void shift(std::ptrdiff_t delta) noexcept
+    {
+        m_from += static_cast<std::size_t>(delta);
+        m_to += static_cast<std::size_t>(delta);
+    }
+    void shiftEnd(std::ptrdiff_t delta) noexcept { m_to += static_cast<std::size_t>(delta); }
+
 protected:
-    // Protected helper to print indentation.
+    // Protected helper to print indentation, a block of spaces at a time.
     static void printIndent(std::ostream& os, std::size_t indent)
     {
-        for (std::size_t i = 0; i < indent; ++i) {
-            os << ' ';
+        static constexpr char spaces[] = "                                                                ";
+        while (indent > 0) {
+            std::size_t count = std::min(indent, sizeof(spaces) - 1);
+            os.write(spaces, static_cast<std::streamsize>(count));
+            indent -= count;
         }
     }
 
+    friend class PendingNodes;
+
     const NodeType m_nodeType;
-    const std::size_t m_from;
-    const std::size_t m_to;
+    // Set by NodeFactory.
+    bool m_inArena;
+    union {
+        std::size_t m_from;
+        // The next node of PendingNodes, once this one waits for deletion.
+        ASTNode* m_nextPending;
+    };
+    std::size_t m_to;
 };
 
 class Expression : public ASTNode {
@@ -77,6 +133,19 @@ public:
     virtual ~Expression() = default;
 };
 
+inline void PendingNodes::push(ASTNode* node) noexcept
+{
+    node->m_nextPending = m_top;
+    m_top = node;
+}
+
+inline ASTNode* PendingNodes::pop() noexcept
+{
+    ASTNode* node = m_top;
+    m_top = node->m_nextPending;
+    return node;
+}
+
 class Identifier final : public Expression {
 public:
     Identifier(const string::FastString& identifier, std::size_t from, std::size_t to) noexcept
@@ -85,12 +154,13 @@ public:
     {
     }
     ~Identifier() = default;
+    const string::FastString& identifier() const noexcept { return m_identifier; }
     void dump(std::ostream& os, std::size_t indent) const override
     {
         ASTNode::printIndent(os, indent);
-        os << "Identifier" << std::endl;
+        os << "Identifier" << '\n';
         ASTNode::printIndent(os, indent);
-        os << "Value: " << m_identifier.str() << std::endl;
+        os << "Value: " << m_identifier.str() << '\n';
     }
 private:
     string::FastString m_identifier;
@@ -104,12 +174,13 @@ public:
     {
     }
     ~NumericLiteral() = default;
+    const string::FastString& literal() const noexcept { return m_literal; }
     void dump(std::ostream& os, std::size_t indent) const override
     {
         ASTNode::printIndent(os, indent);
-        os << "NumericLiteral" << std::endl;
+        os << "NumericLiteral" << '\n';
         ASTNode::printIndent(os, indent);
-        os << "Value: " << m_literal.str() << std::endl;
+        os << "Value: " << m_literal.str() << '\n';
     }
 private:
     string::FastString m_literal;
@@ -123,12 +194,13 @@ public:
     {
     }
     ~StringLiteral() = default;
+    const string::FastString& literal() const noexcept { return m_literal; }
     void dump(std::ostream& os, std::size_t indent) const override
     {
         ASTNode::printIndent(os, indent);
-        os << "StringLiteral" << std::endl;
+        os << "StringLiteral" << '\n';
         ASTNode::printIndent(os, indent);
-        os << "Value: " << m_literal.str() << std::endl;
+        os << "Value: " << m_literal.str() << '\n';
     }
 private:
     string::FastString m_literal;
@@ -136,63 +208,70 @@ private:
 
 class ArrayLiteral final : public Expression {
 public:
-    ArrayLiteral(std::vector<std::unique_ptr<Expression>>&& array, std::size_t from, std::size_t to) noexcept
+    friend struct ChildSlots;
+    ArrayLiteral(NodeList&& array, std::size_t from, std::size_t to) noexcept
         : Expression(NodeType::ArrayLiteral, from, to)
         , m_array(std::move(array))
     {
     }
     ~ArrayLiteral() = default;
+    const NodeList& elements() const noexcept { return m_array; }
     void dump(std::ostream& os, std::size_t indent) const override
     {
         ASTNode::printIndent(os, indent);
-        os << "ArrayLiteral" << std::endl;
+        os << "ArrayLiteral" << '\n';
         ASTNode::printIndent(os, indent);
-        os << " [" << std::endl;
+        os << " [" << '\n';
         bool first = true;
         for (const auto& element : m_array) {
             if (!first) {
-                os << std::endl;
+                os << '\n';
             }
             first = false;
             element->dump(os, indent + 2);
         }
         ASTNode::printIndent(os, indent);
-        os << " ]" << std::endl;
+        os << " ]" << '\n';
     }
 private:
-    std::vector<std::unique_ptr<Expression>> m_array;
+    NodeList m_array;
 };
 
 class UnaryOperator : public Expression {
 public:
-    UnaryOperator(NodeType type, std::unique_ptr<Expression>&& argument, std::size_t from, std::size_t to) noexcept
+    friend struct ChildSlots;
+    UnaryOperator(NodeType type, NodePtr<Expression>&& argument, std::size_t from, std::size_t to) noexcept
         : Expression(type, from, to)
         , m_argument(std::move(argument))
     {
     }
     virtual ~UnaryOperator() = default;
+    const Expression& argument() const noexcept { return *m_argument; }
 protected:
-    std::unique_ptr<Expression> m_argument;
+    NodePtr<Expression> m_argument;
 };
 
 class BinaryOperator : public Expression {
 public:
-    BinaryOperator(NodeType type, std::unique_ptr<Expression>&& lhs, std::unique_ptr<Expression>&& rhs) noexcept
+    friend struct ChildSlots;
+    BinaryOperator(NodeType type, NodePtr<Expression>&& lhs, NodePtr<Expression>&& rhs) noexcept
         : Expression(type, lhs->from(), rhs->to())
         , m_lhs(std::move(lhs))
         , m_rhs(std::move(rhs))
     {
     }
     virtual ~BinaryOperator() = default;
+    const Expression& lhs() const noexcept { return *m_lhs; }
+    const Expression& rhs() const noexcept { return *m_rhs; }
 protected:
-    std::unique_ptr<Expression> m_lhs;
-    std::unique_ptr<Expression> m_rhs;
+    NodePtr<Expression> m_lhs;
+    NodePtr<Expression> m_rhs;
 };
 
 #define DECLARE_BINARY_OPERATOR(CLASS_NAME)                                                         \
 class CLASS_NAME final : public BinaryOperator {                                                    \
 public:                                                                                             \
-    CLASS_NAME(std::unique_ptr<Expression>&& lhs, std::unique_ptr<Expression>&& rhs) noexcept         \
+    CLASS_NAME(NodePtr<Expression>&& lhs, NodePtr<Expression>&& rhs) noexcept                       \
         : BinaryOperator(NodeType::CLASS_NAME, std::move(lhs), std::move(rhs))                      \
     {                                                                                               \
     }                                                                                               \
@@ -200,7 +279,7 @@ public:
     void dump(std::ostream& os, std::size_t indent) const override                                  \
     {                                                                                               \
         ASTNode::printIndent(os, indent);                                                           \
-        os << #CLASS_NAME << std::endl;                                                             \
+        os << #CLASS_NAME << '\n';                                                                  \
         m_lhs->dump(os, indent + 1);                                                                \
         m_rhs->dump(os, indent + 1);                                                                \
     }                                                                                               \
@@ -215,85 +294,94 @@ DECLARE_BINARY_OPERATOR(Remainder)
 // Special binary operator, because rhs must be an Identifier.
 class MemberAccess final : public Expression {
 public:
-    MemberAccess(std::unique_ptr<Expression>&& argument, std::unique_ptr<Identifier>&& identifier) noexcept
+    friend struct ChildSlots;
+    MemberAccess(NodePtr<Expression>&& argument, NodePtr<Identifier>&& identifier) noexcept
         : Expression(NodeType::MemberAccess, argument->from(), identifier->to())
         , m_argument(std::move(argument))
         , m_identifier(std::move(identifier))
     {
     }
     ~MemberAccess() = default;
+    const Expression& argument() const noexcept { return *m_argument; }
+    const Identifier& identifier() const noexcept { return *m_identifier; }
     void dump(std::ostream& os, std::size_t indent) const override
     {
         ASTNode::printIndent(os, indent);
-        os << "MemberAccess" << std::endl;
+        os << "MemberAccess" << '\n';
         ASTNode::printIndent(os, indent);
-        os << " Argument" << std::endl;
+        os << " Argument" << '\n';
         m_argument->dump(os, indent + 2);
         m_identifier->dump(os, indent + 1);
     }
 private:
-    std::unique_ptr<Expression> m_argument;
-    std::unique_ptr<Identifier> m_identifier;
+    NodePtr<Expression> m_argument;
+    NodePtr<Identifier> m_identifier;
 };
 
 // Special case, only 'to' has to be explicitly provided.
 class FunctionCall final : public Expression {
 public:
-    FunctionCall(std::unique_ptr<Expression>&& function, std::vector<std::unique_ptr<Expression>>&& arguments, std::size_t to) noexcept
+    friend struct ChildSlots;
+    FunctionCall(NodePtr<Expression>&& function, NodeList&& arguments, std::size_t to) noexcept
         : Expression(NodeType::FunctionCall, function->from(), to)
         , m_function(std::move(function))
         , m_arguments(std::move(arguments))
     {
     }
     ~FunctionCall() = default;
+    const Expression& function() const noexcept { return *m_function; }
+    const NodeList& arguments() const noexcept { return m_arguments; }
     void dump(std::ostream& os, std::size_t indent) const override
     {
         ASTNode::printIndent(os, indent);
-        os << "FunctionCall" << std::endl;
+        os << "FunctionCall" << '\n';
         ASTNode::printIndent(os, indent);
-        os << " Function" << std::endl;
+        os << " Function" << '\n';
         m_function->dump(os, indent + 2);
         ASTNode::printIndent(os, indent);
-        os << " Arguments" << std::endl;
+        os << " Arguments" << '\n';
         for (const auto& argument : m_arguments) {
             argument->dump(os, indent + 2);
         }
     }
 private:
-    std::unique_ptr<Expression> m_function;
-    std::vector<std::unique_ptr<Expression>> m_arguments;
+    NodePtr<Expression> m_function;
+    NodeList m_arguments;
 };
 
 // Special case, only 'to' has to be explicitly provided.
 class SubscriptAccess final : public Expression {
 public:
-    SubscriptAccess(std::unique_ptr<Expression>&& argument, std::unique_ptr<Expression>&& subscript, std::size_t to) noexcept
+    friend struct ChildSlots;
+    SubscriptAccess(NodePtr<Expression>&& argument, NodePtr<Expression>&& subscript, std::size_t to) noexcept
         : Expression(NodeType::SubscriptAccess, argument->from(), to)
         , m_argument(std::move(argument))
         , m_subscript(std::move(subscript))
     {
     }
     ~SubscriptAccess() = default;
+    const Expression& argument() const noexcept { return *m_argument; }
+    const Expression& subscript() const noexcept { return *m_subscript; }
     void dump(std::ostream& os, std::size_t indent) const override
     {
         ASTNode::printIndent(os, indent);
-        os << "SubscriptAccess" << std::endl;
+        os << "SubscriptAccess" << '\n';
         ASTNode::printIndent(os, indent);
-        os << " Argument" << std::endl;
+        os << " Argument" << '\n';
         m_argument->dump(os, indent + 2);
         ASTNode::printIndent(os, indent);
-        os << " Subscript" << std::endl;
+        os << " Subscript" << '\n';
         m_subscript->dump(os, indent + 2);
     }
 private:
-    std::unique_ptr<Expression> m_argument;
-    std::unique_ptr<Expression> m_subscript;
+    NodePtr<Expression> m_argument;
+    NodePtr<Expression> m_subscript;
 };
 
 #define DECLARE_RIGHT_UNARY_OPERATOR(CLASS_NAME)                                                    \
 class CLASS_NAME final : public UnaryOperator {                                                     \
 public:                                                                                             \
-    CLASS_NAME(std::unique_ptr<Expression>&& argument, std::size_t to) noexcept                      \
+    CLASS_NAME(NodePtr<Expression>&& argument, std::size_t to) noexcept                             \
         : UnaryOperator(NodeType::CLASS_NAME, std::move(argument), argument->from(), to)            \
     {                                                                                               \
     }                                                                                               \
@@ -301,7 +389,7 @@ public:
     void dump(std::ostream& os, std::size_t indent) const override                                  \
     {                                                                                               \
         ASTNode::printIndent(os, indent);                                                           \
-        os << #CLASS_NAME << std::endl;                                                             \
+        os << #CLASS_NAME << '\n';                                                                  \
         m_argument->dump(os, indent + 1);                                                           \
     }                                                                                               \
 };
@@ -312,7 +400,7 @@ DECLARE_RIGHT_UNARY_OPERATOR(PostDecrement)
 #define DECLARE_LEFT_UNARY_OPERATOR(CLASS_NAME)                                                     \
 class CLASS_NAME final : public UnaryOperator {                                                     \
 public:                                                                                             \
-    CLASS_NAME(std::unique_ptr<Expression>&& argument, std::size_t from) noexcept                    \
+    CLASS_NAME(NodePtr<Expression>&& argument, std::size_t from) noexcept                           \
         : UnaryOperator(NodeType::CLASS_NAME, std::move(argument), from, argument->to())            \
     {                                                                                               \
     }                                                                                               \
@@ -320,7 +408,7 @@ public:
     void dump(std::ostream& os, std::size_t indent) const override                                  \
     {                                                                                               \
         ASTNode::printIndent(os, indent);                                                           \
-        os << #CLASS_NAME << std::endl;                                                             \
+        os << #CLASS_NAME << '\n';                                                                  \
         m_argument->dump(os, indent + 1);                                                           \
     }                                                                                               \
 };
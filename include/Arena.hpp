@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+
+namespace frontend {
+
+// Bump allocator. Memory is handed out from large chunks and only returned
+// when the arena is reset or destroyed, so deallocate() is a no-op.
+class Arena final : public std::pmr::memory_resource {
+public:
+    struct Options {
+        // Size of the first chunk, later chunks double up to maxChunkSize.
+        std::size_t chunkSize = 64 * 1024;
+        std::size_t maxChunkSize = 8 * 1024 * 1024;
+        // Back chunks with huge pages when the system allows it.
+        bool hugePages = false;
+    };
+
+    Arena() : Arena(Options{}) {}
+    explicit Arena(Options options) noexcept;
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+    ~Arena();
+
+    // Frees every allocation at once, keeping the last chunk for reuse.
+    void reset() noexcept;
+
+    // Takes over the chunks of other, which is left empty: its allocations stay
+    // valid and are freed with this arena. Both must not be in use meanwhile.
+    void adopt(Arena&& other) noexcept;
+
+    // The bytes handed out, and the bytes of the chunks held, which is what the arena costs.
+    std::size_t allocatedBytes() const noexcept { return m_allocatedBytes; }
+    std::size_t reservedBytes() const noexcept { return m_reservedBytes; }
+
+private:
+    struct Chunk {
+        Chunk* next;
+        std::size_t size;
+        bool mapped;
+    };
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void*, std::size_t, std::size_t) noexcept override {}
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+    void addChunk(std::size_t minimumSize);
+    static void freeChunk(Chunk* chunk) noexcept;
+
+    Options m_options;
+    Chunk* m_chunks;
+    char* m_cursor;
+    char* m_end;
+    std::size_t m_nextChunkSize;
+    std::size_t m_allocatedBytes;
+    std::size_t m_reservedBytes;
+};
+
+} // namespace frontend
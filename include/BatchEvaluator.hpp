@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "ASTNode.hpp"
+#include "Bytecode.hpp"
+#include "FastString.hpp"
+#include "Scanner.hpp"
+
+namespace backend {
+
+struct BatchKernels;
+
+// Evaluates an integer expression over many rows at once: every variable is a
+// column of 64-bit integers, and each instruction of the compiled program runs
+// over a block of rows with vector kernels before the next one starts. The
+// results are those VirtualMachine computes row by row.
+//
+// Variables, integer literals, unary operators, arithmetic, shifts and
+// comparisons are supported. Comparisons and ! give booleans, which select()
+// returns as a bitmap.
+class BatchEvaluator final {
+public:
+    static constexpr std::size_t blockRows = 1024;
+
+    // Throws std::runtime_error for other nodes, and for operands of the wrong kind
+    // like evaluateBinary(). The kernels use isa, SSE2 falls back to scalar code.
+    explicit BatchEvaluator(const frontend::Expression& expression,
+        frontend::scanner::Isa isa = frontend::scanner::detect());
+
+    // The variables, in the order of the columns.
+    const std::vector<frontend::string::FastString>& inputs() const noexcept { return m_program.inputs(); }
+    // Whether the expression gives booleans, for select(), or integers, for evaluate().
+    bool isPredicate() const noexcept { return m_predicate; }
+
+    // Every column holds result.size() rows. A division by zero throws std::domain_error.
+    void evaluate(std::span<const std::span<const std::int64_t>> columns, std::span<std::int64_t> result);
+    // Sets bit i % 64 of word i / 64 when row i satisfies the predicate, and clears
+    // the bits past the last row. Every column holds rows rows.
+    void select(std::span<const std::span<const std::int64_t>> columns, std::size_t rows,
+        std::span<std::uint64_t> selection);
+
+private:
+    friend struct BatchKernels;
+
+    using BinaryKernel = void (*)(std::int64_t*, const std::int64_t*, const std::int64_t*, std::size_t) noexcept;
+    using UnaryKernel = void (*)(std::int64_t*, const std::int64_t*, std::size_t) noexcept;
+
+    enum class Operation : std::uint8_t {
+        Binary,
+        Unary,
+        Divide,
+        Remainder,
+        Fill
+    };
+
+    // result = lhs op rhs over a block, with the kernel of Binary and Unary steps or
+    // the value of Fill steps.
+    struct Step {
+        Operation operation;
+        BinaryKernel binary = nullptr;
+        UnaryKernel unary = nullptr;
+        std::int64_t value = 0;
+        std::uint32_t result = 0;
+        std::uint32_t lhs = 0;
+        std::uint32_t rhs = 0;
+    };
+
+    // Runs the steps over rows, block by block, and passes each result block to output.
+    template <typename Output>
+    void run(std::span<const std::span<const std::int64_t>> columns, std::size_t rows, Output&& output);
+
+    Program m_program;
+    const BatchKernels* m_kernels;
+    std::vector<Step> m_steps;
+    bool m_predicate = false;
+    std::uint32_t m_firstTemporary;
+    std::uint32_t m_result = 0;
+    // blockRows values per register: constants broadcast once, temporaries.
+    std::vector<std::int64_t> m_constants;
+    std::vector<std::int64_t> m_temporaries;
+};
+
+} // namespace backend
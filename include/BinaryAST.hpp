@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "ASTNode.hpp"
+#include "FastString.hpp"
+#include "FlatAST.hpp"
+
+namespace frontend {
+
+// A versioned binary format for parsed trees, to cache them on disk and load them
+// without parsing again. All integers are little-endian:
+//
+//     header   magic "EXPA", version (u16), reserved (u16), tree count, node count,
+//              string count, string bytes (u32 each), node bytes (u64)
+//     strings  string count + 1 offsets (u32) into the string data, then the data
+//     nodes    every tree in preorder, one record per node: type (u8), from as the
+//              zigzag difference to the previous node of the tree, to - from, and
+//              the string index of terminals or the child count of other nodes,
+//              each an unsigned LEB128 varint of at most 32 bits
+//
+// Every distinct string is stored once, whatever the number of nodes using it.
+class BinaryASTWriter final {
+public:
+    // Every tree of trees, which may hold several one after another.
+    void add(const FlatAST& trees);
+    void add(const Expression& tree) { add(FlatAST::fromTree(tree)); }
+
+    std::size_t treeCount() const noexcept { return m_treeCount; }
+
+    // The file of the trees added so far; the writer starts over empty.
+    std::string finish();
+
+private:
+    std::uint32_t stringIndex(string::FastString value);
+
+    std::unordered_map<string::FastString, std::uint32_t> m_strings;
+    std::vector<std::uint32_t> m_stringOffsets{ 0 };
+    std::string m_stringData;
+    std::string m_nodes;
+    std::uint32_t m_treeCount = 0;
+    std::uint32_t m_nodeCount = 0;
+};
+
+// Reads the format of BinaryASTWriter in place, from a buffer that must outlive
+// the reader, such as a MappedFileSource: strings are views of the buffer and
+// nodes are decoded on the fly, with no allocation per node. Untrusted data is
+// validated completely before use, so any corruption throws std::runtime_error
+// from the constructor and the accessors never read out of bounds; trusted data,
+// such as files this process wrote, only has its header checked.
+class BinaryAST final {
+public:
+    enum class Trust { Untrusted, Trusted };
+
+    static constexpr std::uint16_t version = 1;
+
+    // A decoded node. payload is the string index of terminals, else the child count.
+    struct Node {
+        NodeType type;
+        std::uint32_t from;
+        std::uint32_t to;
+        std::uint32_t payload;
+    };
+
+    // Decodes the nodes of every tree in order.
+    class Cursor {
+    public:
+        bool atEnd() const noexcept { return m_remaining == 0; }
+        Node next() noexcept;
+
+    private:
+        friend class BinaryAST;
+
+        Cursor(const unsigned char* position, std::uint32_t nodes) noexcept
+            : m_position(position)
+            , m_remaining(nodes)
+        {
+        }
+
+        const unsigned char* m_position;
+        std::uint32_t m_remaining;
+        // Children still to come for the trees being decoded, 0 between trees.
+        std::uint64_t m_pending = 0;
+        std::uint32_t m_previousFrom = 0;
+    };
+
+    explicit BinaryAST(std::string_view data, Trust trust = Trust::Untrusted);
+
+    std::uint32_t treeCount() const noexcept { return m_treeCount; }
+    std::uint32_t nodeCount() const noexcept { return m_nodeCount; }
+    std::uint32_t stringCount() const noexcept { return m_stringCount; }
+    std::string_view string(std::uint32_t index) const noexcept;
+
+    Cursor nodes() const noexcept { return Cursor(m_nodes, m_nodeCount); }
+
+    // Every tree one after another, with each string interned once; toTree(root)
+    // builds one of them. The columns are allocated once for all the nodes.
+    FlatAST toFlat() const;
+
+private:
+    void validate() const;
+
+    std::uint32_t m_treeCount;
+    std::uint32_t m_nodeCount;
+    std::uint32_t m_stringCount;
+    const unsigned char* m_offsets;
+    const char* m_strings;
+    const unsigned char* m_nodes;
+    const unsigned char* m_nodesEnd;
+};
+
+} // namespace frontend
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "TokenStream.hpp"
+
+namespace frontend {
+
+// Matching '['/']' and '('/')' tokens of a TokenStream, found in one pass over
+// the type column. With it, the top-level commas of a list are found by jumping
+// over nested brackets instead of parsing them.
+class BracketIndex final {
+public:
+    using Index = TokenStream::Index;
+    static constexpr Index none = ~Index(0);
+
+    explicit BracketIndex(const TokenStream& stream);
+
+    // The partner of an opening or closing token, none if it is unbalanced.
+    // Other tokens have no entry: filling one for every token would double the pass.
+    Index match(Index token) const noexcept { return m_matches[token]; }
+
+    // The commas directly inside the matched opening token, in order.
+    std::vector<Index> commas(Index open) const;
+
+private:
+    const TokenStream* m_stream;
+    std::unique_ptr<Index[]> m_matches;
+};
+
+} // namespace frontend
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "ASTNode.hpp"
+#include "FastString.hpp"
+#include "Value.hpp"
+
+namespace backend {
+
+// a, b and c are registers unless noted. Binary operators compute a = b op c,
+// unary ones a = op b.
+enum class Opcode : std::uint8_t {
+    Move,
+    Add,
+    Subtract,
+    Multiply,
+    Divide,
+    Remainder,
+    ShiftLeft,
+    ShiftRight,
+    ShiftRightLogic,
+    Less,
+    LessEquals,
+    Greater,
+    GreaterEquals,
+    Equals,
+    NotEquals,
+    Plus,
+    Negate,
+    Not,
+    BitwiseNot,
+    Increment,
+    Decrement,
+    // a = [b, b + c), c is a count.
+    NewArray,
+    // a = b(b + 1, ..., b + c), c is a count.
+    Call,
+    // a = b[c].
+    GetElement,
+    // a[b] = c.
+    SetElement,
+    // a = b.c, c is a FastString handle.
+    GetMember,
+    // a.c = b, c is a FastString handle.
+    SetMember,
+    Return
+};
+
+struct Instruction {
+    Opcode opcode;
+    std::uint32_t a;
+    std::uint32_t b;
+    std::uint32_t c;
+};
+
+// The bytecode of one expression. Registers start with the constants, then the
+// inputs, the variables of the expression in order of first appearance, then
+// the temporaries. The machine loads the constants once per program.
+class Program final {
+public:
+    std::span<const Instruction> code() const noexcept { return m_code; }
+    const std::vector<Value>& constants() const noexcept { return m_constants; }
+    const std::vector<frontend::string::FastString>& inputs() const noexcept { return m_inputs; }
+    // The register of the first input, after the constants.
+    std::uint32_t firstInput() const noexcept { return static_cast<std::uint32_t>(m_constants.size()); }
+    std::uint32_t registerCount() const noexcept { return m_registerCount; }
+    // The inputs incremented by the expression, the machine writes them back.
+    const std::vector<std::uint32_t>& outputs() const noexcept { return m_outputs; }
+    // Different for every program built in the process.
+    std::uint64_t id() const noexcept { return m_id; }
+
+    std::optional<std::size_t> input(std::string_view name) const;
+
+    void disassemble(std::ostream& os) const;
+
+private:
+    friend class Compiler;
+    Program();
+
+    std::vector<Instruction> m_code;
+    std::vector<Value> m_constants;
+    std::vector<frontend::string::FastString> m_inputs;
+    std::vector<std::uint32_t> m_outputs;
+    std::uint32_t m_registerCount = 0;
+    std::uint64_t m_id;
+};
+
+// Lowers an expression into a Program, without recursion so that any depth compiles.
+// Throws std::range_error for integer literals beyond 64 bits and std::runtime_error
+// for increments of anything but a variable, an element or a member.
+class Compiler final {
+public:
+    static Program compile(const frontend::Expression& expression);
+
+private:
+    Compiler() = default;
+
+    // Assigns the registers of the constants and the inputs.
+    void allocateOperands(const frontend::Expression& root);
+    // Emits the instructions of node, whose operand registers are on top of m_results.
+    void emit(const frontend::Expression& node);
+    void emitIncrement(const frontend::Expression& node);
+
+    std::uint32_t allocate();
+    void release(std::uint32_t reg);
+    std::uint32_t pop();
+    void instruction(Opcode opcode, std::uint32_t a, std::uint32_t b = 0, std::uint32_t c = 0);
+
+    Program m_program;
+    std::unordered_map<std::uint64_t, std::uint32_t> m_integers;
+    std::unordered_map<frontend::string::FastString, std::uint32_t> m_strings;
+    // Input indices, and whether the expression increments the input.
+    std::unordered_map<frontend::string::FastString, std::uint32_t> m_inputs;
+    std::vector<bool> m_incremented;
+    // The registers holding the values of the operands evaluated so far.
+    std::vector<std::uint32_t> m_results;
+    std::uint32_t m_firstTemporary = 0;
+    std::uint32_t m_nextTemporary = 0;
+};
+
+} // namespace backend
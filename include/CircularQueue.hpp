@@ -1,31 +1,40 @@
 #pragma once
 
+#include <bit>
+#include <cassert>
 #include <cstddef>
 #include <utility>
 #include <new>
 #include <stdexcept>
+#include <type_traits>
 
 namespace frontend
 {
 
+// Queues whose ring fits in this many bytes keep it inline, see the specialization below.
+inline constexpr std::size_t circularQueueInlineBytes = 256;
+
+// A bounded FIFO of at most n elements. The ring is rounded up to a power of two,
+// so that wrapping around is a mask. front(), back(), pop(), push() and operator[]
+// are unchecked in release builds and assert in debug builds; at() always checks.
 template <typename T, std::size_t n>
 class CircularQueue
 {
+    static_assert(n > 0, "CircularQueue: capacity must be positive");
+    static constexpr std::size_t ringSize = std::bit_ceil(n);
+    static constexpr std::size_t mask = ringSize - 1;
+
 public:
-    CircularQueue() noexcept
-        : m_buffer(static_cast<T*>(::operator new(n * sizeof(T))))
+    CircularQueue()
+        : m_buffer(allocate())
         , m_front(0)
-        , m_back(n - 1)
         , m_size(0)
     {
     }
 
     // Copy constructor: deep copy by pushing constructed elements.
     CircularQueue(const CircularQueue& other)
-        : m_buffer(static_cast<T*>(::operator new(n * sizeof(T))))
-        , m_front(0)
-        , m_back(n - 1)
-        , m_size(0)
+        : CircularQueue()
     {
         for (std::size_t i = 0; i < other.m_size; ++i) {
             push(other[i]);
@@ -37,10 +46,9 @@ public:
     {
         if (this != &other) {
             clear();
-            // Reset indices to start fresh.
-            m_front = 0;
-            m_back  = n - 1;
-            m_size  = 0;
+            if (m_buffer == nullptr) {
+                m_buffer = allocate();
+            }
             for (std::size_t i = 0; i < other.m_size; ++i) {
                 push(other[i]);
             }
@@ -48,30 +56,23 @@ public:
         return *this;
     }
 
-    // Move constructor.
+    // Move constructor: takes the buffer, the moved-from queue is empty and
+    // allocates a new buffer on its next push.
     CircularQueue(CircularQueue&& other) noexcept
-        : m_buffer(other.m_buffer)
-        , m_front(other.m_front)
-        , m_back(other.m_back)
-        , m_size(other.m_size)
+        : m_buffer(std::exchange(other.m_buffer, nullptr))
+        , m_front(std::exchange(other.m_front, 0))
+        , m_size(std::exchange(other.m_size, 0))
     {
-        other.m_buffer = nullptr;
-        other.m_size = 0;
     }
 
-    // Move assignment operator.
+    // Move assignment operator: swaps the buffers, then empties the moved-from queue.
     CircularQueue& operator=(CircularQueue&& other) noexcept
     {
-        if (this != &other)
-        {
-            clear();
-            ::operator delete(m_buffer);
-            m_buffer = other.m_buffer;
-            m_front = other.m_front;
-            m_back = other.m_back;
-            m_size = other.m_size;
-            other.m_buffer = nullptr;
-            other.m_size = 0;
+        if (this != &other) {
+            std::swap(m_buffer, other.m_buffer);
+            std::swap(m_front, other.m_front);
+            std::swap(m_size, other.m_size);
+            other.clear();
         }
         return *this;
     }
@@ -82,6 +83,11 @@ public:
         ::operator delete(m_buffer);
     }
 
+    static constexpr std::size_t capacity() noexcept
+    {
+        return n;
+    }
+
     std::size_t size() const noexcept
     {
         return m_size;
@@ -97,96 +103,290 @@ public:
         return m_size == n;
     }
 
-    T& front()
+    T& front() noexcept
     {
-        if (m_size == 0) {
-            throw std::underflow_error("CircularQueue: trying to access front in an empty queue");
-        }
+        assert(m_size > 0 && "CircularQueue: trying to access front in an empty queue");
         return m_buffer[m_front];
     }
 
-    const T& front() const
+    const T& front() const noexcept
     {
-        if (m_size == 0) {
-            throw std::underflow_error("CircularQueue: trying to access front in an empty queue");
-        }
+        assert(m_size > 0 && "CircularQueue: trying to access front in an empty queue");
         return m_buffer[m_front];
     }
 
-    T& back()
+    T& back() noexcept
     {
-        if (m_size == 0) {
-            throw std::underflow_error("CircularQueue: trying to access back in an empty queue");
-        }
-        return m_buffer[m_back];
+        assert(m_size > 0 && "CircularQueue: trying to access back in an empty queue");
+        return m_buffer[(m_front + m_size - 1) & mask];
     }
 
-    const T& back() const
+    const T& back() const noexcept
     {
-        if (m_size == 0) {
-            throw std::underflow_error("CircularQueue: trying to access back in an empty queue");
-        }
-        return m_buffer[m_back];
+        assert(m_size > 0 && "CircularQueue: trying to access back in an empty queue");
+        return m_buffer[(m_front + m_size - 1) & mask];
     }
 
     void push(const T& element)
     {
-        if (m_size == n) {
-            throw std::overflow_error("CircularQueue: size limit exceeded");
-        }
-        m_back = (m_back + 1) % n;
-        new (m_buffer + m_back) T(element);
-        ++m_size;
+        emplace(element);
     }
 
     void push(T&& element)
     {
-        if (m_size == n) {
-            throw std::overflow_error("CircularQueue: size limit exceeded");
+        emplace(std::move(element));
+    }
+
+    template <typename... Args>
+    T& emplace(Args&&... args)
+    {
+        assert(m_size < n && "CircularQueue: size limit exceeded");
+        if (m_buffer == nullptr) [[unlikely]] {
+            m_buffer = allocate();
         }
-        m_back = (m_back + 1) % n;
-        new (m_buffer + m_back) T(std::move(element));
+        T* slot = new (m_buffer + ((m_front + m_size) & mask)) T(std::forward<Args>(args)...);
         ++m_size;
+        return *slot;
     }
 
-    void pop()
+    void pop() noexcept
     {
-        if (m_size == 0) {
-            throw std::underflow_error("CircularQueue: trying to pop from an empty queue");
-        }
+        assert(m_size > 0 && "CircularQueue: trying to pop from an empty queue");
         m_buffer[m_front].~T();
-        m_front = (m_front + 1) % n;
+        m_front = (m_front + 1) & mask;
         --m_size;
     }
 
-    T& operator[](std::size_t index)
+    T& operator[](std::size_t index) noexcept
+    {
+        assert(index < m_size && "CircularQueue: index out of bounds");
+        return m_buffer[(m_front + index) & mask];
+    }
+
+    const T& operator[](std::size_t index) const noexcept
+    {
+        assert(index < m_size && "CircularQueue: index out of bounds");
+        return m_buffer[(m_front + index) & mask];
+    }
+
+    T& at(std::size_t index)
     {
         if (index >= m_size) {
             throw std::out_of_range("CircularQueue: index out of bounds");
         }
-        return m_buffer[(m_front + index) % n];
+        return (*this)[index];
     }
 
-    const T& operator[](std::size_t index) const
+    const T& at(std::size_t index) const
     {
         if (index >= m_size) {
             throw std::out_of_range("CircularQueue: index out of bounds");
         }
-        return m_buffer[(m_front + index) % n];
+        return (*this)[index];
     }
 
-private:
     void clear() noexcept
     {
         while (m_size > 0) {
             pop();
         }
+        m_front = 0;
+    }
+
+private:
+    static T* allocate()
+    {
+        return static_cast<T*>(::operator new(ringSize * sizeof(T)));
     }
 
     T* m_buffer;
     std::size_t m_front;
-    std::size_t m_back;
     std::size_t m_size;
 };
 
-} // namespace frontend
\ No newline at end of file
+// Small queues, such as the lexer lookahead window, keep their ring inside the object:
+// no allocation, and no pointer to load before reaching an element.
+template <typename T, std::size_t n>
+    requires (n > 0 && std::bit_ceil(n) * sizeof(T) <= circularQueueInlineBytes)
+class CircularQueue<T, n>
+{
+    static constexpr std::size_t ringSize = std::bit_ceil(n);
+    static constexpr std::size_t mask = ringSize - 1;
+
+public:
+    CircularQueue() noexcept
+        : m_front(0)
+        , m_size(0)
+    {
+    }
+
+    CircularQueue(const CircularQueue& other)
+        : CircularQueue()
+    {
+        for (std::size_t i = 0; i < other.m_size; ++i) {
+            push(other[i]);
+        }
+    }
+
+    CircularQueue& operator=(const CircularQueue& other)
+    {
+        if (this != &other) {
+            clear();
+            for (std::size_t i = 0; i < other.m_size; ++i) {
+                push(other[i]);
+            }
+        }
+        return *this;
+    }
+
+    // Moves the elements one by one, the moved-from queue is left empty.
+    CircularQueue(CircularQueue&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+        : CircularQueue()
+    {
+        for (std::size_t i = 0; i < other.m_size; ++i) {
+            push(std::move(other[i]));
+        }
+        other.clear();
+    }
+
+    CircularQueue& operator=(CircularQueue&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+    {
+        if (this != &other) {
+            clear();
+            for (std::size_t i = 0; i < other.m_size; ++i) {
+                push(std::move(other[i]));
+            }
+            other.clear();
+        }
+        return *this;
+    }
+
+    ~CircularQueue()
+    {
+        clear();
+    }
+
+    static constexpr std::size_t capacity() noexcept
+    {
+        return n;
+    }
+
+    std::size_t size() const noexcept
+    {
+        return m_size;
+    }
+
+    bool empty() const noexcept
+    {
+        return m_size == 0;
+    }
+
+    bool full() const noexcept
+    {
+        return m_size == n;
+    }
+
+    T& front() noexcept
+    {
+        assert(m_size > 0 && "CircularQueue: trying to access front in an empty queue");
+        return slot(m_front);
+    }
+
+    const T& front() const noexcept
+    {
+        assert(m_size > 0 && "CircularQueue: trying to access front in an empty queue");
+        return slot(m_front);
+    }
+
+    T& back() noexcept
+    {
+        assert(m_size > 0 && "CircularQueue: trying to access back in an empty queue");
+        return slot((m_front + m_size - 1) & mask);
+    }
+
+    const T& back() const noexcept
+    {
+        assert(m_size > 0 && "CircularQueue: trying to access back in an empty queue");
+        return slot((m_front + m_size - 1) & mask);
+    }
+
+    void push(const T& element)
+    {
+        emplace(element);
+    }
+
+    void push(T&& element)
+    {
+        emplace(std::move(element));
+    }
+
+    template <typename... Args>
+    T& emplace(Args&&... args)
+    {
+        assert(m_size < n && "CircularQueue: size limit exceeded");
+        T* element = new (m_storage + ((m_front + m_size) & mask) * sizeof(T)) T(std::forward<Args>(args)...);
+        ++m_size;
+        return *element;
+    }
+
+    void pop() noexcept
+    {
+        assert(m_size > 0 && "CircularQueue: trying to pop from an empty queue");
+        slot(m_front).~T();
+        m_front = (m_front + 1) & mask;
+        --m_size;
+    }
+
+    T& operator[](std::size_t index) noexcept
+    {
+        assert(index < m_size && "CircularQueue: index out of bounds");
+        return slot((m_front + index) & mask);
+    }
+
+    const T& operator[](std::size_t index) const noexcept
+    {
+        assert(index < m_size && "CircularQueue: index out of bounds");
+        return slot((m_front + index) & mask);
+    }
+
+    T& at(std::size_t index)
+    {
+        if (index >= m_size) {
+            throw std::out_of_range("CircularQueue: index out of bounds");
+        }
+        return (*this)[index];
+    }
+
+    const T& at(std::size_t index) const
+    {
+        if (index >= m_size) {
+            throw std::out_of_range("CircularQueue: index out of bounds");
+        }
+        return (*this)[index];
+    }
+
+    void clear() noexcept
+    {
+        while (m_size > 0) {
+            pop();
+        }
+        m_front = 0;
+    }
+
+private:
+    T& slot(std::size_t index) noexcept
+    {
+        return *std::launder(reinterpret_cast<T*>(m_storage + index * sizeof(T)));
+    }
+
+    const T& slot(std::size_t index) const noexcept
+    {
+        return *std::launder(reinterpret_cast<const T*>(m_storage + index * sizeof(T)));
+    }
+
+    alignas(T) unsigned char m_storage[ringSize * sizeof(T)];
+    std::size_t m_front;
+    std::size_t m_size;
+};
+
+} // namespace frontend
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ASTNode.hpp"
+#include "NodeFactory.hpp"
+#include "Visitor.hpp"
+
+namespace frontend {
+
+// Replaces operators whose operands are all constants by a single constant.
+//
+// Numbers are 64-bit signed integers. +, -, * and unary - fold when the result
+// fits; / and % truncate toward zero like C++; ~ is the bitwise complement.
+// Shift counts must be in [0, 63]: << must not lose bits, >> is arithmetic and
+// >>> shifts the two's complement bits in zeros, its result must fit. Literals
+// have no sign, so a negative result is a Negative over the literal of its
+// magnitude, which later passes read like any source, and folds further like a
+// literal. String literals only fold under +, into their concatenation.
+// Comparisons and ! give booleans, which have no literal, so they are kept with
+// their folded operands.
+//
+// Division by zero, overflow, out of range shift counts and literals beyond 64
+// bits keep the subtree as it is and are reported as diagnostics.
+class ConstantFolder final : public Rewriter<ConstantFolder> {
+public:
+    struct Diagnostic {
+        std::size_t from;
+        std::size_t to;
+        std::string message;
+    };
+
+    // Literals are made by factory: the heap for heap trees, the arena of arena trees.
+    explicit ConstantFolder(NodeFactory factory = {}) noexcept : m_factory(factory) {}
+
+    // Folds the tree in place, bottom-up without recursion (see Rewriter). Returns the
+    // number of nodes removed.
+    std::size_t fold(NodePtr<Expression>& tree);
+
+    const std::vector<Diagnostic>& diagnostics() const noexcept { return m_diagnostics; }
+
+private:
+    friend class Rewriter<ConstantFolder>;
+    // Only through fold(), which checks the factory.
+    using Rewriter<ConstantFolder>::rewrite;
+
+    // The handlers of Rewriter: the constant replacing node, whose operands are
+    // already folded, or nullptr.
+    NodePtr<Expression> rewritePositive(Positive& node) { return foldUnary(node); }
+    NodePtr<Expression> rewriteNegative(Negative& node) { return foldUnary(node); }
+    NodePtr<Expression> rewriteBitwiseNot(BitwiseNot& node) { return foldUnary(node); }
+    NodePtr<Expression> rewriteBinaryOperator(BinaryOperator& node);
+
+    NodePtr<Expression> foldUnary(const UnaryOperator& node);
+    NodePtr<Expression> foldBinary(const Expression& node, std::int64_t lhs, std::int64_t rhs);
+    // Constants are numeric literals and negated numeric literals.
+    static bool isConstant(const Expression& node) noexcept;
+    static std::size_t constantSize(const Expression& node) noexcept;
+    std::optional<std::int64_t> constant(const Expression& node);
+    NodePtr<Expression> makeConstant(const Expression& node, std::int64_t value);
+    NodePtr<Expression> diagnose(const Expression& node, std::string_view message);
+    // Counts the nodes removed by replacing node, and its constant operands, with constant.
+    NodePtr<Expression> replace(const Expression& node, NodePtr<Expression> constant);
+
+    NodeFactory m_factory;
+    std::vector<Diagnostic> m_diagnostics;
+    std::size_t m_removed = 0;
+};
+
+} // namespace frontend
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ASTNode.hpp"
+
+namespace frontend {
+
+// A growable byte buffer for the emitters. Without a sink it keeps everything
+// written, in view(); with one it hands the bytes over in blocks of blockSize
+// or more, so that writing to a file costs one call per block, not per line.
+class OutputBuffer final {
+public:
+    using Sink = std::function<void(std::string_view)>;
+
+    OutputBuffer() = default;
+    explicit OutputBuffer(Sink sink, std::size_t blockSize = 64 * 1024);
+    // Writes the blocks to file with fwrite(), throwing std::runtime_error if it fails.
+    explicit OutputBuffer(std::FILE* file, std::size_t blockSize = 64 * 1024);
+    OutputBuffer(const OutputBuffer&) = delete;
+    OutputBuffer& operator=(const OutputBuffer&) = delete;
+    // Flushes what is left; errors are lost then, call flush() to see them.
+    ~OutputBuffer();
+
+    void put(char c)
+    {
+        m_buffer.push_back(c);
+        flushIfFull();
+    }
+    void append(std::string_view text)
+    {
+        m_buffer.append(text);
+        flushIfFull();
+    }
+    // count spaces at once.
+    void indent(std::size_t count)
+    {
+        m_buffer.append(count, ' ');
+        flushIfFull();
+    }
+    void appendNumber(std::size_t value);
+
+    // Hands everything to the sink; without a sink it does nothing.
+    void flush();
+    // What was written and not flushed yet.
+    std::string_view view() const noexcept { return m_buffer; }
+    void clear() noexcept { m_buffer.clear(); }
+
+private:
+    void flushIfFull()
+    {
+        if (m_sink && m_buffer.size() >= m_blockSize) flush();
+    }
+
+    Sink m_sink;
+    std::size_t m_blockSize = 0;
+    std::string m_buffer;
+};
+
+// Writes trees as S-expressions or JSON, one tree per line, or one node per line
+// with Options::indent spaces per level. Nodes are named like their NodeType:
+//
+//     a.b + f(1, "s")  (Addition (MemberAccess a b) (FunctionCall f 1 "s"))
+//     a                {"type":"Identifier","from":0,"to":1,"value":"a"}
+//
+// and JSON nodes with children list them in "children", in source order.
+// Strings are quoted and escaped. Trees of any depth are safe to emit.
+class Emitter final {
+public:
+    enum class Format { SExpression, Json };
+
+    struct Options {
+        Format format = Format::SExpression;
+        // Spaces per level, 0 for a single line.
+        std::size_t indent = 0;
+    };
+
+    explicit Emitter(OutputBuffer& out) : Emitter(out, Options{}) {}
+    Emitter(OutputBuffer& out, Options options) : m_out(out), m_options(options) {}
+
+    void emit(const Expression& tree);
+
+private:
+    struct Pending {
+        const Expression* node;
+        std::size_t depth;
+        bool close;
+        bool first;
+    };
+
+    void separate(std::size_t depth, bool first);
+    // Returns whether the node needs closing after its children, false for terminals.
+    bool open(const Expression& node);
+    void close();
+    void quote(std::string_view text);
+
+    OutputBuffer& m_out;
+    Options m_options;
+    std::vector<Pending> m_pending;
+    std::vector<const Expression*> m_children;
+};
+
+} // namespace frontend
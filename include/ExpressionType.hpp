@@ -1,7 +1,10 @@
 #pragma once
 
-#include <memory>
-#include <utility>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
 
 namespace frontend {
 
@@ -75,45 +78,56 @@ enum class BasicExpressionType {
     Array
 };
 
-class ExpressionType {
+// A type of an expression. Types are interned: every distinct type, arrays
+// nested to any depth included, has one immutable instance that lives for the
+// whole process, so equality compares addresses and hashing is O(1). Each type
+// links to its array type, and getting a type that exists does not lock.
+class ExpressionType final {
 public:
-    ExpressionType(BasicExpressionType type) : m_type(type) {}
-    ~ExpressionType() = default;
-    virtual bool operator==(const ExpressionType& other) const
+    // Any type but Array, which throws std::logic_error.
+    static const ExpressionType& basic(BasicExpressionType type);
+    static const ExpressionType& arrayOf(const ExpressionType& elementType)
     {
-        return m_type == other.m_type;
+        const ExpressionType* array = elementType.m_arrayType.load(std::memory_order_acquire);
+        return array ? *array : createArrayOf(elementType);
     }
-    virtual bool operator!=(const ExpressionType& other) const
-    {
-        return m_type != other.m_type;
-    }
-    inline BasicExpressionType basicExpressionType() const { return m_type; }
-protected:
-    BasicExpressionType m_type;
+    // Arrays of type, depth times.
+    static const ExpressionType& arrayOf(const ExpressionType& elementType, std::uint32_t depth);
+    // The array types created so far; the basic types always exist.
+    static std::size_t arrayTypeCount() noexcept;
+
+    ExpressionType(const ExpressionType&) = delete;
+    ExpressionType& operator=(const ExpressionType&) = delete;
+
+    BasicExpressionType basicExpressionType() const noexcept { return m_type; }
+    bool isArray() const noexcept { return m_type == BasicExpressionType::Array; }
+    // Of arrays, nullptr for the basic types.
+    const ExpressionType* elementType() const noexcept { return m_elementType; }
+    // How many arrays are nested, 0 for the basic types.
+    std::uint32_t depth() const noexcept { return m_depth; }
+    // Like "int32[][]".
+    std::string toString() const;
+
+    friend bool operator==(const ExpressionType& lhs, const ExpressionType& rhs) noexcept { return &lhs == &rhs; }
+
+private:
+    ExpressionType(BasicExpressionType type, const ExpressionType* elementType) noexcept;
+
+    static const ExpressionType& createArrayOf(const ExpressionType& elementType);
+
+    const BasicExpressionType m_type;
+    const std::uint32_t m_depth;
+    const ExpressionType* const m_elementType;
+    // Created on first use, only one thread wins.
+    mutable std::atomic<const ExpressionType*> m_arrayType;
 };
 
-class ArrayType final : public ExpressionType {
-public:
-    ArrayType(std::unique_ptr<ExpressionType>&& elementType)
-        : ExpressionType(BasicExpressionType::Array)
-        , m_elementType(std::move(elementType))
-    {
-    }
-    ~ArrayType() = default;
-    bool operator==(const ExpressionType& other) const override
-    {
-        if (this->basicExpressionType() != other.basicExpressionType()) return false;
-        auto& otherArray = static_cast<const ArrayType&>(other);
-        return *m_elementType == *otherArray.m_elementType;
-    }
-    bool operator!=(const ExpressionType& other) const override
+} // namespace frontend
+
+template <>
+struct std::hash<frontend::ExpressionType> {
+    std::size_t operator()(const frontend::ExpressionType& type) const noexcept
     {
-        if (this->basicExpressionType() != other.basicExpressionType()) return true;
-        auto& otherArray = static_cast<const ArrayType&>(other);
-        return *m_elementType != *otherArray.m_elementType;
+        return std::hash<const frontend::ExpressionType*>{}(&type);
     }
-private:
-    std::unique_ptr<ExpressionType> m_elementType;
 };
-
-}
\ No newline at end of file
@@ -1,25 +1,38 @@
 #pragma once
 
+#include <cstddef>
+#include <functional>
 #include <string>
+#include <string_view>
 
-// Temporary implementation for testing until a string repositiory is built.
+#include "StringRepository.hpp"
 
 namespace frontend::string {
 
+// Handle to a string interned in the StringRepository.
+// Copying, equality and hashing are O(1); ordering compares the contents.
 class FastString {
 public:
-    inline FastString() = default;
-    inline FastString(std::string&& data) : m_data(std::move(data)) {}
-    inline FastString(const std::string& data) : m_data(data) {}
-    inline FastString(const FastString& other) : m_data(other.m_data) {}
-    inline bool operator<(const FastString& other) const noexcept { return m_data < other.m_data; }
-    inline bool operator>(const FastString& other) const noexcept { return m_data > other.m_data; }
-    inline bool operator==(const FastString& other) const noexcept { return m_data == other.m_data; }
-    inline bool operator!=(const FastString& other) const noexcept { return m_data != other.m_data; }
-    inline FastString& operator=(const FastString& other) { m_data = other.m_data; return *this; }
-    inline const std::string& str() const noexcept { return m_data; }
+    inline FastString() noexcept : m_handle(0) {}
+    inline FastString(std::string_view data) : m_handle(StringRepository::instance().intern(data)) {}
+    inline FastString(const std::string& data) : FastString(std::string_view(data)) {}
+    inline FastString(const char* data) : FastString(std::string_view(data)) {}
+    inline FastString(const FastString& other) noexcept = default;
+    static inline FastString fromHandle(StringRepository::Handle handle) noexcept { FastString string; string.m_handle = handle; return string; }
+    inline bool operator<(const FastString& other) const noexcept { return str() < other.str(); }
+    inline bool operator>(const FastString& other) const noexcept { return str() > other.str(); }
+    inline bool operator==(const FastString& other) const noexcept { return m_handle == other.m_handle; }
+    inline bool operator!=(const FastString& other) const noexcept { return m_handle != other.m_handle; }
+    inline FastString& operator=(const FastString& other) noexcept = default;
+    inline const std::string& str() const noexcept { return StringRepository::instance().get(m_handle); }
+    inline StringRepository::Handle handle() const noexcept { return m_handle; }
 private:
-    std::string m_data;
+    StringRepository::Handle m_handle;
 };
 
-} // namespace frontend::string
\ No newline at end of file
+} // namespace frontend::string
+
+template <>
+struct std::hash<frontend::string::FastString> {
+    std::size_t operator()(const frontend::string::FastString& string) const noexcept { return string.handle(); }
+};
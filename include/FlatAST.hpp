@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "ASTNode.hpp"
+#include "FastString.hpp"
+#include "NodeFactory.hpp"
+
+namespace frontend {
+
+// Struct-of-arrays representation of an expression tree, one column per field.
+// Nodes are stored in depth-first preorder: the first child of a node directly
+// follows it, and every other child starts where its previous sibling ends.
+// Children are in the same order as in the class tree (MemberAccess: argument,
+// identifier; FunctionCall: function, arguments; SubscriptAccess: argument, subscript).
+class FlatAST final {
+public:
+    using Index = std::uint32_t;
+
+    FlatAST() = default;
+
+    static FlatAST fromTree(const Expression& root);
+    NodePtr<Expression> toTree(NodeFactory factory = NodeFactory()) const { return toTree(0, factory); }
+    // The subtree of root; a FlatAST may hold several trees one after another, like BinaryAST loads them.
+    NodePtr<Expression> toTree(Index root, NodeFactory factory = NodeFactory()) const;
+
+    std::size_t size() const noexcept { return m_types.size(); }
+    NodeType type(Index node) const noexcept { return m_types[node]; }
+    std::uint32_t from(Index node) const noexcept { return m_from[node]; }
+    std::uint32_t to(Index node) const noexcept { return m_to[node]; }
+    // One past the last node of the subtree, i.e. the next sibling if there is one.
+    Index end(Index node) const noexcept { return m_ends[node]; }
+    Index firstChild(Index node) const noexcept { return node + 1; }
+    // Only meaningful for nodes with children.
+    std::uint32_t childCount(Index node) const noexcept { return m_payloads[node]; }
+    // Only meaningful for Identifier, NumericLiteral and StringLiteral.
+    string::FastString value(Index node) const noexcept { return string::FastString::fromHandle(m_payloads[node]); }
+
+    std::span<const NodeType> types() const noexcept { return m_types; }
+    std::span<const std::uint32_t> froms() const noexcept { return m_from; }
+    std::span<const std::uint32_t> tos() const noexcept { return m_to; }
+    std::span<const Index> ends() const noexcept { return m_ends; }
+    // String handles for terminals, child counts for every other node.
+    std::span<const std::uint32_t> payloads() const noexcept { return m_payloads; }
+
+    std::size_t memoryUsage() const noexcept;
+
+    // Same nodes with the same offsets and values, column by column.
+    bool operator==(const FlatAST&) const = default;
+
+private:
+    friend class BinaryAST;
+
+    Index append(NodeType type, std::size_t from, std::size_t to, std::uint32_t payload);
+
+    std::vector<NodeType> m_types;
+    std::vector<std::uint32_t> m_from;
+    std::vector<std::uint32_t> m_to;
+    std::vector<Index> m_ends;
+    std::vector<std::uint32_t> m_payloads;
+};
+
+} // namespace frontend
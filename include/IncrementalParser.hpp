@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "ASTNode.hpp"
+#include "TokenStream.hpp"
+
+namespace frontend {
+
+// The work done for an edit.
+struct Reparsed {
+    std::size_t relexedTokens;
+    std::size_t reparsedTokens;
+};
+
+// Keeps the tree of a text up to date with its edits, without lexing and parsing it
+// all again: only the tokens around an edit are lexed again, and only the innermost
+// list element or subscript holding them is parsed again, every other subtree is kept.
+// An edit costs its size and the depth of the tree, not the size of the text:
+//   - the tokens are kept in a TokenGapBuffer;
+//   - the subtrees following an edit are not moved one by one: each node on the way
+//     to the edit records that its children from some index on are off by the change
+//     of length, and tree() moves them all before handing out the tree.
+class IncrementalParser final {
+public:
+    // Parses text on the heap. The text must outlive the parser, or the next reparse().
+    explicit IncrementalParser(std::string_view text);
+
+    // Applies edits, sorted disjoint ranges of the current text, text being the new one,
+    // under the same lifetime rule. When the new text has an error, the tree and the
+    // tokens are left untouched and the error is thrown.
+    Reparsed reparse(std::string_view text, std::span<const TextEdit> edits);
+
+    // The tree of the current text, its offsets brought up to date first.
+    const Expression& tree();
+    const TokenGapBuffer& tokens() const noexcept { return m_tokens; }
+
+private:
+    // The children of a node from first on, and everything below them, are off by delta.
+    struct Shift {
+        std::size_t first;
+        std::ptrdiff_t delta;
+    };
+
+    std::ptrdiff_t pendingShift(const ASTNode& node, std::size_t child) const noexcept;
+    void addShift(const ASTNode& node, std::size_t first, std::ptrdiff_t delta);
+    void moveAfter(std::size_t boundary, std::ptrdiff_t delta, const ASTNode* replaced);
+
+    TokenGapBuffer m_tokens;
+    NodePtr<Expression> m_tree;
+    std::unordered_map<const ASTNode*, std::vector<Shift>> m_shifts;
+};
+
+} // namespace frontend
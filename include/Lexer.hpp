@@ -1,23 +1,31 @@
 #pragma once
 
-#include <fstream>
+#include <array>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
+#include <limits>
 #include <stdexcept>
 #include <string>
-#include <cctype>
+#include <string_view>
 #include <utility>
 
 #include "CircularQueue.hpp"
+#include "LexerTables.hpp"
+#include "Scanner.hpp"
+#include "Source.hpp"
 #include "Token.hpp"
 
 namespace frontend {
 
-template <std::size_t numberOfLookaheads>
+// The Source policy provides the characters, see Source.hpp.
+template <std::size_t numberOfLookaheads, typename Source = StreamSource>
 class Lexer final {
 public:
-    Lexer(std::ifstream&& file)
-        : m_file(std::move(file))
+    Lexer(Source&& source)
+        : m_source(std::move(source))
         , m_index(0)
+        , m_columns(nullptr)
     {
         for (std::size_t i = 0; i < numberOfLookaheads; ++i) {
             addNextToken();
@@ -35,57 +43,123 @@ public:
 
     void skip() { m_tokens.pop(); addNextToken(); }
 
+    // Batch mode: lexes the whole source into columns in a single pass,
+    // without going through the lookahead queue. See TokenStream.
+    static void tokenize(Source&& source, TokenColumns& columns)
+    {
+        Lexer lexer(std::move(source), columns);
+        do {
+            lexer.addNextToken();
+        } while (columns.types.back() != TokenType::EndOfFile);
+    }
+
+    // Punctuators use their fixed spelling and string literals exclude the quotes.
+    // Views into contiguous sources live as long as the buffer, otherwise
+    // they are valid while the token is in the lookahead window.
+    std::string_view lexeme(const Token& token) const
+    {
+        switch (token.type) {
+            case TokenType::EndOfFile:
+                return {};
+            case TokenType::Identifier:
+            case TokenType::NumericLiteral:
+                return text(token.from, token.to);
+            case TokenType::StringLiteral:
+                return text(token.from + 1, token.to - 1);
+            default:
+                return tokenSpelling(token.type);
+        }
+    }
+
 private:
-    char peekChar() { return m_file.peek(); }
+    Lexer(Source&& source, TokenColumns& columns)
+        : m_source(std::move(source))
+        , m_index(0)
+        , m_columns(&columns)
+    {
+    }
 
-    void skipChar() { ++m_index; m_file.ignore(); }
+    char peekChar() { return m_source.peek(); }
+
+    void skipChar() { ++m_index; m_source.skip(); }
+
+    // Moves a contiguous source to a position found by a scanning kernel.
+    void skipTo(const char* position)
+    {
+        m_index += position - m_source.cursor();
+        m_source.seek(position);
+    }
 
     // Returns true if a slash has been found.
     bool skipWhitespace()
     {
-        // Skips all whitespace.
-        while (isspace(peekChar())) skipChar();
-        // Skip comments.
-        // Check potential comment.
-        if (peekChar() == '/') {
+        m_triviaFrom = m_index;
+        m_startsLine = false;
+        while (true) {
+            // Skips all whitespace.
+            if constexpr (Source::contiguous) {
+                skipTo(scanner::skipWhitespace(m_source.cursor(), m_source.end()));
+            } else {
+                while (lexerTables.isWhitespace(peekChar())) {
+                    m_startsLine |= peekChar() == '\n';
+                    skipChar();
+                }
+            }
+            // Check potential comment.
+            if (peekChar() != '/') {
+                return false;
+            }
             // Skip to make lookahead.
             skipChar();
             if (peekChar() == '/') {
                 // Ignore '/' and the next characters untill
                 // end-of-line or end-of-file.
-                do {
-                    skipChar();
-                } while (peekChar() != '\n' && peekChar() != EOF);
-                // Skip the following whitespaces recursively.
-                skipWhitespace();
+                skipChar();
+                skipLineComment();
             } else if (peekChar() == '*') {
                 // Ingore star.
                 skipChar();
-                bool terminated = false;
-                while (peekChar() != EOF) {
-                    if (peekChar() == '*') {
-                        skipChar();
-                        if (peekChar() == '/') {
-                            skipChar();
-                            terminated = true;
-                            break;
-                        }
-                    } else {
-                        skipChar();
-                    }
-                }
-                if (!terminated) {
-                    throw std::range_error("Unterminated multiline comment.");
-                }
-                // Skip the following whitespaces recursively.
-                skipWhitespace();
+                skipBlockComment();
             } else {
                 // It was not a comment, it is a slash.
-                m_tokens.push({ string::FastString("/"), TokenType::Slash, m_index - 1, m_index });
+                pushToken(TokenType::Slash, m_index - 1);
                 return true;
             }
         }
-        return false;
+    }
+
+    void skipLineComment()
+    {
+        if constexpr (Source::contiguous) {
+            skipTo(scanner::findLineEnd(m_source.cursor(), m_source.end()));
+        } else {
+            while (peekChar() != '\n' && peekChar() != EOF) skipChar();
+        }
+    }
+
+    void skipBlockComment()
+    {
+        if constexpr (Source::contiguous) {
+            const char* end = scanner::findBlockCommentEnd(m_source.cursor(), m_source.end());
+            if (!end) {
+                throw std::range_error("Unterminated multiline comment.");
+            }
+            skipTo(end);
+        } else {
+            while (peekChar() != EOF) {
+                if (peekChar() == '*') {
+                    skipChar();
+                    if (peekChar() == '/') {
+                        skipChar();
+                        return;
+                    }
+                } else {
+                    m_startsLine |= peekChar() == '\n';
+                    skipChar();
+                }
+            }
+            throw std::range_error("Unterminated multiline comment.");
+        }
     }
         
     void addNextToken()
@@ -94,237 +168,195 @@ private:
         if (skipWhitespace()) return;
         std::size_t from = m_index;
         if (peekChar() == EOF) {
-            m_tokens.push({ string::FastString(""), TokenType::EndOfFile, from, m_index });
+            pushToken(TokenType::EndOfFile, from);
             return;
         }
-        switch (peekChar()) {
-            case '[': {
-                skipChar();
-                m_tokens.push({ string::FastString("["), TokenType::OpenBracket, from, m_index });
-                break;
-            }
-            case ']': {
-                skipChar();
-                m_tokens.push({ string::FastString("]"), TokenType::CloseBracket, from, m_index });
-                break;
-            }
-            case '(': {
-                skipChar();
-                m_tokens.push({ string::FastString("("), TokenType::OpenParenthesis, from, m_index });
-                break;
+        switch (lexerTables.classOf(peekChar())) {
+            case LexerTables::Digit: {
+                getNumericLiteral();
+                pushToken(TokenType::NumericLiteral, from);
+                return;
             }
-            case ')': {
-                skipChar();
-                m_tokens.push({ string::FastString(")"), TokenType::CloseParenthesis, from, m_index });
-                break;
+            case LexerTables::Letter:
+            case LexerTables::HexLetter: {
+                // TODO: check for keyword.
+                getIdentifier();
+                pushToken(TokenType::Identifier, from);
+                return;
             }
-            case '.': {
-                skipChar();
-                m_tokens.push({ string::FastString("."), TokenType::Dot, from, m_index });
-                break;
+            case LexerTables::Quote: {
+                getStringLiteral();
+                pushToken(TokenType::StringLiteral, from);
+                return;
             }
-            case ',': {
-                skipChar();
-                m_tokens.push({ string::FastString(","), TokenType::Comma, from, m_index });
+            case LexerTables::Whitespace:
+            case LexerTables::Other:
+                throw std::logic_error("Unrecognized token.");
+            default:
                 break;
-            }
-            case '+': {
-                skipChar();
-                if (peekChar() == '+') {
-                    skipChar();
-                    m_tokens.push({ string::FastString("++"), TokenType::Increment, from, m_index });
-                } else {
-                    m_tokens.push({ string::FastString("+"), TokenType::Plus, from, m_index });
-                }
-                break;
-            }
-            case '-': {
-                skipChar();
-                if (peekChar() == '-') {
-                    skipChar();
-                    m_tokens.push({ string::FastString("--"), TokenType::Decrement, from, m_index });
-                } else {
-                    m_tokens.push({ string::FastString("-"), TokenType::Minus, from, m_index });
-                }
-                break;
-            }
-            case '*': {
-                skipChar();
-                m_tokens.push({ string::FastString("*"), TokenType::Star, from, m_index });
-                break;
-            }
-            case '/': {
-                skipChar();
-                m_tokens.push({ string::FastString("/"), TokenType::Slash, from, m_index });
-                break;
-            }
-            case '%': {
-                skipChar();
-                m_tokens.push({ string::FastString("%"), TokenType::Percent, from, m_index });
-                break;
-            }
-            case '!': {
-                skipChar();
-                if (peekChar() == '=') {
-                    skipChar();
-                    m_tokens.push({ string::FastString("!="), TokenType::ExclamationEquals, from, m_index });
-                } else {
-                    m_tokens.push({ string::FastString("!"), TokenType::Exclamation, from, m_index });
-                }
-                break;
-            }
-            case '~': {
-                skipChar();
-                m_tokens.push({ string::FastString("~"), TokenType::Tilde, from, m_index });
-                break;
-            }
-            case '<': {
-                skipChar();
-                if (peekChar() == '<') {
-                    skipChar();
-                    m_tokens.push({ string::FastString("<<"), TokenType::DoubleLessThan, from, m_index });
-                } else if (peekChar() == '=') {
-                    skipChar();
-                    m_tokens.push({ string::FastString("<="), TokenType::LessEquals, from, m_index });
-                } else {
-                    m_tokens.push({ string::FastString("<"), TokenType::LessThan, from, m_index });
-                }
-                break;
-            }
-            case '>': {
-                skipChar();
-                if (peekChar() == '>') {
-                    skipChar();
-                    if (peekChar() == '>') {
-                        skipChar();
-                        m_tokens.push({ string::FastString(">>>"), TokenType::TripleGreaterThan, from, m_index });
-                    } else {
-                        m_tokens.push({ string::FastString(">>"), TokenType::DoubleGreaterThan, from, m_index });
-                    }
-                } else if (peekChar() == '=') {
-                    skipChar();
-                    m_tokens.push({ string::FastString(">="), TokenType::GreaterEquals, from, m_index });
-                } else {
-                    m_tokens.push({ string::FastString(">"), TokenType::GreaterThan, from, m_index });
-                }
-                break;
-            }
-            case '=': {
-                skipChar();
-                if (peekChar() == '=') {
-                    skipChar();
-                    m_tokens.push({ string::FastString("=="), TokenType::DoubleEquals, from, m_index });
-                } else {
-                    m_tokens.push({ string::FastString("="), TokenType::Equals, from, m_index });
-                }
-                break;
-            }
-            case '"': {
-                m_tokens.push({ getStringLiteral(), TokenType::StringLiteral, from, m_index });
-                break;
-            }
-            default: {
-                if (isdigit(peekChar())) {
-                    m_tokens.push({ getNumericLiteral(), TokenType::NumericLiteral, from, m_index });
-                } else if (isalpha(peekChar()) || peekChar() == '_') {
-                    // TODO: check for keyword.
-                    m_tokens.push({ getIdentifier(), TokenType::Identifier, from, m_index });
-                } else {
-                    throw std::logic_error("Unrecognized token.");
-                }
-                break;
-            }
         }
+        // Punctuators: follow the DFA for the longest match.
+        std::uint8_t state = lexerTables.transition(LexerTables::start, peekChar());
+        std::uint8_t next;
+        skipChar();
+        while ((next = lexerTables.transition(state, peekChar())) != LexerTables::fail) {
+            state = next;
+            skipChar();
+        }
+        pushToken(lexerTables.accept(state), from);
     }
 
-    string::FastString getNumericLiteral()
+    void getNumericLiteral()
     {
-        std::string literal;
+        beginLexeme();
         if (peekChar() == '0') {
-            literal.push_back(peekChar());
-            skipChar();
+            takeChar();
             if (peekChar() == 'b') {
                 // Binary.
-                literal.push_back(peekChar());
-                skipChar();
+                takeChar();
                 while (peekChar() == '0' || peekChar() == '1') {
-                    literal.push_back(peekChar());
-                    skipChar();
+                    takeChar();
                 }
-                if (literal.size() == 2) {
+                if (m_index - m_lexemeFrom == 2) {
                     // Check if there was nothing after the prefix.
                     throw std::range_error("Binary prefix without a number.");
                 }
             } else if (peekChar() == 'o') {
-                literal.push_back(peekChar());
-                skipChar();
+                takeChar();
                 while (peekChar() >= '0' && peekChar() <= '7') {
-                    literal.push_back(peekChar());
-                    skipChar();
+                    takeChar();
                 }
-                if (literal.size() == 2) {
+                if (m_index - m_lexemeFrom == 2) {
                     // Check if there was nothing after the prefix.
                     throw std::range_error("Octal prefix without a number.");
                 }
             } else if (peekChar() == 'x') {
-                literal.push_back(peekChar());
-                skipChar();
-                while (isdigit(peekChar()) || (toupper(peekChar()) >= 'A' && toupper(peekChar()) <= 'F')) {
-                    literal.push_back(peekChar());
-                    skipChar();
+                takeChar();
+                while (lexerTables.isHexDigit(peekChar())) {
+                    takeChar();
                 }
-                if (literal.size() == 2) {
+                if (m_index - m_lexemeFrom == 2) {
                     // Check if there was nothing after the prefix.
                     throw std::range_error("Hexadecimal prefix without a number.");
                 }
-            } else if (isdigit(peekChar())) {
+            } else if (lexerTables.isDigit(peekChar())) {
                 throw std::range_error("Decimal numbers cannot start with 0 (use \"0o\" prefix for octal base).");
             }
             // Otherwise, it is number 0.
+        } else if constexpr (Source::contiguous) {
+            // Decimal.
+            skipTo(scanner::skipDigits(m_source.cursor() + 1, m_source.end()));
         } else {
             // Decimal.
             do {
-                literal.push_back(peekChar());
-                skipChar();
-            } while (isdigit(peekChar()));
+                takeChar();
+            } while (lexerTables.isDigit(peekChar()));
         }
-        return string::FastString(std::move(literal));
+        endLexeme();
     }
     
-    string::FastString getStringLiteral()
+    void getStringLiteral()
     {
-        std::string literal;
         // Ingore '"'.
         skipChar();
+        beginLexeme();
         while (peekChar() != '"' && peekChar() != '\n' && peekChar() != EOF) {
-            literal.push_back(peekChar());
-            skipChar();
+            takeChar();
         }
         if (peekChar() == '\n') {
             throw std::range_error("Reached end-of-line before ending string literal.");
         } else if (peekChar() == EOF) {
             throw std::range_error("Reached end-of-file before ending string literal.");
         }
+        endLexeme();
         // Ingore '"'.
         skipChar();
-        return string::FastString(std::move(literal));
     }
 
-    string::FastString getIdentifier()
+    void getIdentifier()
     {
-        std::string identifier;
+        beginLexeme();
         // By precondition, it should be valid.
-        identifier.push_back(peekChar());
+        if constexpr (Source::contiguous) {
+            skipTo(scanner::skipIdentifier(m_source.cursor() + 1, m_source.end()));
+        } else {
+            takeChar();
+            while (lexerTables.isIdentifierPart(peekChar())) {
+                takeChar();
+            }
+        }
+        endLexeme();
+    }
+
+    // Contiguous sources are viewed in place. Other sources copy the lexemes
+    // of the tokens in the lookahead window into a small ring of buffers.
+    void beginLexeme()
+    {
+        m_lexemeFrom = m_index;
+        if constexpr (!Source::contiguous) {
+            m_lexeme.clear();
+        }
+    }
+
+    void takeChar()
+    {
+        if constexpr (!Source::contiguous) {
+            m_lexeme.push_back(peekChar());
+        }
         skipChar();
-        while (isalnum(peekChar()) || peekChar() == '_') {
-            identifier.push_back(peekChar());
-            skipChar();
+    }
+
+    void endLexeme()
+    {
+        if constexpr (!Source::contiguous) {
+            auto& slot = m_lexemes[m_nextLexeme];
+            m_nextLexeme = (m_nextLexeme + 1) % numberOfLookaheads;
+            slot.first = m_lexemeFrom;
+            std::swap(slot.second, m_lexeme);
+        }
+    }
+
+    std::string_view text(std::size_t from, std::size_t to) const
+    {
+        if constexpr (Source::contiguous) {
+            return std::string_view(m_source.begin() + from, to - from);
+        } else {
+            for (const auto& [lexemeFrom, lexeme] : m_lexemes) {
+                if (lexemeFrom == from) return lexeme;
+            }
+            return {};
+        }
+    }
+
+    void pushToken(TokenType type, std::size_t from)
+    {
+        if (m_index > std::numeric_limits<std::uint32_t>::max()) {
+            throw std::range_error("Source offsets are limited to 32 bits.");
+        }
+        if (m_columns) {
+            // TokenStream finds line breaks in the text on demand.
+            m_columns->types.push_back(type);
+            m_columns->from.push_back(static_cast<std::uint32_t>(from));
+            m_columns->to.push_back(static_cast<std::uint32_t>(m_index));
+        } else {
+            if constexpr (Source::contiguous) {
+                // The scanning kernels skip trivia without looking at it, search it afterwards.
+                m_startsLine = std::memchr(m_source.begin() + m_triviaFrom, '\n', from - m_triviaFrom) != nullptr;
+            }
+            m_tokens.push({ type, m_startsLine, static_cast<std::uint32_t>(from), static_cast<std::uint32_t>(m_index) });
         }
-        return string::FastString(std::move(identifier));
     }
 
-    std::ifstream m_file;
+    Source m_source;
     std::size_t m_index;
+    // Where the trivia before the next token starts, and whether it holds a line break.
+    std::size_t m_triviaFrom = 0;
+    bool m_startsLine = false;
+    std::size_t m_lexemeFrom = 0;
+    std::string m_lexeme;
+    std::array<std::pair<std::size_t, std::string>, numberOfLookaheads> m_lexemes;
+    std::size_t m_nextLexeme = 0;
+    TokenColumns* m_columns;
     CircularQueue<Token, numberOfLookaheads> m_tokens;
 };
 
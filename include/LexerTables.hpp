@@ -0,0 +1,107 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "Token.hpp"
+
+// Locale-free character classes and the punctuator DFA used by the Lexer.
+// Both tables are generated at compile time from tokenSpellings, so a new
+// punctuator only needs its TokenType and its spelling.
+
+namespace frontend {
+
+class LexerTables final {
+public:
+    enum CharClass : std::uint8_t {
+        Other,
+        Whitespace,
+        Digit,
+        // [A-Za-z_], HexLetter for [A-Fa-f].
+        Letter,
+        HexLetter,
+        Quote,
+        // One class per character used by punctuators.
+        FirstPunctuator
+    };
+
+    static constexpr std::size_t maxClasses = 32;
+    static constexpr std::size_t maxStates = 48;
+    static constexpr std::uint8_t start = 0;
+    static constexpr std::uint8_t fail = 0xFF;
+
+    constexpr LexerTables() : m_classes{}, m_transitions{}, m_accepts{}
+    {
+        for (unsigned c = 0; c < 256; ++c) {
+            m_classes[c] = Other;
+        }
+        for (char c : std::string_view(" \t\n\v\f\r")) m_classes[static_cast<unsigned char>(c)] = Whitespace;
+        for (unsigned c = '0'; c <= '9'; ++c) m_classes[c] = Digit;
+        for (unsigned c = 'a'; c <= 'z'; ++c) m_classes[c] = c <= 'f' ? HexLetter : Letter;
+        for (unsigned c = 'A'; c <= 'Z'; ++c) m_classes[c] = c <= 'F' ? HexLetter : Letter;
+        m_classes['_'] = Letter;
+        m_classes['"'] = Quote;
+        // Every punctuator character gets its own class.
+        std::uint8_t classes = FirstPunctuator;
+        for (std::string_view spelling : tokenSpellings) {
+            for (char c : spelling) {
+                auto& charClass = m_classes[static_cast<unsigned char>(c)];
+                if (charClass == Other) {
+                    charClass = classes++;
+                }
+            }
+        }
+        if (classes > maxClasses) throw "LexerTables: too many punctuator characters.";
+        // The DFA is the trie of all spellings.
+        for (auto& row : m_transitions) {
+            for (auto& next : row) next = fail;
+        }
+        for (auto& accept : m_accepts) accept = TokenType::EndOfFile;
+        std::uint8_t states = 1;
+        for (std::size_t type = 0; type < tokenTypeCount; ++type) {
+            std::uint8_t state = start;
+            for (char c : tokenSpellings[type]) {
+                auto& next = m_transitions[state][m_classes[static_cast<unsigned char>(c)]];
+                if (next == fail) {
+                    if (states == maxStates) throw "LexerTables: too many states.";
+                    next = states++;
+                }
+                state = next;
+            }
+            if (state != start) m_accepts[state] = static_cast<TokenType>(type);
+        }
+        // The lexer does not backtrack, so every prefix must be a token itself.
+        for (std::uint8_t state = 1; state < states; ++state) {
+            if (m_accepts[state] == TokenType::EndOfFile) throw "LexerTables: punctuator prefix is not a token.";
+        }
+    }
+
+    constexpr CharClass classOf(char c) const noexcept
+    {
+        return static_cast<CharClass>(m_classes[static_cast<unsigned char>(c)]);
+    }
+
+    constexpr std::uint8_t transition(std::uint8_t state, char c) const noexcept
+    {
+        return m_transitions[state][m_classes[static_cast<unsigned char>(c)]];
+    }
+
+    constexpr TokenType accept(std::uint8_t state) const noexcept { return m_accepts[state]; }
+
+    constexpr bool isDigit(char c) const noexcept { return classOf(c) == Digit; }
+    constexpr bool isHexDigit(char c) const noexcept { return classOf(c) == Digit || classOf(c) == HexLetter; }
+    constexpr bool isIdentifierStart(char c) const noexcept { return classOf(c) == Letter || classOf(c) == HexLetter; }
+    constexpr bool isIdentifierPart(char c) const noexcept { return isIdentifierStart(c) || classOf(c) == Digit; }
+    constexpr bool isWhitespace(char c) const noexcept { return classOf(c) == Whitespace; }
+
+private:
+    std::array<std::uint8_t, 256> m_classes;
+    std::array<std::array<std::uint8_t, maxClasses>, maxStates> m_transitions;
+    std::array<TokenType, maxStates> m_accepts;
+};
+
+inline constexpr LexerTables lexerTables;
+
+} // namespace frontend
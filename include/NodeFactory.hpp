@@ -0,0 +1,43 @@
+#pragma once
+
+#include <memory_resource>
+#include <new>
+#include <utility>
+
+#include "ASTNode.hpp"
+#include "Arena.hpp"
+
+namespace frontend {
+
+// Creates nodes either on the heap or, when given an arena, inside it.
+// Arena nodes and their lists are never destroyed one by one: the arena
+// must outlive them and releases all of them at once.
+class NodeFactory final {
+public:
+    NodeFactory(Arena* arena = nullptr) noexcept : m_arena(arena) {}
+
+    template <typename T, typename... Args>
+    NodePtr<T> make(Args&&... args)
+    {
+        if (!m_arena) {
+            return NodePtr<T>(new T(std::forward<Args>(args)...));
+        }
+        T* node = new (m_arena->allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+        node->m_inArena = true;
+        return NodePtr<T>(node);
+    }
+
+    NodeList list() const { return NodeList(resource()); }
+
+    std::pmr::memory_resource* resource() const noexcept
+    {
+        return m_arena ? static_cast<std::pmr::memory_resource*>(m_arena) : std::pmr::new_delete_resource();
+    }
+
+    Arena* arena() const noexcept { return m_arena; }
+
+private:
+    Arena* m_arena;
+};
+
+} // namespace frontend
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "ASTNode.hpp"
+#include "NodeFactory.hpp"
+#include "Token.hpp"
+
+// Binding powers and node constructors of every operator, indexed by TokenType.
+// The Pratt parser reads nothing else, so a new prefix, infix or postfix
+// operator only needs a TokenType, a node class and a row here.
+
+namespace frontend {
+
+using PrefixFactory = NodePtr<Expression> (*)(NodeFactory&, NodePtr<Expression>&&, std::size_t from);
+using InfixFactory = NodePtr<Expression> (*)(NodeFactory&, NodePtr<Expression>&&, NodePtr<Expression>&&);
+using PostfixFactory = NodePtr<Expression> (*)(NodeFactory&, NodePtr<Expression>&&, std::size_t to);
+
+// How a token continues an expression that is already parsed.
+enum class InfixKind : std::uint8_t {
+    None,
+    Binary,
+    Postfix,
+    // Operators with operands of their own, handled by the parser.
+    MemberAccess,
+    FunctionCall,
+    SubscriptAccess
+};
+
+struct OperatorEntry {
+    // Power of the operand of a prefix operator, 0 if the token is not one.
+    std::uint8_t prefixPower = 0;
+    // Left binding power, an infix operator only takes an lhs parsed below it.
+    std::uint8_t infixPower = 0;
+    InfixKind infixKind = InfixKind::None;
+    PrefixFactory prefix = nullptr;
+    InfixFactory infix = nullptr;
+    PostfixFactory postfix = nullptr;
+};
+
+// Binary operators are left-associative: the rhs is parsed at infixPower + 1.
+// Postfix operators bind tighter than prefix ones, so -a++ is -(a++).
+namespace power {
+inline constexpr std::uint8_t equality = 2;
+inline constexpr std::uint8_t relational = 4;
+inline constexpr std::uint8_t shift = 6;
+inline constexpr std::uint8_t additive = 8;
+inline constexpr std::uint8_t multiplicative = 10;
+inline constexpr std::uint8_t prefix = 12;
+inline constexpr std::uint8_t postfix = 14;
+} // namespace power
+
+namespace detail {
+
+template <typename Node>
+NodePtr<Expression> makePrefix(NodeFactory& factory, NodePtr<Expression>&& argument, std::size_t from)
+{
+    return factory.make<Node>(std::move(argument), from);
+}
+
+template <typename Node>
+NodePtr<Expression> makeInfix(NodeFactory& factory, NodePtr<Expression>&& lhs, NodePtr<Expression>&& rhs)
+{
+    return factory.make<Node>(std::move(lhs), std::move(rhs));
+}
+
+template <typename Node>
+NodePtr<Expression> makePostfix(NodeFactory& factory, NodePtr<Expression>&& argument, std::size_t to)
+{
+    return factory.make<Node>(std::move(argument), to);
+}
+
+constexpr std::array<OperatorEntry, tokenTypeCount> makeOperatorTable()
+{
+    std::array<OperatorEntry, tokenTypeCount> table{};
+    auto at = [&](TokenType type) -> OperatorEntry& { return table[static_cast<std::size_t>(type)]; };
+    auto prefix = [&](TokenType type, PrefixFactory factory) {
+        at(type).prefixPower = power::prefix;
+        at(type).prefix = factory;
+    };
+    auto infix = [&](TokenType type, std::uint8_t power, InfixFactory factory) {
+        at(type).infixPower = power;
+        at(type).infixKind = InfixKind::Binary;
+        at(type).infix = factory;
+    };
+    auto postfix = [&](TokenType type, InfixKind kind, PostfixFactory factory = nullptr) {
+        at(type).infixPower = power::postfix;
+        at(type).infixKind = kind;
+        at(type).postfix = factory;
+    };
+
+    prefix(TokenType::Increment, makePrefix<PreIncrement>);
+    prefix(TokenType::Decrement, makePrefix<PreDecrement>);
+    prefix(TokenType::Plus, makePrefix<Positive>);
+    prefix(TokenType::Minus, makePrefix<Negative>);
+    prefix(TokenType::Exclamation, makePrefix<LogicalNegation>);
+    prefix(TokenType::Tilde, makePrefix<BitwiseNot>);
+
+    infix(TokenType::DoubleEquals, power::equality, makeInfix<Equals>);
+    infix(TokenType::ExclamationEquals, power::equality, makeInfix<NotEquals>);
+    infix(TokenType::LessThan, power::relational, makeInfix<LessThan>);
+    infix(TokenType::LessEquals, power::relational, makeInfix<LessEquals>);
+    infix(TokenType::GreaterThan, power::relational, makeInfix<GreaterThan>);
+    infix(TokenType::GreaterEquals, power::relational, makeInfix<GreaterEquals>);
+    infix(TokenType::DoubleLessThan, power::shift, makeInfix<ShiftLeft>);
+    infix(TokenType::DoubleGreaterThan, power::shift, makeInfix<ShiftRight>);
+    infix(TokenType::TripleGreaterThan, power::shift, makeInfix<ShiftRightLogic>);
+    infix(TokenType::Plus, power::additive, makeInfix<Addition>);
+    infix(TokenType::Minus, power::additive, makeInfix<Subtraction>);
+    infix(TokenType::Star, power::multiplicative, makeInfix<Multiplication>);
+    infix(TokenType::Slash, power::multiplicative, makeInfix<Division>);
+    infix(TokenType::Percent, power::multiplicative, makeInfix<Remainder>);
+
+    postfix(TokenType::Increment, InfixKind::Postfix, makePostfix<PostIncrement>);
+    postfix(TokenType::Decrement, InfixKind::Postfix, makePostfix<PostDecrement>);
+    postfix(TokenType::Dot, InfixKind::MemberAccess);
+    postfix(TokenType::OpenParenthesis, InfixKind::FunctionCall);
+    postfix(TokenType::OpenBracket, InfixKind::SubscriptAccess);
+    return table;
+}
+
+} // namespace detail
+
+inline constexpr std::array<OperatorEntry, tokenTypeCount> operatorTable = detail::makeOperatorTable();
+
+constexpr const OperatorEntry& operatorEntry(TokenType type) noexcept
+{
+    return operatorTable[static_cast<std::size_t>(type)];
+}
+
+} // namespace frontend
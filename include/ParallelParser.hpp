@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+
+#include "Arena.hpp"
+#include "Parser.hpp"
+#include "ThreadPool.hpp"
+#include "TokenStream.hpp"
+
+namespace frontend {
+
+// Parses one expression of a TokenStream on the threads of a pool. When the whole
+// expression is a large array literal or function call, a BracketIndex pre-pass
+// splits its elements at the top-level commas, chunks of elements are parsed in
+// parallel into arenas of their own, and the subtrees are stitched into a single
+// ArrayLiteral or FunctionCall node. Anything else, including every input with an
+// error, goes through Parser<TokenCursor>: trees and errors are always the same.
+class ParallelParser final {
+public:
+    struct Options {
+        // Smaller lists are parsed on the calling thread.
+        std::size_t minimumElements = 4096;
+        // More chunks than threads let stealing even out elements of uneven size.
+        std::size_t chunksPerThread = 4;
+        Arena::Options arena = {};
+    };
+
+    explicit ParallelParser(ThreadPool& pool) noexcept : ParallelParser(pool, Options{}) {}
+    ParallelParser(ThreadPool& pool, Options options) noexcept : m_pool(&pool), m_options(options) {}
+
+    // Same result as Parser<TokenCursor>(TokenCursor(stream)).parseExpressionInArena().
+    // The result keeps every chunk arena alive.
+    ParseResult parse(const TokenStream& stream) const;
+
+private:
+    ParseResult parseSequential(const TokenStream& stream) const;
+
+    ThreadPool* m_pool;
+    Options m_options;
+};
+
+} // namespace frontend
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "Arena.hpp"
+#include "Parser.hpp"
+
+namespace frontend {
+
+// Parsed trees of source texts seen before, for services parsing the same
+// expressions over and over. Trees are parsed into arenas and shared read-only:
+// an evicted tree lives on as long as someone holds it. Texts are hashed once
+// and compared on a hit, so a collision never returns the wrong tree.
+// Entries are spread over shards, each with its own lock and LRU order.
+class ParseCache final {
+public:
+    struct Options {
+        // Bytes of source text and arena chunks kept, split evenly between the shards.
+        std::size_t maxBytes = 64 * 1024 * 1024;
+        std::size_t shards = 16;
+        // The first chunk of each entry is sized from its text, up to arena.chunkSize.
+        Arena::Options arena = { .chunkSize = 4 * 1024 };
+    };
+
+    struct Stats {
+        std::uint64_t hits;
+        std::uint64_t misses;
+        std::uint64_t evictions;
+        std::size_t entries;
+        std::size_t bytes;
+    };
+
+    ParseCache() : ParseCache(Options{}) {}
+    explicit ParseCache(Options options);
+    ParseCache(const ParseCache&) = delete;
+    ParseCache& operator=(const ParseCache&) = delete;
+
+    // The tree of text, from the cache or parsed with parseExpression(). Parse errors
+    // are thrown and not cached. Offsets refer to text. Thread-safe.
+    std::shared_ptr<const ParseResult> parse(std::string_view text);
+
+    Stats stats() const;
+    void clear();
+
+private:
+    struct Entry {
+        std::string text;
+        std::size_t hash;
+        std::size_t bytes;
+        std::shared_ptr<const ParseResult> result;
+    };
+
+    using Lru = std::list<Entry>;
+
+    struct Shard {
+        mutable std::mutex mutex;
+        // Most recently used first.
+        Lru lru;
+        std::unordered_multimap<std::size_t, Lru::iterator> entries;
+        std::size_t bytes = 0;
+    };
+
+    Shard& shardOf(std::size_t hash) noexcept { return *m_shards[(hash >> 32 ^ hash) % m_shards.size()]; }
+    static Lru::iterator find(Shard& shard, std::string_view text, std::size_t hash) noexcept;
+
+    Options m_options;
+    std::size_t m_shardBytes;
+    std::vector<std::unique_ptr<Shard>> m_shards;
+    std::atomic<std::uint64_t> m_hits;
+    std::atomic<std::uint64_t> m_misses;
+    std::atomic<std::uint64_t> m_evictions;
+};
+
+} // namespace frontend
@@ -1,13 +1,56 @@
 #pragma once
 
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <string_view>
+#include <vector>
+
 #include "ASTNode.hpp"
+#include "Arena.hpp"
 #include "Lexer.hpp"
+#include "NodeFactory.hpp"
+#include "OperatorTable.hpp"
+#include "TokenStream.hpp"
 
 namespace frontend {
 
+// Owns a tree parsed into an arena, together with the arena.
+// Destroying it frees every node at once, without visiting the tree.
+class ParseResult final {
+public:
+    ParseResult(std::unique_ptr<Arena>&& arena, NodePtr<Expression>&& root) noexcept
+        : m_arena(std::move(arena))
+        , m_root(std::move(root))
+    {
+    }
+    ParseResult(ParseResult&&) noexcept = default;
+    ParseResult& operator=(ParseResult&& other) noexcept
+    {
+        // The old root must go before the arena holding it.
+        m_root = std::move(other.m_root);
+        m_arena = std::move(other.m_arena);
+        return *this;
+    }
+    ~ParseResult() = default;
+
+    const Expression& root() const noexcept { return *m_root; }
+    const Expression* operator->() const noexcept { return m_root.get(); }
+    explicit operator bool() const noexcept { return m_root != nullptr; }
+    const Arena* arena() const noexcept { return m_arena.get(); }
+
+private:
+    // Declared first, so that it is destroyed after the root.
+    std::unique_ptr<Arena> m_arena;
+    NodePtr<Expression> m_root;
+};
+
+// LexerType is any Lexer<2, Source>, see Source.hpp for the available sources,
+// or a TokenCursor over a pre-tokenized TokenStream.
+template <typename LexerType = Lexer<2>>
 class Parser final {
 public:
-    Parser(Lexer<2>&& lexer)
+    Parser(LexerType&& lexer)
         : m_lexer(std::move(lexer))
     {
     }
@@ -17,21 +60,185 @@ public:
     Parser(Parser&&) = default;
     Parser& operator=(Parser&&) = default;
 
-    std::unique_ptr<Expression> parseExpression() { return parseEquality(); }
+    NodePtr<Expression> parseExpression()
+    {
+        begin(false);
+        return parseOperators(0);
+    }
+
+    // Parses without recursion: nesting costs heap memory instead of call stack,
+    // so machine-generated input of any depth is safe. Builds the same tree.
+    NodePtr<Expression> parseExpressionIterative()
+    {
+        begin(false);
+        return parseIterative();
+    }
+
+    // Parses with every node allocated from a new arena owned by the result.
+    ParseResult parseExpressionInArena(Arena::Options options = {})
+    {
+        return parseInArena(options, [this] { return parseExpression(); });
+    }
+
+    ParseResult parseExpressionIterativeInArena(Arena::Options options = {})
+    {
+        return parseInArena(options, [this] { return parseExpressionIterative(); });
+    }
+
+    // Parse the whole input with the given factory, on the heap or into an arena the caller
+    // keeps alive as long as the nodes, as one expression or as comma-separated list elements.
+    // Unlike parseExpression(), tokens left over are an error. ParallelParser and reparse()
+    // build one tree from such pieces.
+    NodePtr<Expression> parseExpressionInto(NodeFactory factory);
+    NodeList parseListInto(NodeFactory factory);
+
+    // Multiple expressions are separated by ';' or by line breaks: outside of
+    // brackets and parentheses, a complete expression ends at the end of its line.
+    // The lexer and its lookahead carry over from one expression to the next.
+    // Returns nullptr once the input is exhausted.
+    NodePtr<Expression> parseNext();
+    std::vector<NodePtr<Expression>> parseAll();
+
+    // Parses the next expression into the arena, after resetting it: the tree is
+    // valid until the next call, and the arena memory is reused by every expression.
+    const Expression* parseNext(Arena& arena);
+
+    class ExpressionIterator;
+    class ExpressionRange;
+    // for (const Expression& expression : parser.expressions(arena)), see parseNext(Arena&).
+    ExpressionRange expressions(Arena& arena) noexcept { return ExpressionRange(*this, arena); }
+
+    class ExpressionIterator {
+    public:
+        using value_type = Expression;
+        using difference_type = std::ptrdiff_t;
+
+        ExpressionIterator() noexcept = default;
+        ExpressionIterator(Parser& parser, Arena& arena) : m_parser(&parser), m_arena(&arena)
+        {
+            ++*this;
+        }
+
+        const Expression& operator*() const noexcept { return *m_current; }
+        const Expression* operator->() const noexcept { return m_current; }
+        ExpressionIterator& operator++()
+        {
+            m_current = m_parser->parseNext(*m_arena);
+            return *this;
+        }
+        void operator++(int) { ++*this; }
+        bool operator==(std::default_sentinel_t) const noexcept { return m_current == nullptr; }
+
+    private:
+        Parser* m_parser = nullptr;
+        Arena* m_arena = nullptr;
+        const Expression* m_current = nullptr;
+    };
+
+    class ExpressionRange {
+    public:
+        ExpressionRange(Parser& parser, Arena& arena) noexcept : m_parser(parser), m_arena(arena) {}
+        ExpressionIterator begin() const { return ExpressionIterator(m_parser, m_arena); }
+        std::default_sentinel_t end() const noexcept { return {}; }
+
+    private:
+        Parser& m_parser;
+        Arena& m_arena;
+    };
 
 private:
+    // A pending operator of the iterative parser, see parseIterative().
+    struct Frame {
+        enum class Kind : std::uint8_t {
+            // Parses operators above power, then may wait for the rhs, an argument or a subscript.
+            Operators,
+            // Waits for the operand of a prefix operator.
+            Prefix,
+            // Waits for the next element of an array literal.
+            Array
+        };
+        Kind kind;
+        InfixKind pending;
+        std::uint8_t power;
+        const OperatorEntry* entry;
+        std::size_t from;
+        NodePtr<Expression> node;
+        NodeList list;
+    };
+
+    template <typename Parse>
+    ParseResult parseInArena(Arena::Options options, Parse&& parse)
+    {
+        auto arena = std::make_unique<Arena>(options);
+        m_factory = NodeFactory(arena.get());
+        NodePtr<Expression> root;
+        try {
+            root = parse();
+        } catch (...) {
+            m_factory = NodeFactory();
+            throw;
+        }
+        m_factory = NodeFactory();
+        return ParseResult(std::move(arena), std::move(root));
+    }
+
+    template <typename Parse>
+    auto parseInto(NodeFactory factory, Parse&& parse)
+    {
+        begin(false);
+        m_factory = factory;
+        try {
+            auto parsed = parse();
+            if (m_lexer.peek().type != TokenType::EndOfFile) {
+                throwExpected("end of input");
+            }
+            m_factory = NodeFactory();
+            return parsed;
+        } catch (...) {
+            m_factory = NodeFactory();
+            throw;
+        }
+    }
+
+    [[noreturn]] void throwExpected(std::string_view expected);
+    // Starts a new expression, where line breaks may end it or not.
+    void begin(bool lineBreaks) noexcept
+    {
+        m_lineBreaks = lineBreaks;
+        m_nesting = 0;
+    }
+    // Whether the next token starts the next expression instead of continuing this one.
+    bool atLineBreak() noexcept
+    {
+        return m_lexer.peek().startsLine && m_lineBreaks && m_nesting == 0;
+    }
+    // Skips ';' separators, returns false at the end of the input.
+    bool skipSeparators();
+    // Throws unless the expression just parsed is followed by ';', a line break or the end.
+    void expectSeparator();
+    Frame frame(Frame::Kind kind, std::uint8_t power = 0, const OperatorEntry* entry = nullptr, std::size_t from = 0)
+    {
+        return { kind, InfixKind::None, power, entry, from, nullptr, m_factory.list() };
+    }
+    NodePtr<Expression> parseIterative();
     // Helper method, does not consume any delimiter.
-    std::vector<std::unique_ptr<Expression>> parseList(TokenType);
-    std::unique_ptr<Expression> parseEquality();
-    std::unique_ptr<Expression> parseRelational();
-    std::unique_ptr<Expression> parseShift();
-    std::unique_ptr<Expression> parseAdditive();
-    std::unique_ptr<Expression> parseMultiplicative();
-    std::unique_ptr<Expression> parseUnaryRightAssociative();
-    std::unique_ptr<Expression> parseUnaryLeftAssociative();
-    std::unique_ptr<Expression> parseTerminal();
-    std::unique_ptr<Expression> parseArrayLiteral();
-    Lexer<2> m_lexer;
+    NodeList parseList(TokenType);
+    // Pratt loop: parses operators binding tighter than minimumPower, see OperatorTable.hpp.
+    NodePtr<Expression> parseOperators(std::uint8_t minimumPower);
+    // A terminal, an array literal or a prefix operator with its operand, in one dispatch.
+    NodePtr<Expression> parsePrefix();
+    NodePtr<Expression> parseArrayLiteral();
+    LexerType m_lexer;
+    NodeFactory m_factory;
+    bool m_lineBreaks = false;
+    // Open brackets and parentheses.
+    std::size_t m_nesting = 0;
 };
 
+// Instantiated in Parser.cpp for every source and for TokenCursor.
+extern template class Parser<Lexer<2, StreamSource>>;
+extern template class Parser<Lexer<2, BufferSource>>;
+extern template class Parser<Lexer<2, MappedFileSource>>;
+extern template class Parser<TokenCursor>;
+
 }
\ No newline at end of file
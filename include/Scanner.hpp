@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+
+// Vectorized scanning kernels used by the Lexer on contiguous sources.
+// Every kernel scans [begin, end) and returns the first position that
+// does not belong to the run. The implementation is chosen at runtime.
+
+namespace frontend::scanner {
+
+enum class Isa {
+    Scalar,
+    SSE2,
+    AVX2
+};
+
+// Best implementation supported by the running CPU.
+Isa detect() noexcept;
+Isa active() noexcept;
+// Selects an implementation, the CPU must support it.
+void use(Isa isa) noexcept;
+
+// Skips ' ', '\t', '\n', '\v', '\f' and '\r'.
+const char* skipWhitespace(const char* begin, const char* end) noexcept;
+// Returns the first '\n', or end.
+const char* findLineEnd(const char* begin, const char* end) noexcept;
+// Returns the position right after the first "*/", or nullptr if there is none.
+const char* findBlockCommentEnd(const char* begin, const char* end) noexcept;
+// Skips [A-Za-z0-9_].
+const char* skipIdentifier(const char* begin, const char* end) noexcept;
+// Skips [0-9].
+const char* skipDigits(const char* begin, const char* end) noexcept;
+
+} // namespace frontend::scanner
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <utility>
+
+// Character sources for the Lexer. Every source provides peek(), which returns
+// the current character or EOF, and skip(), which advances one character.
+// Contiguous sources also expose the underlying buffer through raw pointers.
+
+namespace frontend {
+
+// Reads from a file stream, one character at a time.
+class StreamSource final {
+public:
+    static constexpr bool contiguous = false;
+
+    StreamSource(std::ifstream&& file) : m_file(std::move(file)) {}
+
+    int peek() { return m_file.peek(); }
+
+    void skip() { m_file.ignore(); }
+
+    // Reads everything that is left in the stream.
+    std::string readAll()
+    {
+        return std::string(std::istreambuf_iterator<char>(m_file), std::istreambuf_iterator<char>());
+    }
+
+private:
+    std::ifstream m_file;
+};
+
+// Scans a caller-owned contiguous buffer, which must outlive the source.
+class BufferSource {
+public:
+    static constexpr bool contiguous = true;
+
+    BufferSource(std::string_view buffer) noexcept
+        : BufferSource(buffer.data(), buffer.size())
+    {
+    }
+
+    BufferSource(const char* data, std::size_t size) noexcept
+        : m_begin(data)
+        , m_cursor(data)
+        , m_end(data + size)
+    {
+    }
+
+    int peek() const noexcept { return m_cursor != m_end ? static_cast<unsigned char>(*m_cursor) : EOF; }
+
+    void skip() noexcept { ++m_cursor; }
+
+    // Moves the cursor forward to a position inside the buffer.
+    void seek(const char* position) noexcept { m_cursor = position; }
+
+    const char* begin() const noexcept { return m_begin; }
+    const char* cursor() const noexcept { return m_cursor; }
+    const char* end() const noexcept { return m_end; }
+
+protected:
+    BufferSource() noexcept : m_begin(nullptr), m_cursor(nullptr), m_end(nullptr) {}
+
+    const char* m_begin;
+    const char* m_cursor;
+    const char* m_end;
+};
+
+// Maps a whole file into memory and scans it as a contiguous buffer.
+class MappedFileSource final : public BufferSource {
+public:
+    explicit MappedFileSource(const std::string& path);
+    MappedFileSource(const MappedFileSource&) = delete;
+    MappedFileSource& operator=(const MappedFileSource&) = delete;
+    MappedFileSource(MappedFileSource&& other) noexcept;
+    MappedFileSource& operator=(MappedFileSource&& other) noexcept;
+    ~MappedFileSource();
+
+private:
+    void unmap() noexcept;
+
+    void* m_mapping;
+    std::size_t m_length;
+};
+
+} // namespace frontend
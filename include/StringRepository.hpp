@@ -0,0 +1,58 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace frontend::string {
+
+// Process-wide interning table. Each distinct string is stored once and
+// identified by a stable handle; handle 0 is always the empty string.
+// Interning is thread-safe, and looking up an existing handle does not lock.
+class StringRepository final {
+public:
+    using Handle = std::uint32_t;
+
+    static StringRepository& instance();
+
+    StringRepository(const StringRepository&) = delete;
+    StringRepository& operator=(const StringRepository&) = delete;
+
+    Handle intern(std::string_view data);
+
+    const std::string& get(Handle handle) const noexcept
+    {
+        return m_chunks[handle >> chunkBits].load(std::memory_order_acquire)[handle & (chunkSize - 1)];
+    }
+
+    std::size_t size() const noexcept { return m_size.load(std::memory_order_relaxed); }
+
+private:
+    // Strings live in fixed-size chunks that are never moved or freed,
+    // so references returned by get() stay valid for the whole process.
+    static constexpr std::size_t chunkBits = 12;
+    static constexpr std::size_t chunkSize = std::size_t(1) << chunkBits;
+    static constexpr std::size_t maxChunks = std::size_t(1) << 16;
+    static constexpr std::size_t shardCount = 64;
+
+    struct Shard {
+        std::mutex mutex;
+        std::unordered_map<std::string_view, Handle> handles;
+    };
+
+    StringRepository();
+    ~StringRepository();
+
+    std::string& slot(Handle handle);
+
+    std::array<Shard, shardCount> m_shards;
+    std::atomic<std::size_t> m_size;
+    std::atomic<std::string*> m_chunks[maxChunks];
+};
+
+} // namespace frontend::string
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace frontend {
+
+// Fixed set of threads, each with a deque of tasks. A thread runs the newest
+// task of its own deque and, once it is empty, steals the oldest task of
+// another one, so uneven tasks still keep every thread busy.
+class ThreadPool final {
+public:
+    // The thread calling parallelFor() counts as one of them.
+    explicit ThreadPool(std::size_t threads = std::thread::hardware_concurrency());
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ~ThreadPool();
+
+    std::size_t size() const noexcept { return m_queues.size(); }
+
+    // Runs body(i) for every i in [0, count) and returns when all are done, helping
+    // with the work meanwhile. The first exception thrown by body is rethrown.
+    template <typename Body>
+    void parallelFor(std::size_t count, Body&& body)
+    {
+        Group group;
+        group.body = &body;
+        group.call = [](void* body, std::size_t index) { (*static_cast<Body*>(body))(index); };
+        run(group, count);
+    }
+
+private:
+    // The tasks of one parallelFor() call.
+    struct Group {
+        void* body;
+        void (*call)(void* body, std::size_t index);
+        // Only decremented under the mutex, which is the last thing a task touches.
+        std::atomic<std::size_t> remaining;
+        std::mutex mutex;
+        std::condition_variable done;
+        std::exception_ptr error;
+    };
+
+    struct Task {
+        Group* group;
+        std::size_t index;
+    };
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void run(Group& group, std::size_t count);
+    void work(std::size_t queue);
+    // Runs one task, from the given queue first, then stolen from the others.
+    bool runOne(std::size_t queue);
+    static void execute(const Task& task) noexcept;
+
+    std::vector<std::unique_ptr<Queue>> m_queues;
+    std::vector<std::thread> m_threads;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    // Tasks pushed but not taken yet, changed under m_mutex when rising.
+    std::atomic<std::size_t> m_queued;
+    bool m_stopping;
+};
+
+} // namespace frontend
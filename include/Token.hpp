@@ -1,10 +1,14 @@
 #pragma once
 
-#include "FastString.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
 
 namespace frontend {
 
-enum class TokenType : std::size_t {
+enum class TokenType : std::uint8_t {
     EndOfFile,
     Identifier,
     NumericLiteral,
@@ -33,14 +37,42 @@ enum class TokenType : std::size_t {
     TripleGreaterThan,
     Equals,
     DoubleEquals,
-    ExclamationEquals
+    ExclamationEquals,
+    Semicolon
 };
 
+inline constexpr std::size_t tokenTypeCount = static_cast<std::size_t>(TokenType::Semicolon) + 1;
+
+// Fixed spelling of every punctuator, indexed by TokenType; empty for the other tokens.
+inline constexpr std::array<std::string_view, tokenTypeCount> tokenSpellings = {
+    "", "", "", "",
+    "[", "]", "(", ")", ".", ",",
+    "+", "-", "*", "/", "%", "++", "--", "!", "~",
+    "<", "<=", ">", ">=", "<<", ">>", ">>>",
+    "=", "==", "!=", ";"
+};
+
+constexpr std::string_view tokenSpelling(TokenType type) noexcept
+{
+    return tokenSpellings[static_cast<std::size_t>(type)];
+}
+
+// The lexeme is not stored, it is recovered from the source, see Lexer::lexeme().
 struct Token {
-    string::FastString lexeme;
     TokenType type;
-    std::size_t from;
-    std::size_t to;
+    // A line break separates it from the previous token, it fits in the padding.
+    bool startsLine;
+    std::uint32_t from;
+    std::uint32_t to;
+};
+
+static_assert(sizeof(Token) == 12);
+
+// Tokens stored column by column, as produced by the lexer in batch mode.
+struct TokenColumns {
+    std::vector<TokenType> types;
+    std::vector<std::uint32_t> from;
+    std::vector<std::uint32_t> to;
 };
 
-} // namespace frontend
\ No newline at end of file
+} // namespace frontend
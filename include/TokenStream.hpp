@@ -0,0 +1,213 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Source.hpp"
+#include "Token.hpp"
+
+namespace frontend {
+
+// The range [from, to) of a text replaced by length bytes.
+struct TextEdit {
+    std::uint32_t from;
+    std::uint32_t to;
+    std::uint32_t length;
+};
+
+// All tokens of a source, stored column by column and ending with EndOfFile.
+// A stream is immutable once built: it can be shared by several threads and
+// parsed any number of times through TokenCursor.
+class TokenStream final {
+public:
+    using Index = std::uint32_t;
+
+    // The buffer must outlive the stream.
+    static TokenStream tokenize(std::string_view text);
+    // The stream keeps the text or the mapping alive.
+    static TokenStream tokenize(std::string&& text);
+    static TokenStream tokenize(MappedFileSource&& file);
+    // Reads the whole stream first.
+    static TokenStream tokenize(StreamSource&& stream);
+
+    TokenStream(TokenStream&&) noexcept = default;
+    TokenStream& operator=(TokenStream&&) noexcept = default;
+
+    // Including the final EndOfFile.
+    std::size_t size() const noexcept { return m_columns.types.size(); }
+    TokenType type(Index token) const noexcept { return m_columns.types[token]; }
+    std::uint32_t from(Index token) const noexcept { return m_columns.from[token]; }
+    std::uint32_t to(Index token) const noexcept { return m_columns.to[token]; }
+    Token token(Index token) const noexcept { return { type(token), startsLine(token), from(token), to(token) }; }
+
+    // Whether a line break separates the token from the previous one, found in the text.
+    bool startsLine(Index token) const noexcept
+    {
+        std::uint32_t triviaFrom = token > 0 ? to(token - 1) : 0;
+        return std::memchr(m_text.data() + triviaFrom, '\n', from(token) - triviaFrom) != nullptr;
+    }
+
+    std::span<const TokenType> types() const noexcept { return m_columns.types; }
+    std::span<const std::uint32_t> froms() const noexcept { return m_columns.from; }
+    std::span<const std::uint32_t> tos() const noexcept { return m_columns.to; }
+
+    std::string_view text() const noexcept { return m_text; }
+
+    // Same rules as Lexer::lexeme(), the view lives as long as the text.
+    std::string_view lexeme(const Token& token) const noexcept
+    {
+        switch (token.type) {
+            case TokenType::EndOfFile:
+                return {};
+            case TokenType::Identifier:
+            case TokenType::NumericLiteral:
+                return m_text.substr(token.from, token.to - token.from);
+            case TokenType::StringLiteral:
+                return m_text.substr(token.from + 1, token.to - token.from - 2);
+            default:
+                return tokenSpelling(token.type);
+        }
+    }
+
+private:
+    friend class TokenGapBuffer;
+
+    TokenStream(std::string_view text, std::shared_ptr<const void>&& owner);
+    TokenStream(std::string_view text, TokenColumns&& columns) noexcept;
+
+    std::shared_ptr<const void> m_owner;
+    std::string_view m_text;
+    TokenColumns m_columns;
+};
+
+// Reads the tokens [begin, end) of a stream with unlimited lookahead.
+// Past the end it returns an EndOfFile token placed where the slice ends.
+// It has the interface of Lexer, so a Parser can consume it.
+class TokenCursor final {
+public:
+    // The whole stream.
+    explicit TokenCursor(const TokenStream& stream) noexcept
+        : TokenCursor(stream, 0, static_cast<TokenStream::Index>(stream.size() - 1))
+    {
+    }
+
+    TokenCursor(const TokenStream& stream, TokenStream::Index begin, TokenStream::Index end) noexcept
+        : m_stream(&stream)
+        , m_position(begin)
+        , m_end(end)
+        , m_endOffset(end < stream.size() ? stream.from(end) : static_cast<std::uint32_t>(stream.text().size()))
+    {
+        load();
+    }
+
+    const Token& peek() const noexcept { return m_current; }
+
+    Token lookahead(std::size_t index) const noexcept
+    {
+        if (m_position + index >= m_end) return { TokenType::EndOfFile, false, m_endOffset, m_endOffset };
+        return m_stream->token(static_cast<TokenStream::Index>(m_position + index));
+    }
+
+    void skip() noexcept
+    {
+        if (m_position < m_end) ++m_position;
+        load();
+    }
+
+    std::string_view lexeme(const Token& token) const noexcept { return m_stream->lexeme(token); }
+
+    TokenStream::Index position() const noexcept { return m_position; }
+    const TokenStream& stream() const noexcept { return *m_stream; }
+
+private:
+    void load() noexcept
+    {
+        m_current = m_position < m_end
+            ? m_stream->token(m_position)
+            : Token{ TokenType::EndOfFile, false, m_endOffset, m_endOffset };
+    }
+
+    const TokenStream* m_stream;
+    TokenStream::Index m_position;
+    TokenStream::Index m_end;
+    std::uint32_t m_endOffset;
+    Token m_current;
+};
+
+// The tokens of a text being edited, in a gap buffer: replacing tokens only moves the
+// ones between the gap and the replaced ones, so that edits close to the previous one
+// are cheap whatever the size of the text. Offsets after the gap are kept from the end
+// of the text, a change of length before them leaves them as they are.
+class TokenGapBuffer final {
+public:
+    using Index = TokenStream::Index;
+
+    // The text must outlive the buffer, or the next replace().
+    explicit TokenGapBuffer(std::string_view text);
+
+    // Including the final EndOfFile.
+    std::size_t size() const noexcept { return m_columns.types.size() - (m_gapEnd - m_gapBegin); }
+    TokenType type(Index token) const noexcept { return m_columns.types[slot(token)]; }
+    std::uint32_t from(Index token) const noexcept { return offset(m_columns.from, token); }
+    std::uint32_t to(Index token) const noexcept { return offset(m_columns.to, token); }
+    std::string_view text() const noexcept { return m_text; }
+
+    // The first token from first on starting at or after offset.
+    Index firstFrom(std::uint32_t offset, Index first = 0) const noexcept;
+
+    // Where the tokens of two texts differ: [first, oldEnd) of one became [first, newEnd) of the other.
+    struct Change {
+        Index first;
+        Index oldEnd;
+        Index newEnd;
+    };
+
+    // Lexes the tokens of text, which is the text of the buffer with edit applied, that
+    // differ from those of the buffer into lexed, without changing the buffer: lexing
+    // starts just before the edit and stops at the first token starting where an old one
+    // did. Apply the result with replace(change.first, change.oldEnd, lexed, text).
+    Change lex(std::string_view text, const TextEdit& edit, TokenColumns& lexed) const;
+
+    // Replaces the tokens [first, end) by tokens, whose offsets are those of the new text.
+    void replace(Index first, Index end, const TokenColumns& tokens, std::string_view text);
+
+    // A copy of the tokens [begin, end).
+    TokenColumns columns(Index begin, Index end) const;
+
+    // The tokens [begin, end) in a stream of their own, read through cursor(). It holds the
+    // token before and the one after them too, which give the cursor its line breaks and
+    // the offset of its end.
+    struct Slice {
+        TokenStream stream;
+        Index begin;
+        Index end;
+
+        TokenCursor cursor() const noexcept { return TokenCursor(stream, begin, end); }
+    };
+    Slice slice(Index begin, Index end) const;
+
+private:
+    std::size_t slot(Index token) const noexcept { return token < m_gapBegin ? token : token + (m_gapEnd - m_gapBegin); }
+
+    std::uint32_t offset(const std::vector<std::uint32_t>& column, Index token) const noexcept
+    {
+        return token < m_gapBegin ? column[token] : static_cast<std::uint32_t>(m_text.size()) - column[slot(token)];
+    }
+
+    void moveGap(Index position) noexcept;
+    void reserveGap(std::size_t count);
+
+    std::string_view m_text;
+    TokenColumns m_columns;
+    // The slots [m_gapBegin, m_gapEnd) of the columns are free.
+    std::size_t m_gapBegin;
+    std::size_t m_gapEnd;
+};
+
+} // namespace frontend
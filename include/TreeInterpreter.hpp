@@ -0,0 +1,30 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+
+#include "ASTNode.hpp"
+#include "Value.hpp"
+
+namespace backend {
+
+// Evaluates an expression by walking its tree, looking variables up by name.
+// The reference semantics for the virtual machine and its baseline in
+// benchmarks; it recurses, so it is meant for expressions of moderate depth.
+class TreeInterpreter final {
+public:
+    using Environment = std::unordered_map<std::string, Value>;
+
+    // Increments write to the environment. Unknown variables throw std::runtime_error.
+    explicit TreeInterpreter(Environment& environment) noexcept : m_environment(environment) {}
+
+    Value evaluate(const frontend::Expression& expression);
+
+private:
+    Value increment(const frontend::UnaryOperator& node);
+    Value& variable(const frontend::Expression& identifier);
+
+    Environment& m_environment;
+};
+
+} // namespace backend
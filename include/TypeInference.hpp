@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "ExpressionType.hpp"
+#include "FastString.hpp"
+#include "FlatAST.hpp"
+
+namespace frontend {
+
+// Gives every node of a flattened expression its ExpressionType, kept in a
+// column next to the columns of the FlatAST. Children follow their parent in
+// the FlatAST, so one backward sweep types the operands of each node before
+// the node: the pass is linear and never recurses.
+//
+// Numeric literals take the narrowest unsigned type that holds them, up to
+// uint256. Arithmetic on integers gives their common type: the wider one, and
+// signed when either is signed, widened by 8 bits when the unsigned one would
+// not fit. Unary - makes unsigned types signed and 8 bits wider, + and ~ keep
+// the type, ++ and -- need an integer. No type is wider than 256 bits, so
+// uint256 with a signed type, or under unary -, is a diagnostic. Shifts keep
+// the type of their left operand. + also concatenates strings. Comparisons and
+// ! give Bool: == and != compare integers or two operands of the same type, the
+// others integers or strings. Array literals have the common type of their
+// integer elements, or the type every element has. Subscripts give the element
+// type.
+//
+// Variables have the types of the environment. Members and calls have no type,
+// without a diagnostic, and the name of a called function is not looked up.
+// Nodes without a type are nullptr: the errors are reported as diagnostics, and
+// the operators over untyped operands are untyped without more diagnostics.
+class TypeInference final {
+public:
+    struct Diagnostic {
+        std::size_t from;
+        std::size_t to;
+        std::string message;
+    };
+
+    using Environment = std::unordered_map<string::FastString, const ExpressionType*>;
+
+    explicit TypeInference(Environment environment = {}) : m_environment(std::move(environment)) {}
+
+    // Types every node of tree, replacing the types of the previous tree.
+    void infer(const FlatAST& tree);
+
+    const ExpressionType* type(FlatAST::Index node) const noexcept { return m_types[node]; }
+    // Indexed like the columns of the tree.
+    std::span<const ExpressionType* const> types() const noexcept { return m_types; }
+    const std::vector<Diagnostic>& diagnostics() const noexcept { return m_diagnostics; }
+
+private:
+    const ExpressionType* inferNode(const FlatAST& tree, FlatAST::Index node);
+    const ExpressionType* literalType(string::FastString literal);
+    const ExpressionType* diagnose(const FlatAST& tree, FlatAST::Index node, std::string_view message);
+
+    Environment m_environment;
+    std::vector<const ExpressionType*> m_types;
+    // The identifiers naming members or called functions rather than variables.
+    std::vector<bool> m_unboundNames;
+    // Literals repeat, their widths are computed once.
+    std::unordered_map<string::FastString, const ExpressionType*> m_literals;
+    std::vector<Diagnostic> m_diagnostics;
+};
+
+} // namespace frontend
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <concepts>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+#include "ASTNode.hpp"
+#include "FastString.hpp"
+#include "WideInt.hpp"
+
+namespace backend {
+
+class Value;
+
+using Integer = frontend::WideInt<64, true>;
+using Array = std::vector<Value>;
+using Object = std::unordered_map<frontend::string::FastString, Value>;
+using Function = std::function<Value(std::span<const Value>)>;
+
+// What an expression evaluates to. Integers wrap around like WideInt, strings
+// are immutable, arrays, objects and functions are shared by reference: copies
+// of a Value see the increments applied through any of them.
+class Value final {
+public:
+    enum class Kind : std::uint8_t {
+        None,
+        Boolean,
+        Integer,
+        String,
+        Array,
+        Object,
+        Function
+    };
+
+    Value() noexcept = default;
+    // Only bool itself, so that integers and pointers do not convert to it.
+    template <std::same_as<bool> Bool>
+    Value(Bool boolean) noexcept : m_value(boolean) {}
+    Value(Integer integer) noexcept : m_value(integer) {}
+    Value(std::int64_t integer) noexcept : m_value(Integer(integer)) {}
+    Value(std::string_view string) : m_value(std::make_shared<const std::string>(string)) {}
+    Value(const char* string) : Value(std::string_view(string)) {}
+    Value(Array&& array) : m_value(std::make_shared<Array>(std::move(array))) {}
+    Value(Object&& object) : m_value(std::make_shared<Object>(std::move(object))) {}
+    Value(Function&& function) : m_value(std::make_shared<const Function>(std::move(function))) {}
+
+    Kind kind() const noexcept { return static_cast<Kind>(m_value.index()); }
+    bool isInteger() const noexcept { return kind() == Kind::Integer; }
+
+    // Throw std::runtime_error for another kind.
+    bool boolean() const { return get<bool>(Kind::Boolean); }
+    Integer integer() const { return get<Integer>(Kind::Integer); }
+    const std::string& string() const { return *get<std::shared_ptr<const std::string>>(Kind::String); }
+    Array& array() const { return *get<std::shared_ptr<Array>>(Kind::Array); }
+    Object& object() const { return *get<std::shared_ptr<Object>>(Kind::Object); }
+    const Function& function() const { return *get<std::shared_ptr<const Function>>(Kind::Function); }
+
+    // Unchecked, for the fast paths of the virtual machine.
+    Integer integerUnchecked() const noexcept { return *std::get_if<Integer>(&m_value); }
+    void setInteger(Integer integer) noexcept { set(integer); }
+    void setBoolean(bool boolean) noexcept { set(boolean); }
+
+    // Arrays compare their elements, objects and functions their identity.
+    friend bool operator==(const Value& lhs, const Value& rhs);
+
+    // Literal syntax, objects as {name: value, ...} in no particular order.
+    std::string toString() const;
+
+private:
+    // Without visiting the variant when it already holds a T.
+    template <typename T>
+    void set(T value) noexcept
+    {
+        if (auto* current = std::get_if<T>(&m_value)) {
+            *current = value;
+        } else {
+            m_value = value;
+        }
+    }
+
+    template <typename T>
+    const T& get(Kind kind) const
+    {
+        if (auto* value = std::get_if<T>(&m_value)) return *value;
+        throwKind(kind);
+    }
+    [[noreturn]] void throwKind(Kind expected) const;
+
+    std::variant<std::monostate, bool, Integer, std::shared_ptr<const std::string>, std::shared_ptr<Array>,
+        std::shared_ptr<Object>, std::shared_ptr<const Function>>
+        m_value;
+};
+
+bool operator==(const Value& lhs, const Value& rhs);
+
+// Counts of 64 and more, or negative, shift every bit out.
+inline unsigned shiftCount(Integer count) noexcept
+{
+    auto bits = static_cast<std::int64_t>(count.low());
+    return bits < 0 || bits > 64 ? 64 : static_cast<unsigned>(bits);
+}
+
+const char* kindName(Value::Kind kind) noexcept;
+
+// The semantics of the operators, shared by every evaluator. Binary operators
+// take integers, + also concatenates strings; comparisons also order strings,
+// == and != take any values. Unary operators take integers, ! also booleans,
+// ++ and -- are +1 and -1. Errors throw std::runtime_error, and division by
+// zero std::domain_error.
+Value evaluateBinary(frontend::NodeType type, const Value& lhs, const Value& rhs);
+Value evaluateUnary(frontend::NodeType type, const Value& argument);
+// Arrays only, out of bounds throws std::out_of_range.
+Value& element(const Value& array, const Value& index);
+// Objects only, a missing member throws std::runtime_error.
+Value& member(const Value& object, frontend::string::FastString name);
+Value call(const Value& function, std::span<const Value> arguments);
+
+} // namespace backend
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "Bytecode.hpp"
+#include "Value.hpp"
+
+namespace backend {
+
+// Runs programs on a register file kept between runs: running the same program
+// again only copies its inputs in. Not thread-safe, use one machine per thread.
+class VirtualMachine final {
+public:
+    // The inputs are the values of program.inputs(), in that order. The ones the
+    // program increments are written back. Errors throw like evaluateBinary().
+    Value run(const Program& program, std::span<Value> inputs);
+
+private:
+    void load(const Program& program);
+
+    std::vector<Value> m_registers;
+    std::uint64_t m_loaded = ~std::uint64_t(0);
+};
+
+} // namespace backend
@@ -0,0 +1,295 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "ASTNode.hpp"
+
+namespace frontend {
+
+// The node classes, named like their NodeType, by the base class they share.
+#define FRONTEND_TERMINAL_NODES(X) X(Identifier) X(NumericLiteral) X(StringLiteral)
+#define FRONTEND_COMPOUND_NODES(X) X(ArrayLiteral) X(MemberAccess) X(FunctionCall) X(SubscriptAccess)
+#define FRONTEND_UNARY_NODES(X)                                                                     \
+    X(PostIncrement) X(PostDecrement) X(PreIncrement) X(PreDecrement) X(Negative) X(Positive)       \
+    X(LogicalNegation) X(BitwiseNot)
+#define FRONTEND_BINARY_NODES(X)                                                                    \
+    X(Addition) X(Subtraction) X(Multiplication) X(Division) X(Remainder) X(ShiftLeft)              \
+    X(ShiftRight) X(ShiftRightLogic) X(LessThan) X(LessEquals) X(GreaterThan) X(GreaterEquals)      \
+    X(Equals) X(NotEquals)
+#define FRONTEND_NODE_TYPES(X)                                                                      \
+    FRONTEND_TERMINAL_NODES(X) FRONTEND_COMPOUND_NODES(X) FRONTEND_UNARY_NODES(X)                   \
+    FRONTEND_BINARY_NODES(X)
+
+template <NodeType type>
+struct NodeClassOf;
+
+#define FRONTEND_NODE_CLASS(CLASS_NAME)                                                             \
+    template <>                                                                                     \
+    struct NodeClassOf<NodeType::CLASS_NAME> {                                                      \
+        using Type = CLASS_NAME;                                                                    \
+    };
+FRONTEND_NODE_TYPES(FRONTEND_NODE_CLASS)
+#undef FRONTEND_NODE_CLASS
+
+// The class of the nodes of a type.
+template <NodeType type>
+using NodeClass = typename NodeClassOf<type>::Type;
+
+#define FRONTEND_COUNT_NODE(CLASS_NAME) +1
+static_assert(0 FRONTEND_NODE_TYPES(FRONTEND_COUNT_NODE) == static_cast<std::size_t>(NodeType::NotEquals) + 1,
+    "Every NodeType needs a node class.");
+#undef FRONTEND_COUNT_NODE
+
+// T, const when Node is.
+template <typename Node, typename T>
+using LikeNode = std::conditional_t<std::is_const_v<Node>, const T, T>;
+
+// Calls function with node cast to the class of its nodeType(). The switch makes
+// a direct call in every case, which the compiler can inline.
+template <typename Node, typename Function>
+    requires std::derived_from<std::remove_const_t<Node>, ASTNode>
+decltype(auto) dispatch(Node& node, Function&& function)
+{
+    switch (node.nodeType()) {
+#define FRONTEND_DISPATCH_CASE(CLASS_NAME)                                                          \
+        case NodeType::CLASS_NAME:                                                                  \
+            return function(static_cast<LikeNode<Node, CLASS_NAME>&>(node));
+        FRONTEND_NODE_TYPES(FRONTEND_DISPATCH_CASE)
+#undef FRONTEND_DISPATCH_CASE
+    }
+    std::unreachable();
+}
+
+// The one place that knows which members of each class hold its children: the
+// node classes make it a friend, the functions below go through it.
+struct ChildSlots {
+    // Calls function with the owning pointer of each child of node, in source order:
+    // NodePtr<Identifier>& for the member name of MemberAccess, NodePtr<Expression>&
+    // for the others.
+    template <typename Class, typename Function>
+    static void forEach(Class& node, Function& function)
+    {
+        if constexpr (std::derived_from<Class, UnaryOperator>) {
+            function(static_cast<UnaryOperator&>(node).m_argument);
+        } else if constexpr (std::derived_from<Class, BinaryOperator>) {
+            auto& binary = static_cast<BinaryOperator&>(node);
+            function(binary.m_lhs);
+            function(binary.m_rhs);
+        } else if constexpr (std::same_as<Class, ArrayLiteral>) {
+            for (auto& element : node.m_array) function(element);
+        } else if constexpr (std::same_as<Class, MemberAccess>) {
+            function(node.m_argument);
+            function(node.m_identifier);
+        } else if constexpr (std::same_as<Class, FunctionCall>) {
+            function(node.m_function);
+            for (auto& argument : node.m_arguments) function(argument);
+        } else if constexpr (std::same_as<Class, SubscriptAccess>) {
+            function(node.m_argument);
+            function(node.m_subscript);
+        }
+    }
+
+    template <typename Class>
+    static NodePtr<Expression>* delimited(Class& node, std::size_t index) noexcept
+    {
+        if constexpr (std::same_as<Class, ArrayLiteral>) {
+            return &node.m_array[index];
+        } else if constexpr (std::same_as<Class, FunctionCall>) {
+            return index == 0 ? nullptr : &node.m_arguments[index - 1];
+        } else if constexpr (std::same_as<Class, SubscriptAccess>) {
+            return index == 1 ? &node.m_subscript : nullptr;
+        } else {
+            return nullptr;
+        }
+    }
+};
+
+// Calls function with the owning pointer of each child of node, in source order,
+// without virtual calls, for passes that replace or detach the children. The member
+// name of MemberAccess comes as a NodePtr<Identifier>&, every other child as a
+// NodePtr<Expression>&.
+template <typename Node, typename Function>
+    requires std::derived_from<Node, ASTNode>
+void forEachChildSlot(Node& node, Function&& function)
+{
+    dispatch(node, [&](auto& typed) { ChildSlots::forEach(typed, function); });
+}
+
+// Calls function with each child of node, in source order, without virtual calls.
+template <typename Node, typename Function>
+    requires std::derived_from<std::remove_const_t<Node>, ASTNode>
+void forEachChild(Node& node, Function&& function)
+{
+    dispatch(node, [&]<typename T>(T& typed) {
+        // Only read here: the children of a const node stay const.
+        auto child = [&](auto& slot) { function(static_cast<LikeNode<Node, Expression>&>(*slot)); };
+        ChildSlots::forEach(const_cast<std::remove_const_t<T>&>(typed), child);
+    });
+}
+
+// The child at index, in the order of forEachChild(), when it is parsed between
+// delimiters of its own, a list element or a subscript, and nullptr otherwise: an
+// edit inside one of them only needs that child parsed again.
+inline NodePtr<Expression>* delimitedChild(ASTNode& node, std::size_t index) noexcept
+{
+    return dispatch(node, [&](auto& typed) { return ChildSlots::delimited(typed, index); });
+}
+
+// Base of the visitors, dispatching on nodeType() to the handler of each class:
+// visitAddition(), visitIdentifier(), ... A derived class defines the handlers
+// it needs; the others fall back to visitUnaryOperator() or visitBinaryOperator(),
+// then to visitExpression(), which returns Result().
+//
+//     struct Counter : ConstVisitor<Counter> {
+//         std::size_t literals = 0;
+//         void visitNumericLiteral(const NumericLiteral&) { ++literals; }
+//     };
+//     Counter counter;
+//     counter.traverse(tree);
+template <typename Derived, typename Result, bool isConst>
+class BasicVisitor {
+public:
+    template <typename T>
+    using Node = std::conditional_t<isConst, const T, T>;
+
+    // Calls the handler of node.
+    Result visit(Node<Expression>& node)
+    {
+        switch (node.nodeType()) {
+#define FRONTEND_VISIT_CASE(CLASS_NAME)                                                             \
+            case NodeType::CLASS_NAME:                                                              \
+                return derived().visit##CLASS_NAME(static_cast<Node<CLASS_NAME>&>(node));
+            FRONTEND_NODE_TYPES(FRONTEND_VISIT_CASE)
+#undef FRONTEND_VISIT_CASE
+        }
+        std::unreachable();
+    }
+
+    // Calls the handler of every node of the tree, parents before their children,
+    // without recursion so that any depth is safe.
+    void traverse(Node<Expression>& root)
+    {
+        std::vector<Node<Expression>*> pending{ &root };
+        while (!pending.empty()) {
+            Node<Expression>* node = pending.back();
+            pending.pop_back();
+            visit(*node);
+            std::size_t first = pending.size();
+            forEachChild(*node, [&](Node<Expression>& child) { pending.push_back(&child); });
+            std::reverse(pending.begin() + first, pending.end());
+        }
+    }
+
+#define FRONTEND_VISIT_DEFAULT(CLASS_NAME, FALLBACK)                                                \
+    Result visit##CLASS_NAME(Node<CLASS_NAME>& node) { return derived().FALLBACK(node); }
+#define FRONTEND_VISIT_EXPRESSION(CLASS_NAME) FRONTEND_VISIT_DEFAULT(CLASS_NAME, visitExpression)
+#define FRONTEND_VISIT_UNARY(CLASS_NAME) FRONTEND_VISIT_DEFAULT(CLASS_NAME, visitUnaryOperator)
+#define FRONTEND_VISIT_BINARY(CLASS_NAME) FRONTEND_VISIT_DEFAULT(CLASS_NAME, visitBinaryOperator)
+    FRONTEND_TERMINAL_NODES(FRONTEND_VISIT_EXPRESSION)
+    FRONTEND_COMPOUND_NODES(FRONTEND_VISIT_EXPRESSION)
+    FRONTEND_UNARY_NODES(FRONTEND_VISIT_UNARY)
+    FRONTEND_BINARY_NODES(FRONTEND_VISIT_BINARY)
+#undef FRONTEND_VISIT_BINARY
+#undef FRONTEND_VISIT_UNARY
+#undef FRONTEND_VISIT_EXPRESSION
+#undef FRONTEND_VISIT_DEFAULT
+
+    Result visitUnaryOperator(Node<UnaryOperator>& node) { return derived().visitExpression(node); }
+    Result visitBinaryOperator(Node<BinaryOperator>& node) { return derived().visitExpression(node); }
+    Result visitExpression(Node<Expression>&) { return Result(); }
+
+protected:
+    BasicVisitor() = default;
+
+private:
+    Derived& derived() noexcept { return static_cast<Derived&>(*this); }
+};
+
+// Reads the tree.
+template <typename Derived, typename Result = void>
+using ConstVisitor = BasicVisitor<Derived, Result, true>;
+
+// Gets the nodes mutable, to move them or to replace their operands.
+template <typename Derived, typename Result = void>
+using MutableVisitor = BasicVisitor<Derived, Result, false>;
+
+// Rewrites a tree bottom-up: every node, after its operands, goes to the handler
+// of its class, rewriteAddition(), rewriteIdentifier(), ..., which returns the
+// node replacing it, or nullptr to keep it. Unhandled classes fall back like in
+// BasicVisitor, to rewriteUnaryOperator(), rewriteBinaryOperator() and then
+// rewriteExpression(), which keeps the node. Replacements are not rewritten again.
+template <typename Derived>
+class Rewriter {
+public:
+    // Without recursion. Returns the number of nodes replaced.
+    std::size_t rewrite(NodePtr<Expression>& tree)
+    {
+        if (!tree) return 0;
+        struct Pending {
+            NodePtr<Expression>* slot;
+            bool visited;
+        };
+        std::vector<Pending> pending{ { &tree, false } };
+        std::size_t replaced = 0;
+        while (!pending.empty()) {
+            auto [slot, visited] = pending.back();
+            if (!visited) {
+                pending.back().visited = true;
+                // The operands, all children but the member name of MemberAccess.
+                forEachChildSlot(**slot, [&]<typename T>(NodePtr<T>& child) {
+                    if constexpr (std::same_as<T, Expression>) pending.push_back({ &child, false });
+                });
+                continue;
+            }
+            pending.pop_back();
+            if (auto replacement = rewriteNode(**slot)) {
+                *slot = std::move(replacement);
+                ++replaced;
+            }
+        }
+        return replaced;
+    }
+
+#define FRONTEND_REWRITE_DEFAULT(CLASS_NAME, FALLBACK)                                              \
+    NodePtr<Expression> rewrite##CLASS_NAME(CLASS_NAME& node) { return derived().FALLBACK(node); }
+#define FRONTEND_REWRITE_EXPRESSION(CLASS_NAME) FRONTEND_REWRITE_DEFAULT(CLASS_NAME, rewriteExpression)
+#define FRONTEND_REWRITE_UNARY(CLASS_NAME) FRONTEND_REWRITE_DEFAULT(CLASS_NAME, rewriteUnaryOperator)
+#define FRONTEND_REWRITE_BINARY(CLASS_NAME) FRONTEND_REWRITE_DEFAULT(CLASS_NAME, rewriteBinaryOperator)
+    FRONTEND_TERMINAL_NODES(FRONTEND_REWRITE_EXPRESSION)
+    FRONTEND_COMPOUND_NODES(FRONTEND_REWRITE_EXPRESSION)
+    FRONTEND_UNARY_NODES(FRONTEND_REWRITE_UNARY)
+    FRONTEND_BINARY_NODES(FRONTEND_REWRITE_BINARY)
+#undef FRONTEND_REWRITE_BINARY
+#undef FRONTEND_REWRITE_UNARY
+#undef FRONTEND_REWRITE_EXPRESSION
+#undef FRONTEND_REWRITE_DEFAULT
+
+    NodePtr<Expression> rewriteUnaryOperator(UnaryOperator& node) { return derived().rewriteExpression(node); }
+    NodePtr<Expression> rewriteBinaryOperator(BinaryOperator& node) { return derived().rewriteExpression(node); }
+    NodePtr<Expression> rewriteExpression(Expression&) { return nullptr; }
+
+protected:
+    Rewriter() = default;
+
+private:
+    NodePtr<Expression> rewriteNode(Expression& node)
+    {
+        switch (node.nodeType()) {
+#define FRONTEND_REWRITE_CASE(CLASS_NAME)                                                           \
+            case NodeType::CLASS_NAME:                                                              \
+                return derived().rewrite##CLASS_NAME(static_cast<CLASS_NAME&>(node));
+            FRONTEND_NODE_TYPES(FRONTEND_REWRITE_CASE)
+#undef FRONTEND_REWRITE_CASE
+        }
+        std::unreachable();
+    }
+
+    Derived& derived() noexcept { return static_cast<Derived&>(*this); }
+};
+
+} // namespace frontend
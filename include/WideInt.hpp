@@ -0,0 +1,539 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "ExpressionType.hpp"
+
+namespace frontend {
+
+namespace detail {
+__extension__ using Uint128 = unsigned __int128;
+__extension__ using Int128 = __int128;
+} // namespace detail
+
+// A width-bit two's complement integer, one of the integer types of
+// BasicExpressionType. Arithmetic wraps around modulo 2^width like unsigned C++
+// arithmetic, for signed integers too: min() / -1 is min(). Only a division by
+// zero throws. Shifting by width or more bits shifts every bit out.
+//
+// The value is stored in 64-bit limbs, least significant first. The bits of the
+// last limb above width copy the sign bit of signed integers and are zero for
+// unsigned ones, so that comparisons and conversions read the limbs as they are.
+// Widths up to 64 compute on one native integer, widths up to 128 on __int128,
+// wider ones loop over the limbs.
+template <unsigned width, bool isSigned>
+class WideInt final {
+    static_assert(width >= 8 && width <= 256 && width % 8 == 0, "WideInt: width must be a multiple of 8 up to 256");
+
+public:
+    static constexpr unsigned bits = width;
+    static constexpr bool signedness = isSigned;
+    static constexpr std::size_t limbCount = (width + 63) / 64;
+    using Limbs = std::array<std::uint64_t, limbCount>;
+
+    constexpr WideInt() noexcept = default;
+
+    // Wraps around when the value does not fit.
+    constexpr WideInt(std::int64_t value) noexcept
+    {
+        m_limbs.fill(value < 0 ? ~std::uint64_t(0) : 0);
+        m_limbs[0] = static_cast<std::uint64_t>(value);
+        normalize();
+    }
+
+    // Truncates or extends the value like a cast between built-in integers.
+    template <unsigned otherWidth, bool otherSigned>
+    explicit constexpr WideInt(const WideInt<otherWidth, otherSigned>& other) noexcept
+    {
+        std::uint64_t fill = other.isNegative() ? ~std::uint64_t(0) : 0;
+        for (std::size_t i = 0; i < limbCount; ++i) {
+            m_limbs[i] = i < other.limbCount ? other.limbs()[i] : fill;
+        }
+        normalize();
+    }
+
+    // The value of the low width bits of limbs.
+    static constexpr WideInt fromLimbs(const Limbs& limbs) noexcept
+    {
+        WideInt result;
+        result.m_limbs = limbs;
+        result.normalize();
+        return result;
+    }
+
+    static constexpr WideInt min() noexcept
+    {
+        WideInt result;
+        if constexpr (isSigned) {
+            result.m_limbs[(width - 1) / 64] = std::uint64_t(1) << ((width - 1) % 64);
+            result.normalize();
+        }
+        return result;
+    }
+
+    static constexpr WideInt max() noexcept { return ~min(); }
+
+    // A decimal literal with an optional minus sign, or a 0x, 0o or 0b literal as
+    // the lexer reads them. Nothing if the text is not one or the value does not fit.
+    static constexpr std::optional<WideInt> parse(std::string_view text) noexcept;
+
+    constexpr const Limbs& limbs() const noexcept { return m_limbs; }
+    constexpr std::uint64_t low() const noexcept { return m_limbs[0]; }
+    constexpr bool isNegative() const noexcept { return isSigned && m_limbs.back() >> 63; }
+    constexpr bool isZero() const noexcept { return *this == WideInt(); }
+
+    // In decimal.
+    constexpr std::string toString() const;
+
+    friend constexpr WideInt operator+(WideInt lhs, const WideInt& rhs) noexcept
+    {
+        if constexpr (limbCount == 1) {
+            lhs.m_limbs[0] += rhs.m_limbs[0];
+        } else if constexpr (limbCount == 2) {
+            lhs.setWide(lhs.wide() + rhs.wide());
+        } else {
+            std::uint64_t carry = 0;
+            for (std::size_t i = 0; i < limbCount; ++i) {
+                detail::Uint128 sum = detail::Uint128(lhs.m_limbs[i]) + rhs.m_limbs[i] + carry;
+                lhs.m_limbs[i] = static_cast<std::uint64_t>(sum);
+                carry = static_cast<std::uint64_t>(sum >> 64);
+            }
+        }
+        lhs.normalize();
+        return lhs;
+    }
+
+    friend constexpr WideInt operator-(WideInt lhs, const WideInt& rhs) noexcept
+    {
+        if constexpr (limbCount == 1) {
+            lhs.m_limbs[0] -= rhs.m_limbs[0];
+        } else if constexpr (limbCount == 2) {
+            lhs.setWide(lhs.wide() - rhs.wide());
+        } else {
+            std::uint64_t borrow = 0;
+            for (std::size_t i = 0; i < limbCount; ++i) {
+                detail::Uint128 difference = detail::Uint128(lhs.m_limbs[i]) - rhs.m_limbs[i] - borrow;
+                lhs.m_limbs[i] = static_cast<std::uint64_t>(difference);
+                borrow = static_cast<std::uint64_t>(difference >> 64) & 1;
+            }
+        }
+        lhs.normalize();
+        return lhs;
+    }
+
+    friend constexpr WideInt operator*(const WideInt& lhs, const WideInt& rhs) noexcept
+    {
+        WideInt product;
+        if constexpr (limbCount == 1) {
+            product.m_limbs[0] = lhs.m_limbs[0] * rhs.m_limbs[0];
+        } else if constexpr (limbCount == 2) {
+            product.setWide(lhs.wide() * rhs.wide());
+        } else {
+            // The low limbs of the schoolbook product, the same for both signs.
+            for (std::size_t i = 0; i < limbCount; ++i) {
+                std::uint64_t carry = 0;
+                for (std::size_t j = 0; i + j < limbCount; ++j) {
+                    detail::Uint128 term =
+                        detail::Uint128(lhs.m_limbs[i]) * rhs.m_limbs[j] + product.m_limbs[i + j] + carry;
+                    product.m_limbs[i + j] = static_cast<std::uint64_t>(term);
+                    carry = static_cast<std::uint64_t>(term >> 64);
+                }
+            }
+        }
+        product.normalize();
+        return product;
+    }
+
+    // Truncates toward zero. The remainder has the sign of the dividend.
+    static constexpr std::pair<WideInt, WideInt> divide(const WideInt& lhs, const WideInt& rhs);
+
+    friend constexpr WideInt operator/(const WideInt& lhs, const WideInt& rhs) { return divide(lhs, rhs).first; }
+    friend constexpr WideInt operator%(const WideInt& lhs, const WideInt& rhs) { return divide(lhs, rhs).second; }
+
+    friend constexpr WideInt operator-(const WideInt& value) noexcept { return WideInt() - value; }
+
+    friend constexpr WideInt operator~(WideInt value) noexcept
+    {
+        for (auto& limb : value.m_limbs) limb = ~limb;
+        value.normalize();
+        return value;
+    }
+
+    friend constexpr WideInt operator<<(WideInt value, unsigned count) noexcept
+    {
+        if (count >= width) return WideInt();
+        if constexpr (limbCount == 1) {
+            value.m_limbs[0] <<= count;
+        } else if constexpr (limbCount == 2) {
+            value.setWide(value.wide() << count);
+        } else {
+            value.m_limbs = shiftLeft(value.m_limbs, count);
+        }
+        value.normalize();
+        return value;
+    }
+
+    // Arithmetic for signed integers, logical for unsigned ones.
+    friend constexpr WideInt operator>>(WideInt value, unsigned count) noexcept
+    {
+        if (count >= width) return value.isNegative() ? WideInt(-1) : WideInt();
+        if constexpr (limbCount == 1) {
+            if constexpr (isSigned) {
+                value.m_limbs[0] = static_cast<std::uint64_t>(static_cast<std::int64_t>(value.m_limbs[0]) >> count);
+            } else {
+                value.m_limbs[0] >>= count;
+            }
+        } else if constexpr (limbCount == 2) {
+            if constexpr (isSigned) {
+                value.setWide(static_cast<detail::Uint128>(static_cast<detail::Int128>(value.wide()) >> count));
+            } else {
+                value.setWide(value.wide() >> count);
+            }
+        } else {
+            value.m_limbs = shiftRight(value.m_limbs, count, value.isNegative() ? ~std::uint64_t(0) : 0);
+        }
+        return value;
+    }
+
+    // The >>> operator: shifts zeros into the width bits, whatever the signedness.
+    constexpr WideInt shiftRightLogic(unsigned count) const noexcept
+    {
+        if (count >= width) return WideInt();
+        Limbs pattern = m_limbs;
+        if constexpr (width % 64 != 0) {
+            pattern.back() &= (std::uint64_t(1) << (width % 64)) - 1;
+        }
+        if constexpr (limbCount == 1) {
+            pattern[0] >>= count;
+        } else {
+            pattern = shiftRight(pattern, count, 0);
+        }
+        return fromLimbs(pattern);
+    }
+
+    friend constexpr bool operator==(const WideInt&, const WideInt&) noexcept = default;
+
+    friend constexpr std::strong_ordering operator<=>(const WideInt& lhs, const WideInt& rhs) noexcept
+    {
+        if constexpr (isSigned) {
+            auto top = static_cast<std::int64_t>(lhs.m_limbs.back()) <=> static_cast<std::int64_t>(rhs.m_limbs.back());
+            if (top != 0) return top;
+        } else if (lhs.m_limbs.back() != rhs.m_limbs.back()) {
+            return lhs.m_limbs.back() <=> rhs.m_limbs.back();
+        }
+        for (std::size_t i = limbCount - 1; i-- > 0;) {
+            if (lhs.m_limbs[i] != rhs.m_limbs[i]) return lhs.m_limbs[i] <=> rhs.m_limbs[i];
+        }
+        return std::strong_ordering::equal;
+    }
+
+private:
+    // Restores the bits above width from the sign bit, or clears them.
+    constexpr void normalize() noexcept
+    {
+        if constexpr (width % 64 != 0) {
+            constexpr unsigned unused = 64 - width % 64;
+            if constexpr (isSigned) {
+                m_limbs.back() = static_cast<std::uint64_t>(static_cast<std::int64_t>(m_limbs.back() << unused) >> unused);
+            } else {
+                m_limbs.back() &= ~std::uint64_t(0) >> unused;
+            }
+        }
+    }
+
+    constexpr detail::Uint128 wide() const noexcept
+        requires(limbCount == 2)
+    {
+        return detail::Uint128(m_limbs[1]) << 64 | m_limbs[0];
+    }
+
+    constexpr void setWide(detail::Uint128 value) noexcept
+        requires(limbCount == 2)
+    {
+        m_limbs[0] = static_cast<std::uint64_t>(value);
+        m_limbs[1] = static_cast<std::uint64_t>(value >> 64);
+    }
+
+    // The absolute value in all the limbs, where even the one of min() fits.
+    constexpr Limbs magnitude() const noexcept
+    {
+        if (!isNegative()) return m_limbs;
+        Limbs result{};
+        std::uint64_t carry = 1;
+        for (std::size_t i = 0; i < limbCount; ++i) {
+            result[i] = ~m_limbs[i] + carry;
+            carry = carry && result[i] == 0;
+        }
+        return result;
+    }
+
+    static constexpr Limbs shiftLeft(const Limbs& limbs, unsigned count) noexcept
+    {
+        Limbs result{};
+        std::size_t offset = count / 64;
+        unsigned shift = count % 64;
+        for (std::size_t i = offset; i < limbCount; ++i) {
+            result[i] = limbs[i - offset] << shift;
+            if (shift != 0 && i > offset) result[i] |= limbs[i - offset - 1] >> (64 - shift);
+        }
+        return result;
+    }
+
+    static constexpr Limbs shiftRight(const Limbs& limbs, unsigned count, std::uint64_t fill) noexcept
+    {
+        auto at = [&](std::size_t i) { return i < limbCount ? limbs[i] : fill; };
+        Limbs result{};
+        std::size_t offset = count / 64;
+        unsigned shift = count % 64;
+        for (std::size_t i = 0; i < limbCount; ++i) {
+            result[i] = at(i + offset) >> shift;
+            if (shift != 0) result[i] |= at(i + offset + 1) << (64 - shift);
+        }
+        return result;
+    }
+
+    // The number of bits up to the highest set one.
+    static constexpr unsigned significantBits(const Limbs& limbs) noexcept
+    {
+        for (std::size_t i = limbCount; i-- > 0;) {
+            if (limbs[i] != 0) return static_cast<unsigned>(64 * i + 64 - std::countl_zero(limbs[i]));
+        }
+        return 0;
+    }
+
+    // Unsigned division of the full limbs, Knuth's algorithm D on 64-bit digits.
+    static constexpr void divideLimbs(const Limbs& u, const Limbs& v, Limbs& quotient, Limbs& remainder) noexcept;
+
+    Limbs m_limbs{};
+};
+
+template <unsigned width, bool isSigned>
+constexpr auto WideInt<width, isSigned>::divide(const WideInt& lhs, const WideInt& rhs) -> std::pair<WideInt, WideInt>
+{
+    if (rhs.isZero()) {
+        throw std::domain_error("Division by zero.");
+    }
+    // The one quotient that wraps around, and a trap on native integers.
+    if (isSigned && rhs == WideInt(-1)) {
+        return { -lhs, WideInt() };
+    }
+    WideInt quotient;
+    WideInt remainder;
+    if constexpr (limbCount == 1) {
+        if constexpr (isSigned) {
+            auto a = static_cast<std::int64_t>(lhs.m_limbs[0]);
+            auto b = static_cast<std::int64_t>(rhs.m_limbs[0]);
+            quotient.m_limbs[0] = static_cast<std::uint64_t>(a / b);
+            remainder.m_limbs[0] = static_cast<std::uint64_t>(a % b);
+        } else {
+            quotient.m_limbs[0] = lhs.m_limbs[0] / rhs.m_limbs[0];
+            remainder.m_limbs[0] = lhs.m_limbs[0] % rhs.m_limbs[0];
+        }
+    } else if constexpr (limbCount == 2) {
+        if constexpr (isSigned) {
+            auto a = static_cast<detail::Int128>(lhs.wide());
+            auto b = static_cast<detail::Int128>(rhs.wide());
+            quotient.setWide(static_cast<detail::Uint128>(a / b));
+            remainder.setWide(static_cast<detail::Uint128>(a % b));
+        } else {
+            quotient.setWide(lhs.wide() / rhs.wide());
+            remainder.setWide(lhs.wide() % rhs.wide());
+        }
+    } else {
+        // Divide the magnitudes, they fit the limbs even for min().
+        bool negativeLhs = lhs.isNegative();
+        bool negativeRhs = rhs.isNegative();
+        divideLimbs(lhs.magnitude(), rhs.magnitude(), quotient.m_limbs, remainder.m_limbs);
+        if (negativeLhs != negativeRhs) quotient = -quotient;
+        if (negativeLhs) remainder = -remainder;
+    }
+    quotient.normalize();
+    remainder.normalize();
+    return { quotient, remainder };
+}
+
+template <unsigned width, bool isSigned>
+constexpr void WideInt<width, isSigned>::divideLimbs(const Limbs& u, const Limbs& v, Limbs& quotient, Limbs& remainder) noexcept
+{
+    using detail::Uint128;
+    quotient = {};
+    remainder = {};
+    std::size_t n = limbCount;
+    while (v[n - 1] == 0) --n;
+    std::size_t m = limbCount;
+    while (m > 0 && u[m - 1] == 0) --m;
+    if (m < n) {
+        remainder = u;
+        return;
+    }
+    if (n == 1) {
+        Uint128 rest = 0;
+        for (std::size_t i = m; i-- > 0;) {
+            Uint128 current = rest << 64 | u[i];
+            quotient[i] = static_cast<std::uint64_t>(current / v[0]);
+            rest = current % v[0];
+        }
+        remainder[0] = static_cast<std::uint64_t>(rest);
+        return;
+    }
+    // Normalize so that the top digit of the divisor has its high bit set.
+    unsigned shift = static_cast<unsigned>(std::countl_zero(v[n - 1]));
+    auto high = [shift](std::uint64_t digit) { return shift == 0 ? 0 : digit >> (64 - shift); };
+    std::array<std::uint64_t, limbCount> vn{};
+    std::array<std::uint64_t, limbCount + 1> un{};
+    for (std::size_t i = n; i-- > 1;) vn[i] = v[i] << shift | high(v[i - 1]);
+    vn[0] = v[0] << shift;
+    un[m] = high(u[m - 1]);
+    for (std::size_t i = m; i-- > 1;) un[i] = u[i] << shift | high(u[i - 1]);
+    un[0] = u[0] << shift;
+    for (std::size_t j = m - n + 1; j-- > 0;) {
+        Uint128 numerator = Uint128(un[j + n]) << 64 | un[j + n - 1];
+        Uint128 estimate = numerator / vn[n - 1];
+        Uint128 rest = numerator % vn[n - 1];
+        while (estimate >> 64 || estimate * vn[n - 2] > (rest << 64 | un[j + n - 2])) {
+            --estimate;
+            rest += vn[n - 1];
+            if (rest >> 64) break;
+        }
+        // Subtract estimate * vn from the current digits.
+        std::uint64_t carry = 0;
+        std::uint64_t borrow = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            Uint128 product = estimate * vn[i] + carry;
+            carry = static_cast<std::uint64_t>(product >> 64);
+            auto digit = static_cast<std::uint64_t>(product);
+            Uint128 difference = Uint128(un[i + j]) - digit - borrow;
+            un[i + j] = static_cast<std::uint64_t>(difference);
+            borrow = static_cast<std::uint64_t>(difference >> 64) & 1;
+        }
+        Uint128 subtracted = Uint128(carry) + borrow;
+        bool negative = subtracted > un[j + n];
+        un[j + n] -= static_cast<std::uint64_t>(subtracted);
+        quotient[j] = static_cast<std::uint64_t>(estimate);
+        // The estimate was one too large: add the divisor back.
+        if (negative) {
+            --quotient[j];
+            std::uint64_t sumCarry = 0;
+            for (std::size_t i = 0; i < n; ++i) {
+                Uint128 sum = Uint128(un[i + j]) + vn[i] + sumCarry;
+                un[i + j] = static_cast<std::uint64_t>(sum);
+                sumCarry = static_cast<std::uint64_t>(sum >> 64);
+            }
+            un[j + n] += sumCarry;
+        }
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+        remainder[i] = un[i] >> shift | (shift == 0 ? 0 : un[i + 1] << (64 - shift));
+    }
+}
+
+template <unsigned width, bool isSigned>
+constexpr auto WideInt<width, isSigned>::parse(std::string_view text) noexcept -> std::optional<WideInt>
+{
+    bool negative = !text.empty() && text[0] == '-';
+    if (negative) text.remove_prefix(1);
+    unsigned base = 10;
+    if (text.size() > 2 && text[0] == '0' && !negative) {
+        base = text[1] == 'x' ? 16 : text[1] == 'o' ? 8 : text[1] == 'b' ? 2 : 0;
+        if (base == 0) return std::nullopt;
+        text.remove_prefix(2);
+    }
+    if (text.empty()) return std::nullopt;
+    Limbs magnitude{};
+    for (char c : text) {
+        unsigned digit = c >= '0' && c <= '9' ? c - '0'
+            : c >= 'a' && c <= 'f'            ? c - 'a' + 10
+            : c >= 'A' && c <= 'F'            ? c - 'A' + 10
+                                              : base;
+        if (digit >= base) return std::nullopt;
+        std::uint64_t carry = digit;
+        for (auto& limb : magnitude) {
+            detail::Uint128 term = detail::Uint128(limb) * base + carry;
+            limb = static_cast<std::uint64_t>(term);
+            carry = static_cast<std::uint64_t>(term >> 64);
+        }
+        if (carry != 0) return std::nullopt;
+    }
+    unsigned used = significantBits(magnitude);
+    WideInt value = fromLimbs(magnitude);
+    if (!negative) {
+        if (used > width - isSigned) return std::nullopt;
+        return value;
+    }
+    // Only min() uses the sign bit.
+    if (used == 0) return value;
+    if (!isSigned || used > width || (used == width && value != min())) return std::nullopt;
+    return -value;
+}
+
+template <unsigned width, bool isSigned>
+constexpr auto WideInt<width, isSigned>::toString() const -> std::string
+{
+    if (isZero()) return "0";
+    // Nineteen decimal digits at a time.
+    constexpr std::uint64_t chunk = 10'000'000'000'000'000'000u;
+    Limbs magnitude = this->magnitude();
+    std::string digits;
+    bool more = true;
+    while (more) {
+        detail::Uint128 rest = 0;
+        more = false;
+        for (std::size_t i = limbCount; i-- > 0;) {
+            detail::Uint128 current = rest << 64 | magnitude[i];
+            magnitude[i] = static_cast<std::uint64_t>(current / chunk);
+            rest = current % chunk;
+            more = more || magnitude[i] != 0;
+        }
+        auto group = static_cast<std::uint64_t>(rest);
+        for (int i = 0; i < 19 && (more || group != 0); ++i) {
+            digits += static_cast<char>('0' + group % 10);
+            group /= 10;
+        }
+    }
+    if (isNegative()) digits += '-';
+    return { digits.rbegin(), digits.rend() };
+}
+
+// The width of an integer type, 0 for other types.
+constexpr unsigned integerWidth(BasicExpressionType type) noexcept
+{
+    auto index = static_cast<unsigned>(type) - static_cast<unsigned>(BasicExpressionType::Uint8);
+    return index < 64 ? (index % 32 + 1) * 8 : 0;
+}
+
+constexpr bool isSignedInteger(BasicExpressionType type) noexcept
+{
+    return type >= BasicExpressionType::Int8 && type <= BasicExpressionType::Int256;
+}
+
+template <BasicExpressionType type>
+using WideIntOf = WideInt<integerWidth(type), isSignedInteger(type)>;
+
+// Calls visitor.template operator()<WideIntOf<type>>() for an integer type, through a jump table.
+template <typename Visitor>
+constexpr decltype(auto) visitIntegerType(BasicExpressionType type, Visitor&& visitor)
+{
+    using Result = decltype(visitor.template operator()<WideInt<8, false>>());
+    if (integerWidth(type) == 0) {
+        throw std::logic_error("visitIntegerType: not an integer type.");
+    }
+    constexpr auto table = []<std::size_t... indices>(std::index_sequence<indices...>) {
+        return std::array<Result (*)(Visitor&), sizeof...(indices)>{ +[](Visitor& visitor) -> Result {
+            constexpr auto integer =
+                static_cast<BasicExpressionType>(static_cast<std::size_t>(BasicExpressionType::Uint8) + indices);
+            return visitor.template operator()<WideIntOf<integer>>();
+        }... };
+    }(std::make_index_sequence<64>());
+    return table[static_cast<std::size_t>(type) - static_cast<std::size_t>(BasicExpressionType::Uint8)](visitor);
+}
+
+} // namespace frontend
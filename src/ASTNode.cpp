@@ -0,0 +1,24 @@
+#include "ASTNode.hpp"
+
+#include "Visitor.hpp"
+
+void frontend::NodeDeleter::operator()(ASTNode* node) const noexcept
+{
+    if (node->inArena()) {
+        return;
+    }
+    PendingNodes pending;
+    while (true) {
+        // Detaches the children, so that deleting this node does not recurse.
+        forEachChildSlot(*node, [&](auto& child) {
+            if (child && !child->inArena()) {
+                pending.push(child.release());
+            }
+        });
+        delete node;
+        if (pending.empty()) {
+            return;
+        }
+        node = pending.pop();
+    }
+}
@@ -0,0 +1,128 @@
+#include "Arena.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <new>
+#include <utility>
+
+#include <sys/mman.h>
+
+namespace {
+
+constexpr std::size_t hugePageSize = 2 * 1024 * 1024;
+
+constexpr std::size_t alignUp(std::size_t value, std::size_t alignment) noexcept
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+} // namespace
+
+frontend::Arena::Arena(Options options) noexcept
+    : m_options(options)
+    , m_chunks(nullptr)
+    , m_cursor(nullptr)
+    , m_end(nullptr)
+    , m_nextChunkSize(options.chunkSize)
+    , m_allocatedBytes(0)
+    , m_reservedBytes(0)
+{
+}
+
+frontend::Arena::~Arena()
+{
+    while (m_chunks) {
+        freeChunk(std::exchange(m_chunks, m_chunks->next));
+    }
+}
+
+void frontend::Arena::reset() noexcept
+{
+    if (!m_chunks) return;
+    // The newest chunk is the largest, keep it.
+    while (m_chunks->next) {
+        freeChunk(std::exchange(m_chunks->next, m_chunks->next->next));
+    }
+    m_reservedBytes = m_chunks->size;
+    m_cursor = reinterpret_cast<char*>(m_chunks) + sizeof(Chunk);
+    m_end = reinterpret_cast<char*>(m_chunks) + m_chunks->size;
+    m_allocatedBytes = 0;
+}
+
+void frontend::Arena::adopt(Arena&& other) noexcept
+{
+    if (!other.m_chunks) return;
+    Chunk* last = other.m_chunks;
+    while (last->next) {
+        last = last->next;
+    }
+    if (m_chunks) {
+        // Behind the current chunk, which keeps serving allocations.
+        last->next = m_chunks->next;
+        m_chunks->next = other.m_chunks;
+    } else {
+        m_chunks = other.m_chunks;
+        m_cursor = other.m_cursor;
+        m_end = other.m_end;
+    }
+    m_allocatedBytes += other.m_allocatedBytes;
+    m_reservedBytes += other.m_reservedBytes;
+    other.m_chunks = nullptr;
+    other.m_cursor = nullptr;
+    other.m_end = nullptr;
+    other.m_nextChunkSize = other.m_options.chunkSize;
+    other.m_allocatedBytes = 0;
+    other.m_reservedBytes = 0;
+}
+
+void* frontend::Arena::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+    auto address = alignUp(reinterpret_cast<std::uintptr_t>(m_cursor), alignment);
+    if (!m_cursor || address + bytes > reinterpret_cast<std::uintptr_t>(m_end)) {
+        addChunk(bytes + alignment);
+        address = alignUp(reinterpret_cast<std::uintptr_t>(m_cursor), alignment);
+    }
+    m_cursor = reinterpret_cast<char*>(address + bytes);
+    m_allocatedBytes += bytes;
+    return reinterpret_cast<void*>(address);
+}
+
+void frontend::Arena::addChunk(std::size_t minimumSize)
+{
+    std::size_t size = std::max(m_nextChunkSize, minimumSize + sizeof(Chunk));
+    m_nextChunkSize = std::min(m_nextChunkSize * 2, std::max(m_options.maxChunkSize, m_options.chunkSize));
+    void* memory = nullptr;
+    bool mapped = false;
+    if (m_options.hugePages) {
+        size = alignUp(size, hugePageSize);
+        memory = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (memory == MAP_FAILED) {
+            // No reserved huge pages, ask for transparent ones instead.
+            memory = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (memory == MAP_FAILED) {
+                throw std::bad_alloc();
+            }
+            ::madvise(memory, size, MADV_HUGEPAGE);
+        }
+        mapped = true;
+    } else {
+        memory = ::operator new(size);
+    }
+    auto* chunk = static_cast<Chunk*>(memory);
+    chunk->next = m_chunks;
+    chunk->size = size;
+    chunk->mapped = mapped;
+    m_chunks = chunk;
+    m_reservedBytes += size;
+    m_cursor = static_cast<char*>(memory) + sizeof(Chunk);
+    m_end = static_cast<char*>(memory) + size;
+}
+
+void frontend::Arena::freeChunk(Chunk* chunk) noexcept
+{
+    if (chunk->mapped) {
+        ::munmap(chunk, chunk->size);
+    } else {
+        ::operator delete(chunk);
+    }
+}
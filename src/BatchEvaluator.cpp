@@ -0,0 +1,459 @@
+#include "BatchEvaluator.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define BACKEND_BATCH_X86 1
+#include <immintrin.h>
+#endif
+
+namespace backend {
+
+struct BatchKernels {
+    BatchEvaluator::BinaryKernel add;
+    BatchEvaluator::BinaryKernel subtract;
+    BatchEvaluator::BinaryKernel multiply;
+    BatchEvaluator::BinaryKernel shiftLeft;
+    BatchEvaluator::BinaryKernel shiftRight;
+    BatchEvaluator::BinaryKernel shiftRightLogic;
+    BatchEvaluator::BinaryKernel less;
+    BatchEvaluator::BinaryKernel lessEquals;
+    BatchEvaluator::BinaryKernel greater;
+    BatchEvaluator::BinaryKernel greaterEquals;
+    BatchEvaluator::BinaryKernel equals;
+    BatchEvaluator::BinaryKernel notEquals;
+    BatchEvaluator::UnaryKernel copy;
+    BatchEvaluator::UnaryKernel negate;
+    BatchEvaluator::UnaryKernel bitwiseNot;
+    BatchEvaluator::UnaryKernel isZero;
+    // Packs the low bits of n values into (n + 63) / 64 words.
+    void (*pack)(std::uint64_t*, const std::int64_t*, std::size_t) noexcept;
+};
+
+} // namespace backend
+
+namespace {
+
+using backend::BatchEvaluator;
+using backend::BatchKernels;
+using backend::Opcode;
+
+// The operators on one row, wrapping around like Integer. Shift counts beyond 63,
+// negative ones included, shift every bit out.
+std::int64_t add(std::int64_t a, std::int64_t b) noexcept
+{
+    return static_cast<std::int64_t>(static_cast<std::uint64_t>(a) + static_cast<std::uint64_t>(b));
+}
+std::int64_t subtract(std::int64_t a, std::int64_t b) noexcept
+{
+    return static_cast<std::int64_t>(static_cast<std::uint64_t>(a) - static_cast<std::uint64_t>(b));
+}
+std::int64_t multiply(std::int64_t a, std::int64_t b) noexcept
+{
+    return static_cast<std::int64_t>(static_cast<std::uint64_t>(a) * static_cast<std::uint64_t>(b));
+}
+std::int64_t shiftLeft(std::int64_t a, std::int64_t b) noexcept
+{
+    auto count = static_cast<std::uint64_t>(b);
+    return count < 64 ? static_cast<std::int64_t>(static_cast<std::uint64_t>(a) << count) : 0;
+}
+std::int64_t shiftRight(std::int64_t a, std::int64_t b) noexcept
+{
+    return a >> std::min<std::uint64_t>(static_cast<std::uint64_t>(b), 63);
+}
+std::int64_t shiftRightLogic(std::int64_t a, std::int64_t b) noexcept
+{
+    auto count = static_cast<std::uint64_t>(b);
+    return count < 64 ? static_cast<std::int64_t>(static_cast<std::uint64_t>(a) >> count) : 0;
+}
+std::int64_t less(std::int64_t a, std::int64_t b) noexcept { return a < b; }
+std::int64_t lessEquals(std::int64_t a, std::int64_t b) noexcept { return a <= b; }
+std::int64_t greater(std::int64_t a, std::int64_t b) noexcept { return a > b; }
+std::int64_t greaterEquals(std::int64_t a, std::int64_t b) noexcept { return a >= b; }
+std::int64_t equals(std::int64_t a, std::int64_t b) noexcept { return a == b; }
+std::int64_t notEquals(std::int64_t a, std::int64_t b) noexcept { return a != b; }
+
+std::int64_t copy(std::int64_t a) noexcept { return a; }
+std::int64_t negate(std::int64_t a) noexcept { return subtract(0, a); }
+std::int64_t bitwiseNot(std::int64_t a) noexcept { return ~a; }
+std::int64_t isZero(std::int64_t a) noexcept { return a == 0; }
+
+template <std::int64_t (*op)(std::int64_t, std::int64_t) noexcept>
+void binaryScalar(std::int64_t* result, const std::int64_t* a, const std::int64_t* b, std::size_t n) noexcept
+{
+    for (std::size_t i = 0; i < n; ++i) result[i] = op(a[i], b[i]);
+}
+
+template <std::int64_t (*op)(std::int64_t) noexcept>
+void unaryScalar(std::int64_t* result, const std::int64_t* a, std::size_t n) noexcept
+{
+    for (std::size_t i = 0; i < n; ++i) result[i] = op(a[i]);
+}
+
+void packScalar(std::uint64_t* words, const std::int64_t* a, std::size_t n) noexcept
+{
+    for (std::size_t begin = 0; begin < n; begin += 64) {
+        std::size_t count = std::min<std::size_t>(64, n - begin);
+        std::uint64_t word = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            word |= static_cast<std::uint64_t>(a[begin + i] & 1) << i;
+        }
+        words[begin / 64] = word;
+    }
+}
+
+constexpr BatchKernels scalarKernels = {
+    binaryScalar<add>,
+    binaryScalar<subtract>,
+    binaryScalar<multiply>,
+    binaryScalar<shiftLeft>,
+    binaryScalar<shiftRight>,
+    binaryScalar<shiftRightLogic>,
+    binaryScalar<less>,
+    binaryScalar<lessEquals>,
+    binaryScalar<greater>,
+    binaryScalar<greaterEquals>,
+    binaryScalar<equals>,
+    binaryScalar<notEquals>,
+    unaryScalar<copy>,
+    unaryScalar<negate>,
+    unaryScalar<bitwiseNot>,
+    unaryScalar<isZero>,
+    packScalar
+};
+
+#ifdef BACKEND_BATCH_X86
+
+// Four rows per vector. AVX2 lacks 64-bit multiplication and arithmetic right
+// shifts, they are built from 32-bit products and logical shifts. Its variable
+// shifts already give 0 for counts beyond 63. Comparisons give 0 or 1.
+
+#define BACKEND_AVX2 __attribute__((target("avx2")))
+
+BACKEND_AVX2 __m256i addAvx2(__m256i a, __m256i b) noexcept { return _mm256_add_epi64(a, b); }
+BACKEND_AVX2 __m256i subtractAvx2(__m256i a, __m256i b) noexcept { return _mm256_sub_epi64(a, b); }
+
+// The low 64 bits of a * b: lo(a) * lo(b) + (lo(a) * hi(b) + hi(a) * lo(b)) << 32.
+BACKEND_AVX2 __m256i multiplyAvx2(__m256i a, __m256i b) noexcept
+{
+    __m256i cross = _mm256_add_epi64(_mm256_mul_epu32(a, _mm256_srli_epi64(b, 32)),
+        _mm256_mul_epu32(_mm256_srli_epi64(a, 32), b));
+    return _mm256_add_epi64(_mm256_mul_epu32(a, b), _mm256_slli_epi64(cross, 32));
+}
+
+BACKEND_AVX2 __m256i shiftLeftAvx2(__m256i a, __m256i b) noexcept { return _mm256_sllv_epi64(a, b); }
+
+// Flipping negative values makes the shift bring in their sign.
+BACKEND_AVX2 __m256i shiftRightAvx2(__m256i a, __m256i b) noexcept
+{
+    __m256i sign = _mm256_cmpgt_epi64(_mm256_setzero_si256(), a);
+    return _mm256_xor_si256(_mm256_srlv_epi64(_mm256_xor_si256(a, sign), b), sign);
+}
+
+BACKEND_AVX2 __m256i shiftRightLogicAvx2(__m256i a, __m256i b) noexcept { return _mm256_srlv_epi64(a, b); }
+
+// All ones to 1.
+BACKEND_AVX2 __m256i truth(__m256i mask) noexcept { return _mm256_srli_epi64(mask, 63); }
+// All ones to 0, 0 to 1.
+BACKEND_AVX2 __m256i falsity(__m256i mask) noexcept { return _mm256_add_epi64(mask, _mm256_set1_epi64x(1)); }
+
+BACKEND_AVX2 __m256i lessAvx2(__m256i a, __m256i b) noexcept { return truth(_mm256_cmpgt_epi64(b, a)); }
+BACKEND_AVX2 __m256i lessEqualsAvx2(__m256i a, __m256i b) noexcept { return falsity(_mm256_cmpgt_epi64(a, b)); }
+BACKEND_AVX2 __m256i greaterAvx2(__m256i a, __m256i b) noexcept { return truth(_mm256_cmpgt_epi64(a, b)); }
+BACKEND_AVX2 __m256i greaterEqualsAvx2(__m256i a, __m256i b) noexcept { return falsity(_mm256_cmpgt_epi64(b, a)); }
+BACKEND_AVX2 __m256i equalsAvx2(__m256i a, __m256i b) noexcept { return truth(_mm256_cmpeq_epi64(a, b)); }
+BACKEND_AVX2 __m256i notEqualsAvx2(__m256i a, __m256i b) noexcept { return falsity(_mm256_cmpeq_epi64(a, b)); }
+
+BACKEND_AVX2 __m256i negateAvx2(__m256i a) noexcept { return _mm256_sub_epi64(_mm256_setzero_si256(), a); }
+BACKEND_AVX2 __m256i bitwiseNotAvx2(__m256i a) noexcept { return _mm256_xor_si256(a, _mm256_set1_epi64x(-1)); }
+BACKEND_AVX2 __m256i isZeroAvx2(__m256i a) noexcept { return truth(_mm256_cmpeq_epi64(a, _mm256_setzero_si256())); }
+
+BACKEND_AVX2 __m256i load(const std::int64_t* p) noexcept
+{
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+}
+
+BACKEND_AVX2 void store(std::int64_t* p, __m256i v) noexcept
+{
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v);
+}
+
+// The last rows of a block take the scalar operator.
+template <__m256i (*vector)(__m256i, __m256i) noexcept, std::int64_t (*op)(std::int64_t, std::int64_t) noexcept>
+BACKEND_AVX2 void binaryAvx2(std::int64_t* result, const std::int64_t* a, const std::int64_t* b, std::size_t n) noexcept
+{
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) store(result + i, vector(load(a + i), load(b + i)));
+    for (; i < n; ++i) result[i] = op(a[i], b[i]);
+}
+
+template <__m256i (*vector)(__m256i) noexcept, std::int64_t (*op)(std::int64_t) noexcept>
+BACKEND_AVX2 void unaryAvx2(std::int64_t* result, const std::int64_t* a, std::size_t n) noexcept
+{
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) store(result + i, vector(load(a + i)));
+    for (; i < n; ++i) result[i] = op(a[i]);
+}
+
+BACKEND_AVX2 __m256i copyAvx2(__m256i a) noexcept { return a; }
+
+// Moves the low bit of each row to the sign bit and gathers four at a time.
+BACKEND_AVX2 void packAvx2(std::uint64_t* words, const std::int64_t* a, std::size_t n) noexcept
+{
+    std::size_t begin = 0;
+    for (; begin + 64 <= n; begin += 64) {
+        std::uint64_t word = 0;
+        for (std::size_t i = 0; i < 64; i += 4) {
+            __m256d signs = _mm256_castsi256_pd(_mm256_slli_epi64(load(a + begin + i), 63));
+            word |= static_cast<std::uint64_t>(_mm256_movemask_pd(signs)) << i;
+        }
+        words[begin / 64] = word;
+    }
+    if (begin < n) packScalar(words + begin / 64, a + begin, n - begin);
+}
+
+constexpr BatchKernels avx2Kernels = {
+    binaryAvx2<addAvx2, add>,
+    binaryAvx2<subtractAvx2, subtract>,
+    binaryAvx2<multiplyAvx2, multiply>,
+    binaryAvx2<shiftLeftAvx2, shiftLeft>,
+    binaryAvx2<shiftRightAvx2, shiftRight>,
+    binaryAvx2<shiftRightLogicAvx2, shiftRightLogic>,
+    binaryAvx2<lessAvx2, less>,
+    binaryAvx2<lessEqualsAvx2, lessEquals>,
+    binaryAvx2<greaterAvx2, greater>,
+    binaryAvx2<greaterEqualsAvx2, greaterEquals>,
+    binaryAvx2<equalsAvx2, equals>,
+    binaryAvx2<notEqualsAvx2, notEquals>,
+    unaryAvx2<copyAvx2, copy>,
+    unaryAvx2<negateAvx2, negate>,
+    unaryAvx2<bitwiseNotAvx2, bitwiseNot>,
+    unaryAvx2<isZeroAvx2, isZero>,
+    packAvx2
+};
+
+#undef BACKEND_AVX2
+
+#endif
+
+const BatchKernels& kernelsFor(frontend::scanner::Isa isa) noexcept
+{
+#ifdef BACKEND_BATCH_X86
+    if (isa == frontend::scanner::Isa::AVX2) return avx2Kernels;
+#endif
+    return scalarKernels;
+}
+
+// Division has no vector instruction. Integer division by -1 wraps around.
+template <bool remainder>
+void divide(std::int64_t* result, const std::int64_t* a, const std::int64_t* b, std::size_t n)
+{
+    for (std::size_t i = 0; i < n; ++i) {
+        if (b[i] == 0) throw std::domain_error("Division by zero.");
+        if (b[i] == -1) {
+            result[i] = remainder ? 0 : negate(a[i]);
+        } else {
+            result[i] = remainder ? a[i] % b[i] : a[i] / b[i];
+        }
+    }
+}
+
+frontend::NodeType nodeType(Opcode opcode) noexcept
+{
+    using frontend::NodeType;
+    switch (opcode) {
+        case Opcode::Add: return NodeType::Addition;
+        case Opcode::Subtract: return NodeType::Subtraction;
+        case Opcode::Multiply: return NodeType::Multiplication;
+        case Opcode::Divide: return NodeType::Division;
+        case Opcode::Remainder: return NodeType::Remainder;
+        case Opcode::ShiftLeft: return NodeType::ShiftLeft;
+        case Opcode::ShiftRight: return NodeType::ShiftRight;
+        case Opcode::ShiftRightLogic: return NodeType::ShiftRightLogic;
+        case Opcode::Less: return NodeType::LessThan;
+        case Opcode::LessEquals: return NodeType::LessEquals;
+        case Opcode::Greater: return NodeType::GreaterThan;
+        case Opcode::GreaterEquals: return NodeType::GreaterEquals;
+        case Opcode::Equals: return NodeType::Equals;
+        case Opcode::NotEquals: return NodeType::NotEquals;
+        case Opcode::Plus: return NodeType::Positive;
+        case Opcode::Negate: return NodeType::Negative;
+        case Opcode::Not: return NodeType::LogicalNegation;
+        default: return NodeType::BitwiseNot;
+    }
+}
+
+// A value of the kind of a register, to report type errors like evaluateBinary() does.
+backend::Value sample(bool boolean)
+{
+    return boolean ? backend::Value(true) : backend::Value(std::int64_t(1));
+}
+
+} // namespace
+
+backend::BatchEvaluator::BatchEvaluator(const frontend::Expression& expression, frontend::scanner::Isa isa)
+    : m_program(Compiler::compile(expression)), m_kernels(&kernelsFor(isa))
+{
+    std::uint32_t firstInput = m_program.firstInput();
+    m_firstTemporary = firstInput + static_cast<std::uint32_t>(m_program.inputs().size());
+    m_constants.resize(firstInput * blockRows);
+    for (std::uint32_t i = 0; i < firstInput; ++i) {
+        const Value& constant = m_program.constants()[i];
+        if (!constant.isInteger()) {
+            throw std::runtime_error("Only integer literals evaluate in batches, got " + constant.toString() + ".");
+        }
+        std::fill_n(m_constants.data() + i * blockRows, blockRows,
+            static_cast<std::int64_t>(constant.integerUnchecked().low()));
+    }
+    m_temporaries.resize((m_program.registerCount() - m_firstTemporary) * blockRows);
+
+    // Registers hold integers, or booleans as 0 and 1, known for every instruction.
+    std::vector<bool> boolean(m_program.registerCount(), false);
+    const BatchKernels& kernels = *m_kernels;
+    for (const Instruction& instruction : m_program.code()) {
+        Step step{};
+        step.result = instruction.a;
+        step.lhs = instruction.b;
+        step.rhs = instruction.c;
+        bool lhsBoolean = boolean[instruction.b];
+        bool rhsBoolean = boolean[instruction.c];
+        bool resultBoolean = false;
+        switch (instruction.opcode) {
+            case Opcode::Add:
+            case Opcode::Subtract:
+            case Opcode::Multiply:
+            case Opcode::Divide:
+            case Opcode::Remainder:
+            case Opcode::ShiftLeft:
+            case Opcode::ShiftRight:
+            case Opcode::ShiftRightLogic:
+            case Opcode::Less:
+            case Opcode::LessEquals:
+            case Opcode::Greater:
+            case Opcode::GreaterEquals:
+                if (lhsBoolean || rhsBoolean) {
+                    evaluateBinary(nodeType(instruction.opcode), sample(lhsBoolean), sample(rhsBoolean));
+                }
+                step.operation = Operation::Binary;
+                resultBoolean = instruction.opcode >= Opcode::Less;
+                break;
+            case Opcode::Equals:
+            case Opcode::NotEquals:
+                // Values of different kinds are never equal.
+                step.operation = lhsBoolean == rhsBoolean ? Operation::Binary : Operation::Fill;
+                step.value = instruction.opcode == Opcode::NotEquals;
+                resultBoolean = true;
+                break;
+            case Opcode::Plus:
+            case Opcode::Negate:
+            case Opcode::BitwiseNot:
+                if (lhsBoolean) evaluateUnary(nodeType(instruction.opcode), sample(true));
+                step.operation = Operation::Unary;
+                break;
+            case Opcode::Not:
+                step.operation = Operation::Unary;
+                resultBoolean = true;
+                break;
+            case Opcode::Move:
+                step.operation = Operation::Unary;
+                resultBoolean = lhsBoolean;
+                break;
+            case Opcode::Return:
+                m_result = instruction.a;
+                m_predicate = boolean[instruction.a];
+                continue;
+            default:
+                throw std::runtime_error("Arrays, members, calls and increments do not evaluate in batches.");
+        }
+        switch (instruction.opcode) {
+            case Opcode::Add: step.binary = kernels.add; break;
+            case Opcode::Subtract: step.binary = kernels.subtract; break;
+            case Opcode::Multiply: step.binary = kernels.multiply; break;
+            case Opcode::Divide: step.operation = Operation::Divide; break;
+            case Opcode::Remainder: step.operation = Operation::Remainder; break;
+            case Opcode::ShiftLeft: step.binary = kernels.shiftLeft; break;
+            case Opcode::ShiftRight: step.binary = kernels.shiftRight; break;
+            case Opcode::ShiftRightLogic: step.binary = kernels.shiftRightLogic; break;
+            case Opcode::Less: step.binary = kernels.less; break;
+            case Opcode::LessEquals: step.binary = kernels.lessEquals; break;
+            case Opcode::Greater: step.binary = kernels.greater; break;
+            case Opcode::GreaterEquals: step.binary = kernels.greaterEquals; break;
+            case Opcode::Equals: step.binary = kernels.equals; break;
+            case Opcode::NotEquals: step.binary = kernels.notEquals; break;
+            case Opcode::Negate: step.unary = kernels.negate; break;
+            case Opcode::BitwiseNot: step.unary = kernels.bitwiseNot; break;
+            case Opcode::Not: step.unary = kernels.isZero; break;
+            default: step.unary = kernels.copy; break;
+        }
+        // Without increments, only temporaries are written.
+        if (step.result < m_firstTemporary) {
+            throw std::logic_error("BatchEvaluator: an instruction writes to an input.");
+        }
+        boolean[instruction.a] = resultBoolean;
+        m_steps.push_back(step);
+    }
+}
+
+template <typename Output>
+auto backend::BatchEvaluator::run(std::span<const std::span<const std::int64_t>> columns, std::size_t rows,
+    Output&& output) -> void
+{
+    if (columns.size() != inputs().size()) {
+        throw std::logic_error("BatchEvaluator: expected " + std::to_string(inputs().size()) + " columns, got " +
+            std::to_string(columns.size()) + ".");
+    }
+    for (const auto& column : columns) {
+        if (column.size() != rows) {
+            throw std::logic_error("BatchEvaluator: a column does not hold " + std::to_string(rows) + " rows.");
+        }
+    }
+    std::uint32_t firstInput = m_program.firstInput();
+    for (std::size_t offset = 0; offset < rows; offset += blockRows) {
+        std::size_t count = std::min(blockRows, rows - offset);
+        auto operand = [&](std::uint32_t reg) -> const std::int64_t* {
+            if (reg < firstInput) return m_constants.data() + reg * blockRows;
+            if (reg < m_firstTemporary) return columns[reg - firstInput].data() + offset;
+            return m_temporaries.data() + (reg - m_firstTemporary) * blockRows;
+        };
+        for (const Step& step : m_steps) {
+            std::int64_t* result = m_temporaries.data() + (step.result - m_firstTemporary) * blockRows;
+            switch (step.operation) {
+                case Operation::Binary: step.binary(result, operand(step.lhs), operand(step.rhs), count); break;
+                case Operation::Unary: step.unary(result, operand(step.lhs), count); break;
+                case Operation::Divide: divide<false>(result, operand(step.lhs), operand(step.rhs), count); break;
+                case Operation::Remainder: divide<true>(result, operand(step.lhs), operand(step.rhs), count); break;
+                case Operation::Fill: std::fill_n(result, count, step.value); break;
+            }
+        }
+        output(operand(m_result), offset, count);
+    }
+}
+
+auto backend::BatchEvaluator::evaluate(std::span<const std::span<const std::int64_t>> columns,
+    std::span<std::int64_t> result) -> void
+{
+    if (m_predicate) {
+        throw std::logic_error("BatchEvaluator: the expression gives booleans, use select().");
+    }
+    run(columns, result.size(), [&](const std::int64_t* values, std::size_t offset, std::size_t count) {
+        std::copy_n(values, count, result.data() + offset);
+    });
+}
+
+auto backend::BatchEvaluator::select(std::span<const std::span<const std::int64_t>> columns, std::size_t rows,
+    std::span<std::uint64_t> selection) -> void
+{
+    if (!m_predicate) {
+        throw std::logic_error("BatchEvaluator: the expression gives integers, use evaluate().");
+    }
+    if (selection.size() < (rows + 63) / 64) {
+        throw std::logic_error("BatchEvaluator: the selection holds fewer than " + std::to_string(rows) + " bits.");
+    }
+    // Blocks start at multiples of 64 rows.
+    static_assert(blockRows % 64 == 0);
+    run(columns, rows, [&](const std::int64_t* values, std::size_t offset, std::size_t count) {
+        m_kernels->pack(selection.data() + offset / 64, values, count);
+    });
+}
@@ -0,0 +1,321 @@
+#include "BinaryAST.hpp"
+
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+using namespace frontend;
+
+constexpr char magic[4] = { 'E', 'X', 'P', 'A' };
+constexpr std::size_t headerSize = 32;
+constexpr unsigned nodeTypeCount = static_cast<unsigned>(NodeType::NotEquals) + 1;
+
+bool isTerminal(NodeType type) noexcept
+{
+    return type <= NodeType::StringLiteral;
+}
+
+// The child count of every node of the type, 0 when it varies.
+std::uint32_t fixedChildCount(NodeType type) noexcept
+{
+    switch (type) {
+        case NodeType::Identifier:
+        case NodeType::NumericLiteral:
+        case NodeType::StringLiteral:
+        case NodeType::ArrayLiteral:
+        case NodeType::FunctionCall:
+            return 0;
+        case NodeType::PostIncrement:
+        case NodeType::PostDecrement:
+        case NodeType::PreIncrement:
+        case NodeType::PreDecrement:
+        case NodeType::Negative:
+        case NodeType::Positive:
+        case NodeType::LogicalNegation:
+        case NodeType::BitwiseNot:
+            return 1;
+        default:
+            return 2;
+    }
+}
+
+void appendInteger(std::string& out, std::uint64_t value, std::size_t bytes)
+{
+    for (std::size_t i = 0; i < bytes; ++i) {
+        out.push_back(static_cast<char>(value >> (8 * i)));
+    }
+}
+
+void appendVarint(std::string& out, std::uint32_t value)
+{
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+std::uint64_t loadInteger(const unsigned char* data, std::size_t bytes) noexcept
+{
+    std::uint64_t value = 0;
+    for (std::size_t i = 0; i < bytes; ++i) {
+        value |= static_cast<std::uint64_t>(data[i]) << (8 * i);
+    }
+    return value;
+}
+
+std::uint32_t load32(const unsigned char* data) noexcept
+{
+    return static_cast<std::uint32_t>(loadInteger(data, 4));
+}
+
+std::uint32_t zigzag(std::uint32_t delta) noexcept
+{
+    return delta << 1 ^ static_cast<std::uint32_t>(static_cast<std::int32_t>(delta) >> 31);
+}
+
+std::uint32_t unzigzag(std::uint32_t value) noexcept
+{
+    return value >> 1 ^ (0 - (value & 1));
+}
+
+std::uint32_t readVarint(const unsigned char*& position) noexcept
+{
+    std::uint32_t value = 0;
+    for (unsigned shift = 0;; shift += 7) {
+        unsigned char byte = *position++;
+        value |= static_cast<std::uint32_t>(byte & 0x7f) << shift;
+        if (byte < 0x80) return value;
+    }
+}
+
+[[noreturn]] void corrupt(const char* what)
+{
+    throw std::runtime_error(std::string("BinaryAST: ") + what);
+}
+
+// readVarint() with bounds, rejecting more than 32 bits.
+std::uint32_t readCheckedVarint(const unsigned char*& position, const unsigned char* end)
+{
+    std::uint32_t value = 0;
+    for (unsigned shift = 0; shift < 35; shift += 7) {
+        if (position == end) corrupt("truncated node.");
+        unsigned char byte = *position++;
+        if (shift == 28 && byte > 0x0f) corrupt("varint out of range.");
+        value |= static_cast<std::uint32_t>(byte & 0x7f) << shift;
+        if (byte < 0x80) return value;
+    }
+    std::unreachable();
+}
+
+} // namespace
+
+void frontend::BinaryASTWriter::add(const FlatAST& trees)
+{
+    if (trees.size() > std::numeric_limits<std::uint32_t>::max() - m_nodeCount) {
+        throw std::range_error("BinaryASTWriter: the node count is limited to 32 bits.");
+    }
+    FlatAST::Index rootEnd = 0;
+    std::uint32_t previousFrom = 0;
+    for (FlatAST::Index node = 0; node < trees.size(); ++node) {
+        if (node == rootEnd) {
+            rootEnd = trees.end(node);
+            previousFrom = 0;
+            ++m_treeCount;
+        }
+        NodeType type = trees.type(node);
+        m_nodes.push_back(static_cast<char>(type));
+        appendVarint(m_nodes, zigzag(trees.from(node) - previousFrom));
+        appendVarint(m_nodes, trees.to(node) - trees.from(node));
+        appendVarint(m_nodes, isTerminal(type) ? stringIndex(trees.value(node)) : trees.childCount(node));
+        previousFrom = trees.from(node);
+    }
+    m_nodeCount += static_cast<std::uint32_t>(trees.size());
+}
+
+auto frontend::BinaryASTWriter::finish() -> std::string
+{
+    if (m_stringData.size() > std::numeric_limits<std::uint32_t>::max()) {
+        throw std::range_error("BinaryASTWriter: the string data is limited to 32 bits.");
+    }
+    std::string out(magic, sizeof(magic));
+    appendInteger(out, BinaryAST::version, 2);
+    appendInteger(out, 0, 2);
+    appendInteger(out, m_treeCount, 4);
+    appendInteger(out, m_nodeCount, 4);
+    appendInteger(out, m_strings.size(), 4);
+    appendInteger(out, m_stringData.size(), 4);
+    appendInteger(out, m_nodes.size(), 8);
+    out.reserve(out.size() + m_stringOffsets.size() * 4 + m_stringData.size() + m_nodes.size());
+    for (std::uint32_t offset : m_stringOffsets) {
+        appendInteger(out, offset, 4);
+    }
+    out += m_stringData;
+    out += m_nodes;
+    *this = BinaryASTWriter();
+    return out;
+}
+
+auto frontend::BinaryASTWriter::stringIndex(string::FastString value) -> std::uint32_t
+{
+    auto [found, inserted] = m_strings.try_emplace(value, static_cast<std::uint32_t>(m_strings.size()));
+    if (inserted) {
+        m_stringData += value.str();
+        m_stringOffsets.push_back(static_cast<std::uint32_t>(m_stringData.size()));
+    }
+    return found->second;
+}
+
+frontend::BinaryAST::BinaryAST(std::string_view data, Trust trust)
+{
+    auto bytes = reinterpret_cast<const unsigned char*>(data.data());
+    if (data.size() < headerSize || data.compare(0, sizeof(magic), std::string_view(magic, sizeof(magic))) != 0) {
+        corrupt("not a binary AST file.");
+    }
+    if (loadInteger(bytes + 4, 2) != version) {
+        corrupt("unsupported version.");
+    }
+    m_treeCount = load32(bytes + 8);
+    m_nodeCount = load32(bytes + 12);
+    m_stringCount = load32(bytes + 16);
+    std::uint64_t stringBytes = load32(bytes + 20);
+    std::uint64_t nodeBytes = loadInteger(bytes + 24, 8);
+    // In 64 bits nothing overflows but the node bytes, checked first.
+    std::uint64_t available = data.size() - headerSize;
+    std::uint64_t offsetBytes = (static_cast<std::uint64_t>(m_stringCount) + 1) * 4;
+    if (nodeBytes > available || offsetBytes + stringBytes + nodeBytes != available) {
+        corrupt("section sizes do not match the file size.");
+    }
+    m_offsets = bytes + headerSize;
+    m_strings = data.data() + headerSize + offsetBytes;
+    m_nodes = bytes + headerSize + offsetBytes + stringBytes;
+    m_nodesEnd = m_nodes + nodeBytes;
+    if (trust == Trust::Untrusted) validate();
+}
+
+auto frontend::BinaryAST::string(std::uint32_t index) const noexcept -> std::string_view
+{
+    std::uint32_t from = load32(m_offsets + 4 * static_cast<std::size_t>(index));
+    std::uint32_t to = load32(m_offsets + 4 * (static_cast<std::size_t>(index) + 1));
+    return std::string_view(m_strings + from, to - from);
+}
+
+auto frontend::BinaryAST::toFlat() const -> FlatAST
+{
+    std::vector<std::uint32_t> handles;
+    handles.reserve(m_stringCount);
+    for (std::uint32_t i = 0; i < m_stringCount; ++i) {
+        handles.push_back(string::FastString(string(i)).handle());
+    }
+    FlatAST flat;
+    flat.m_types.reserve(m_nodeCount);
+    flat.m_from.reserve(m_nodeCount);
+    flat.m_to.reserve(m_nodeCount);
+    flat.m_ends.resize(m_nodeCount);
+    flat.m_payloads.reserve(m_nodeCount);
+    // Nodes whose subtree is not complete yet, with the children still to come.
+    struct Open {
+        FlatAST::Index node;
+        std::uint32_t remaining;
+    };
+    std::vector<Open> open;
+    Cursor cursor = nodes();
+    for (FlatAST::Index index = 0; !cursor.atEnd(); ++index) {
+        Node node = cursor.next();
+        flat.m_types.push_back(node.type);
+        flat.m_from.push_back(node.from);
+        flat.m_to.push_back(node.to);
+        if (!open.empty()) --open.back().remaining;
+        if (isTerminal(node.type)) {
+            flat.m_payloads.push_back(handles[node.payload]);
+        } else {
+            flat.m_payloads.push_back(node.payload);
+            if (node.payload > 0) {
+                open.push_back({ index, node.payload });
+                continue;
+            }
+        }
+        flat.m_ends[index] = index + 1;
+        while (!open.empty() && open.back().remaining == 0) {
+            flat.m_ends[open.back().node] = index + 1;
+            open.pop_back();
+        }
+    }
+    return flat;
+}
+
+void frontend::BinaryAST::validate() const
+{
+    std::uint32_t previous = 0;
+    for (std::uint32_t i = 0; i <= m_stringCount; ++i) {
+        std::uint32_t offset = load32(m_offsets + 4 * static_cast<std::size_t>(i));
+        if (offset < previous || (i == 0 && offset != 0)) corrupt("string offsets out of order.");
+        previous = offset;
+    }
+    if (previous != static_cast<std::size_t>(reinterpret_cast<const char*>(m_nodes) - m_strings)) {
+        corrupt("string offsets do not match the string data.");
+    }
+    struct Open {
+        NodeType type;
+        std::uint32_t remaining;
+        std::uint32_t seen;
+    };
+    std::vector<Open> open;
+    const unsigned char* position = m_nodes;
+    std::uint32_t trees = 0;
+    std::uint32_t previousFrom = 0;
+    for (std::uint32_t decoded = 0; decoded < m_nodeCount; ++decoded) {
+        if (position == m_nodesEnd) corrupt("truncated node.");
+        if (*position >= nodeTypeCount) corrupt("unknown node type.");
+        auto type = static_cast<NodeType>(*position++);
+        if (open.empty()) previousFrom = 0;
+        std::uint32_t from = previousFrom + unzigzag(readCheckedVarint(position, m_nodesEnd));
+        std::uint32_t length = readCheckedVarint(position, m_nodesEnd);
+        std::uint32_t payload = readCheckedVarint(position, m_nodesEnd);
+        if (length > std::numeric_limits<std::uint32_t>::max() - from) corrupt("source range out of bounds.");
+        previousFrom = from;
+        if (open.empty()) {
+            ++trees;
+        } else {
+            Open& parent = open.back();
+            if (parent.type == NodeType::MemberAccess && parent.seen == 1 && type != NodeType::Identifier) {
+                corrupt("member name is not an identifier.");
+            }
+            ++parent.seen;
+            if (--parent.remaining == 0) open.pop_back();
+        }
+        if (isTerminal(type)) {
+            if (payload >= m_stringCount) corrupt("string index out of range.");
+            continue;
+        }
+        std::uint32_t expected = fixedChildCount(type);
+        if ((expected != 0 && payload != expected) || (type == NodeType::FunctionCall && payload == 0)) {
+            corrupt("wrong child count.");
+        }
+        if (payload > m_nodeCount - decoded - 1) corrupt("more children than nodes.");
+        if (payload > 0) open.push_back({ type, payload, 0 });
+    }
+    if (!open.empty()) corrupt("truncated tree.");
+    if (trees != m_treeCount) corrupt("wrong tree count.");
+    if (position != m_nodesEnd) corrupt("trailing bytes after the nodes.");
+}
+
+auto frontend::BinaryAST::Cursor::next() noexcept -> Node
+{
+    if (m_pending == 0) {
+        m_pending = 1;
+        m_previousFrom = 0;
+    }
+    Node node;
+    node.type = static_cast<NodeType>(*m_position++);
+    node.from = m_previousFrom + unzigzag(readVarint(m_position));
+    node.to = node.from + readVarint(m_position);
+    node.payload = readVarint(m_position);
+    m_previousFrom = node.from;
+    --m_pending;
+    if (!isTerminal(node.type)) m_pending += node.payload;
+    --m_remaining;
+    return node;
+}
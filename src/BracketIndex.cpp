@@ -0,0 +1,62 @@
+#include "BracketIndex.hpp"
+
+frontend::BracketIndex::BracketIndex(const TokenStream& stream)
+    : m_stream(&stream)
+    , m_matches(new Index[stream.size()])
+{
+    auto types = stream.types();
+    std::vector<Index> open;
+    for (Index token = 0; token < types.size(); ++token) {
+        TokenType opening;
+        switch (types[token]) {
+            case TokenType::OpenBracket:
+            case TokenType::OpenParenthesis:
+                open.push_back(token);
+                continue;
+            case TokenType::CloseBracket:
+                opening = TokenType::OpenBracket;
+                break;
+            case TokenType::CloseParenthesis:
+                opening = TokenType::OpenParenthesis;
+                break;
+            default:
+                continue;
+        }
+        // A mismatched closing token stays unmatched, and so do the brackets around it.
+        if (open.empty() || types[open.back()] != opening) {
+            m_matches[token] = none;
+            continue;
+        }
+        m_matches[open.back()] = token;
+        m_matches[token] = open.back();
+        open.pop_back();
+    }
+    for (Index token : open) {
+        m_matches[token] = none;
+    }
+}
+
+auto frontend::BracketIndex::commas(Index open) const -> std::vector<Index>
+{
+    std::vector<Index> commas;
+    Index close = m_matches[open];
+    if (close == none || close < open) {
+        return commas;
+    }
+    auto types = m_stream->types();
+    for (Index token = open + 1; token < close; ++token) {
+        switch (types[token]) {
+            case TokenType::Comma:
+                commas.push_back(token);
+                break;
+            case TokenType::OpenBracket:
+            case TokenType::OpenParenthesis:
+                // Balanced, since the enclosing pair is matched.
+                token = m_matches[token];
+                break;
+            default:
+                break;
+        }
+    }
+    return commas;
+}
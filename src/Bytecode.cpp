@@ -0,0 +1,376 @@
+#include "Bytecode.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <ostream>
+#include <stdexcept>
+#include <utility>
+
+#include "Visitor.hpp"
+
+namespace {
+
+using frontend::Expression;
+using frontend::NodeType;
+
+bool isIncrement(NodeType type) noexcept
+{
+    return type == NodeType::PreIncrement || type == NodeType::PreDecrement || type == NodeType::PostIncrement ||
+        type == NodeType::PostDecrement;
+}
+
+// Calls function with each subexpression evaluated for node, in evaluation order.
+// The name of a member is not evaluated, nor is an incremented variable; an
+// incremented element or member evaluates its container and subscript.
+template <typename Function>
+void forEachOperand(const Expression& node, Function&& function)
+{
+    if (isIncrement(node.nodeType())) {
+        const auto& target = static_cast<const frontend::UnaryOperator&>(node).argument();
+        if (target.nodeType() != NodeType::Identifier) forEachOperand(target, function);
+    } else if (node.nodeType() == NodeType::MemberAccess) {
+        function(static_cast<const frontend::MemberAccess&>(node).argument());
+    } else {
+        frontend::forEachChild(node, function);
+    }
+}
+
+backend::Opcode binaryOpcode(NodeType type) noexcept
+{
+    using backend::Opcode;
+    switch (type) {
+        case NodeType::Addition: return Opcode::Add;
+        case NodeType::Subtraction: return Opcode::Subtract;
+        case NodeType::Multiplication: return Opcode::Multiply;
+        case NodeType::Division: return Opcode::Divide;
+        case NodeType::Remainder: return Opcode::Remainder;
+        case NodeType::ShiftLeft: return Opcode::ShiftLeft;
+        case NodeType::ShiftRight: return Opcode::ShiftRight;
+        case NodeType::ShiftRightLogic: return Opcode::ShiftRightLogic;
+        case NodeType::LessThan: return Opcode::Less;
+        case NodeType::LessEquals: return Opcode::LessEquals;
+        case NodeType::GreaterThan: return Opcode::Greater;
+        case NodeType::GreaterEquals: return Opcode::GreaterEquals;
+        case NodeType::Equals: return Opcode::Equals;
+        default: return Opcode::NotEquals;
+    }
+}
+
+const char* opcodeName(backend::Opcode opcode) noexcept
+{
+    static const char* const names[] = {
+        "Move", "Add", "Subtract", "Multiply", "Divide", "Remainder", "ShiftLeft", "ShiftRight", "ShiftRightLogic",
+        "Less", "LessEquals", "Greater", "GreaterEquals", "Equals", "NotEquals", "Plus", "Negate", "Not",
+        "BitwiseNot", "Increment", "Decrement", "NewArray", "Call", "GetElement", "SetElement", "GetMember",
+        "SetMember", "Return"
+    };
+    return names[static_cast<std::size_t>(opcode)];
+}
+
+} // namespace
+
+backend::Program::Program()
+{
+    static std::atomic<std::uint64_t> programs{ 0 };
+    m_id = programs.fetch_add(1, std::memory_order_relaxed);
+}
+
+auto backend::Program::input(std::string_view name) const -> std::optional<std::size_t>
+{
+    for (std::size_t i = 0; i < m_inputs.size(); ++i) {
+        if (m_inputs[i].str() == name) return i;
+    }
+    return std::nullopt;
+}
+
+auto backend::Program::disassemble(std::ostream& os) const -> void
+{
+    for (std::size_t i = 0; i < m_constants.size(); ++i) {
+        os << "r" << i << " = " << m_constants[i].toString() << std::endl;
+    }
+    for (std::size_t i = 0; i < m_inputs.size(); ++i) {
+        os << "r" << firstInput() + i << " = " << m_inputs[i].str() << std::endl;
+    }
+    for (const auto& instruction : m_code) {
+        os << "  " << opcodeName(instruction.opcode) << " r" << instruction.a;
+        switch (instruction.opcode) {
+            case Opcode::Return:
+                break;
+            case Opcode::NewArray:
+            case Opcode::Call:
+                os << ", r" << instruction.b << ", " << instruction.c;
+                break;
+            case Opcode::GetMember:
+            case Opcode::SetMember:
+                os << ", r" << instruction.b << ", "
+                   << frontend::string::FastString::fromHandle(instruction.c).str();
+                break;
+            case Opcode::Move:
+            case Opcode::Plus:
+            case Opcode::Negate:
+            case Opcode::Not:
+            case Opcode::BitwiseNot:
+            case Opcode::Increment:
+            case Opcode::Decrement:
+                os << ", r" << instruction.b;
+                break;
+            default:
+                os << ", r" << instruction.b << ", r" << instruction.c;
+                break;
+        }
+        os << std::endl;
+    }
+}
+
+auto backend::Compiler::compile(const frontend::Expression& expression) -> Program
+{
+    Compiler compiler;
+    compiler.allocateOperands(expression);
+    // Post-order: a node is emitted once all its operands are.
+    enum class Action : std::uint8_t { Evaluate, Pin, Emit };
+    struct Pending {
+        const Expression* node;
+        Action action;
+    };
+    std::vector<Pending> pending{ { &expression, Action::Evaluate } };
+    while (!pending.empty()) {
+        auto [node, action] = pending.back();
+        pending.pop_back();
+        switch (action) {
+            case Action::Evaluate: {
+                pending.push_back({ node, Action::Emit });
+                // Their operands must be in consecutive registers, each one is pinned once evaluated.
+                bool pinned = node->nodeType() == NodeType::ArrayLiteral || node->nodeType() == NodeType::FunctionCall;
+                std::size_t first = pending.size();
+                forEachOperand(*node, [&](const Expression& operand) {
+                    pending.push_back({ &operand, Action::Evaluate });
+                    if (pinned) pending.push_back({ node, Action::Pin });
+                });
+                std::reverse(pending.begin() + first, pending.end());
+                break;
+            }
+            case Action::Pin: {
+                std::uint32_t result = compiler.m_results.back();
+                if (result < compiler.m_firstTemporary) {
+                    compiler.m_results.back() = compiler.allocate();
+                    compiler.instruction(Opcode::Move, compiler.m_results.back(), result);
+                }
+                break;
+            }
+            case Action::Emit:
+                compiler.emit(*node);
+                break;
+        }
+    }
+    compiler.instruction(Opcode::Return, compiler.pop());
+    for (std::uint32_t index = 0; index < compiler.m_incremented.size(); ++index) {
+        if (compiler.m_incremented[index]) {
+            compiler.m_program.m_outputs.push_back(compiler.m_program.firstInput() + index);
+        }
+    }
+    return std::move(compiler.m_program);
+}
+
+auto backend::Compiler::allocateOperands(const frontend::Expression& root) -> void
+{
+    auto& constants = m_program.m_constants;
+    std::vector<const Expression*> pending{ &root };
+    while (!pending.empty()) {
+        const Expression* node = pending.back();
+        pending.pop_back();
+        switch (node->nodeType()) {
+            case NodeType::NumericLiteral: {
+                const auto& literal = static_cast<const frontend::NumericLiteral&>(*node).literal();
+                auto value = Integer::parse(literal.str());
+                if (!value) {
+                    throw std::range_error("Integer literal does not fit in 64 bits: " + literal.str());
+                }
+                if (m_integers.try_emplace(value->low(), constants.size()).second) constants.emplace_back(*value);
+                break;
+            }
+            case NodeType::StringLiteral: {
+                const auto& literal = static_cast<const frontend::StringLiteral&>(*node).literal();
+                if (m_strings.try_emplace(literal, constants.size()).second) constants.emplace_back(literal.str());
+                break;
+            }
+            default:
+                break;
+        }
+        const Expression* variable = node->nodeType() == NodeType::Identifier ? node : nullptr;
+        if (isIncrement(node->nodeType())) {
+            const auto& target = static_cast<const frontend::UnaryOperator&>(*node).argument();
+            if (target.nodeType() == NodeType::Identifier) {
+                variable = &target;
+            } else if (target.nodeType() != NodeType::SubscriptAccess && target.nodeType() != NodeType::MemberAccess) {
+                throw std::runtime_error("Only variables, elements and members can be incremented.");
+            }
+        }
+        if (variable) {
+            const auto& name = static_cast<const frontend::Identifier&>(*variable).identifier();
+            auto [found, added] = m_inputs.try_emplace(name, static_cast<std::uint32_t>(m_program.m_inputs.size()));
+            if (added) {
+                m_program.m_inputs.push_back(name);
+                m_incremented.push_back(false);
+            }
+            m_incremented[found->second] = m_incremented[found->second] || variable != node;
+        }
+        // In evaluation order, for the inputs to be numbered by first appearance.
+        std::size_t first = pending.size();
+        forEachOperand(*node, [&](const Expression& operand) { pending.push_back(&operand); });
+        std::reverse(pending.begin() + first, pending.end());
+    }
+    m_firstTemporary = static_cast<std::uint32_t>(constants.size() + m_program.m_inputs.size());
+    m_nextTemporary = m_firstTemporary;
+    m_program.m_registerCount = m_firstTemporary;
+}
+
+auto backend::Compiler::emit(const frontend::Expression& node) -> void
+{
+    switch (node.nodeType()) {
+        case NodeType::Identifier: {
+            const auto& name = static_cast<const frontend::Identifier&>(node).identifier();
+            std::uint32_t index = m_inputs.at(name);
+            std::uint32_t input = m_program.firstInput() + index;
+            if (!m_incremented[index]) {
+                m_results.push_back(input);
+                return;
+            }
+            // A copy, the operands evaluated later may increment the input.
+            std::uint32_t copy = allocate();
+            instruction(Opcode::Move, copy, input);
+            m_results.push_back(copy);
+            return;
+        }
+        case NodeType::NumericLiteral: {
+            const auto& literal = static_cast<const frontend::NumericLiteral&>(node).literal();
+            m_results.push_back(m_integers.at(Integer::parse(literal.str())->low()));
+            return;
+        }
+        case NodeType::StringLiteral:
+            m_results.push_back(m_strings.at(static_cast<const frontend::StringLiteral&>(node).literal()));
+            return;
+        case NodeType::ArrayLiteral:
+        case NodeType::FunctionCall: {
+            std::size_t count = node.nodeType() == NodeType::ArrayLiteral
+                ? static_cast<const frontend::ArrayLiteral&>(node).elements().size()
+                : static_cast<const frontend::FunctionCall&>(node).arguments().size() + 1;
+            std::uint32_t first = m_nextTemporary - static_cast<std::uint32_t>(count);
+            for (std::size_t i = 0; i < count; ++i) pop();
+            std::uint32_t result = allocate();
+            if (node.nodeType() == NodeType::ArrayLiteral) {
+                instruction(Opcode::NewArray, result, first, static_cast<std::uint32_t>(count));
+            } else {
+                instruction(Opcode::Call, result, first, static_cast<std::uint32_t>(count - 1));
+            }
+            m_results.push_back(result);
+            return;
+        }
+        case NodeType::MemberAccess: {
+            std::uint32_t object = pop();
+            std::uint32_t result = allocate();
+            auto name = static_cast<const frontend::MemberAccess&>(node).identifier().identifier();
+            instruction(Opcode::GetMember, result, object, name.handle());
+            m_results.push_back(result);
+            return;
+        }
+        case NodeType::PreIncrement:
+        case NodeType::PreDecrement:
+        case NodeType::PostIncrement:
+        case NodeType::PostDecrement:
+            emitIncrement(node);
+            return;
+        case NodeType::Positive:
+        case NodeType::Negative:
+        case NodeType::LogicalNegation:
+        case NodeType::BitwiseNot: {
+            std::uint32_t argument = pop();
+            std::uint32_t result = allocate();
+            Opcode opcode = node.nodeType() == NodeType::Positive ? Opcode::Plus
+                : node.nodeType() == NodeType::Negative           ? Opcode::Negate
+                : node.nodeType() == NodeType::LogicalNegation    ? Opcode::Not
+                                                                  : Opcode::BitwiseNot;
+            instruction(opcode, result, argument);
+            m_results.push_back(result);
+            return;
+        }
+        default: {
+            // Binary operators, and SubscriptAccess.
+            std::uint32_t rhs = pop();
+            std::uint32_t lhs = pop();
+            std::uint32_t result = allocate();
+            Opcode opcode =
+                node.nodeType() == NodeType::SubscriptAccess ? Opcode::GetElement : binaryOpcode(node.nodeType());
+            instruction(opcode, result, lhs, rhs);
+            m_results.push_back(result);
+            return;
+        }
+    }
+}
+
+auto backend::Compiler::emitIncrement(const frontend::Expression& node) -> void
+{
+    bool post = node.nodeType() == NodeType::PostIncrement || node.nodeType() == NodeType::PostDecrement;
+    Opcode step = node.nodeType() == NodeType::PreIncrement || node.nodeType() == NodeType::PostIncrement
+        ? Opcode::Increment
+        : Opcode::Decrement;
+    const auto& target = static_cast<const frontend::UnaryOperator&>(node).argument();
+    if (target.nodeType() == NodeType::Identifier) {
+        const auto& name = static_cast<const frontend::Identifier&>(target).identifier();
+        std::uint32_t input = m_program.firstInput() + m_inputs.at(name);
+        std::uint32_t result = allocate();
+        if (post) instruction(Opcode::Move, result, input);
+        instruction(step, input, input);
+        if (!post) instruction(Opcode::Move, result, input);
+        m_results.push_back(result);
+        return;
+    }
+    // Read, step and write back the element or member, above the registers of its container.
+    bool element = target.nodeType() == NodeType::SubscriptAccess;
+    std::uint32_t subscript = element ? m_results.back() : 0;
+    std::uint32_t container = m_results[m_results.size() - 1 - element];
+    std::uint32_t name = element ? 0 : static_cast<const frontend::MemberAccess&>(target).identifier().identifier().handle();
+    std::uint32_t value = allocate();
+    std::uint32_t stepped = post ? allocate() : value;
+    if (element) {
+        instruction(Opcode::GetElement, value, container, subscript);
+        instruction(step, stepped, value);
+        instruction(Opcode::SetElement, container, subscript, stepped);
+    } else {
+        instruction(Opcode::GetMember, value, container, name);
+        instruction(step, stepped, value);
+        instruction(Opcode::SetMember, container, stepped, name);
+    }
+    if (post) release(stepped);
+    release(value);
+    pop();
+    if (element) pop();
+    std::uint32_t result = allocate();
+    if (result != value) instruction(Opcode::Move, result, value);
+    m_results.push_back(result);
+}
+
+auto backend::Compiler::allocate() -> std::uint32_t
+{
+    std::uint32_t reg = m_nextTemporary++;
+    if (m_nextTemporary > m_program.m_registerCount) m_program.m_registerCount = m_nextTemporary;
+    return reg;
+}
+
+auto backend::Compiler::release(std::uint32_t reg) -> void
+{
+    // Temporaries are freed in the reverse order of their allocation.
+    if (reg >= m_firstTemporary) --m_nextTemporary;
+}
+
+auto backend::Compiler::pop() -> std::uint32_t
+{
+    std::uint32_t reg = m_results.back();
+    m_results.pop_back();
+    release(reg);
+    return reg;
+}
+
+auto backend::Compiler::instruction(Opcode opcode, std::uint32_t a, std::uint32_t b, std::uint32_t c) -> void
+{
+    m_program.m_code.push_back({ opcode, a, b, c });
+}
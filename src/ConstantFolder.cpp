@@ -0,0 +1,171 @@
+#include "ConstantFolder.hpp"
+
+#include <charconv>
+#include <stdexcept>
+#include <utility>
+
+auto frontend::ConstantFolder::fold(NodePtr<Expression>& tree) -> std::size_t
+{
+    if (!tree) return 0;
+    if (tree->inArena() != (m_factory.arena() != nullptr)) {
+        throw std::logic_error("ConstantFolder: the factory must allocate like the tree.");
+    }
+    m_removed = 0;
+    rewrite(tree);
+    return m_removed;
+}
+
+auto frontend::ConstantFolder::foldUnary(const UnaryOperator& node) -> NodePtr<Expression>
+{
+    // A negated literal is how a negative constant is written, it stays.
+    if (isConstant(node) || !isConstant(node.argument())) return nullptr;
+    auto value = constant(node.argument());
+    if (!value) return nullptr;
+    std::int64_t result = *value;
+    if (node.nodeType() == NodeType::BitwiseNot) {
+        result = ~*value;
+    } else if (node.nodeType() == NodeType::Negative && __builtin_sub_overflow(0, *value, &result)) {
+        return diagnose(node, "Integer overflow.");
+    }
+    return replace(node, makeConstant(node, result));
+}
+
+auto frontend::ConstantFolder::rewriteBinaryOperator(BinaryOperator& node) -> NodePtr<Expression>
+{
+    switch (node.nodeType()) {
+        case NodeType::Addition:
+        case NodeType::Subtraction:
+        case NodeType::Multiplication:
+        case NodeType::Division:
+        case NodeType::Remainder:
+        case NodeType::ShiftLeft:
+        case NodeType::ShiftRight:
+        case NodeType::ShiftRightLogic:
+            break;
+        default:
+            // Comparisons give booleans, which have no literal.
+            return nullptr;
+    }
+    auto lhsType = node.lhs().nodeType();
+    auto rhsType = node.rhs().nodeType();
+    if (lhsType == NodeType::StringLiteral && rhsType == NodeType::StringLiteral) {
+        if (node.nodeType() != NodeType::Addition) return nullptr;
+        std::string concatenated = static_cast<const StringLiteral&>(node.lhs()).literal().str();
+        concatenated += static_cast<const StringLiteral&>(node.rhs()).literal().str();
+        return replace(node, m_factory.make<StringLiteral>(concatenated, node.from(), node.to()));
+    }
+    if (!isConstant(node.lhs()) || !isConstant(node.rhs())) return nullptr;
+    auto lhs = constant(node.lhs());
+    auto rhs = constant(node.rhs());
+    if (!lhs || !rhs) return nullptr;
+    return replace(node, foldBinary(node, *lhs, *rhs));
+}
+
+auto frontend::ConstantFolder::foldBinary(const Expression& node, std::int64_t lhs, std::int64_t rhs) -> NodePtr<Expression>
+{
+    std::int64_t result = 0;
+    bool overflow = false;
+    switch (node.nodeType()) {
+        case NodeType::Addition:
+            overflow = __builtin_add_overflow(lhs, rhs, &result);
+            break;
+        case NodeType::Subtraction:
+            overflow = __builtin_sub_overflow(lhs, rhs, &result);
+            break;
+        case NodeType::Multiplication:
+            overflow = __builtin_mul_overflow(lhs, rhs, &result);
+            break;
+        case NodeType::Division:
+        case NodeType::Remainder:
+            if (rhs == 0) {
+                return diagnose(node, "Division by zero.");
+            }
+            // The only quotient out of range, its remainder is 0.
+            if (rhs == -1) {
+                overflow = node.nodeType() == NodeType::Division && __builtin_sub_overflow(0, lhs, &result);
+            } else {
+                result = node.nodeType() == NodeType::Division ? lhs / rhs : lhs % rhs;
+            }
+            break;
+        default: {
+            if (rhs < 0 || rhs > 63) {
+                return diagnose(node, "Shift count out of range.");
+            }
+            if (node.nodeType() == NodeType::ShiftLeft) {
+                result = static_cast<std::int64_t>(static_cast<std::uint64_t>(lhs) << rhs);
+                overflow = result >> rhs != lhs;
+            } else if (node.nodeType() == NodeType::ShiftRight) {
+                result = lhs >> rhs;
+            } else {
+                std::uint64_t bits = static_cast<std::uint64_t>(lhs) >> rhs;
+                overflow = bits > static_cast<std::uint64_t>(INT64_MAX);
+                result = static_cast<std::int64_t>(bits);
+            }
+            break;
+        }
+    }
+    if (overflow) {
+        return diagnose(node, "Integer overflow.");
+    }
+    return makeConstant(node, result);
+}
+
+bool frontend::ConstantFolder::isConstant(const Expression& node) noexcept
+{
+    if (node.nodeType() == NodeType::Negative) {
+        return static_cast<const UnaryOperator&>(node).argument().nodeType() == NodeType::NumericLiteral;
+    }
+    return node.nodeType() == NodeType::NumericLiteral;
+}
+
+std::size_t frontend::ConstantFolder::constantSize(const Expression& node) noexcept
+{
+    return node.nodeType() == NodeType::Negative ? 2 : 1;
+}
+
+auto frontend::ConstantFolder::constant(const Expression& node) -> std::optional<std::int64_t>
+{
+    bool negative = node.nodeType() == NodeType::Negative;
+    const Expression& literalNode = negative ? static_cast<const UnaryOperator&>(node).argument() : node;
+    const std::string& literal = static_cast<const NumericLiteral&>(literalNode).literal().str();
+    const char* begin = literal.data();
+    int base = 10;
+    if (literal.size() > 2 && literal[0] == '0') {
+        base = literal[1] == 'b' ? 2 : literal[1] == 'o' ? 8 : 16;
+        begin += 2;
+    }
+    std::uint64_t magnitude = 0;
+    auto [end, error] = std::from_chars(begin, literal.data() + literal.size(), magnitude, base);
+    // Negated, the magnitude may be one more than the largest value, the smallest one.
+    std::uint64_t limit = static_cast<std::uint64_t>(INT64_MAX) + (negative ? 1 : 0);
+    if (error != std::errc() || end != literal.data() + literal.size() || magnitude > limit) {
+        diagnose(literalNode, "Integer literal does not fit in 64 bits.");
+        return std::nullopt;
+    }
+    return negative ? static_cast<std::int64_t>(0 - magnitude) : static_cast<std::int64_t>(magnitude);
+}
+
+auto frontend::ConstantFolder::makeConstant(const Expression& node, std::int64_t value) -> NodePtr<Expression>
+{
+    if (value >= 0) {
+        return m_factory.make<NumericLiteral>(std::to_string(value), node.from(), node.to());
+    }
+    // Literals have no sign: a negative value is written like the lexer would read it.
+    auto magnitude = std::to_string(0 - static_cast<std::uint64_t>(value));
+    return m_factory.make<Negative>(m_factory.make<NumericLiteral>(magnitude, node.from(), node.to()), node.from());
+}
+
+auto frontend::ConstantFolder::diagnose(const Expression& node, std::string_view message) -> NodePtr<Expression>
+{
+    m_diagnostics.push_back({ node.from(), node.to(), std::string(message) });
+    return nullptr;
+}
+
+auto frontend::ConstantFolder::replace(const Expression& node, NodePtr<Expression> constant) -> NodePtr<Expression>
+{
+    if (!constant) return nullptr;
+    std::size_t nodes = 1;
+    forEachChild(node, [&](const Expression& operand) { nodes += constantSize(operand); });
+    m_removed += nodes - constantSize(*constant);
+    return constant;
+}
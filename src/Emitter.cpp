@@ -0,0 +1,180 @@
+#include "Emitter.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <stdexcept>
+#include <utility>
+
+#include "Visitor.hpp"
+
+namespace {
+
+using namespace frontend;
+
+// The class of the nodes of a type.
+constexpr std::string_view nameOf(NodeType type) noexcept
+{
+    switch (type) {
+#define FRONTEND_NAME_CASE(CLASS_NAME)                                                              \
+        case NodeType::CLASS_NAME:                                                                  \
+            return #CLASS_NAME;
+        FRONTEND_NODE_TYPES(FRONTEND_NAME_CASE)
+#undef FRONTEND_NAME_CASE
+    }
+    std::unreachable();
+}
+
+} // namespace
+
+frontend::OutputBuffer::OutputBuffer(Sink sink, std::size_t blockSize)
+    : m_sink(std::move(sink))
+    , m_blockSize(blockSize)
+{
+    m_buffer.reserve(blockSize + blockSize / 4);
+}
+
+frontend::OutputBuffer::OutputBuffer(std::FILE* file, std::size_t blockSize)
+    : OutputBuffer(
+          [file](std::string_view block) {
+              if (std::fwrite(block.data(), 1, block.size(), file) != block.size()) {
+                  throw std::runtime_error("Failed to write the output.");
+              }
+          },
+          blockSize)
+{
+}
+
+frontend::OutputBuffer::~OutputBuffer()
+{
+    try {
+        flush();
+    } catch (...) {
+    }
+}
+
+void frontend::OutputBuffer::appendNumber(std::size_t value)
+{
+    char digits[20];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    append(std::string_view(digits, result.ptr - digits));
+}
+
+void frontend::OutputBuffer::flush()
+{
+    if (!m_sink || m_buffer.empty()) return;
+    m_sink(m_buffer);
+    m_buffer.clear();
+}
+
+void frontend::Emitter::emit(const Expression& tree)
+{
+    // Preorder, with a closing entry under the children of every compound node.
+    m_pending.push_back({ &tree, 0, false, true });
+    while (!m_pending.empty()) {
+        Pending pending = m_pending.back();
+        m_pending.pop_back();
+        if (pending.close) {
+            close();
+            continue;
+        }
+        if (pending.depth > 0) separate(pending.depth, pending.first);
+        if (!open(*pending.node)) continue;
+        m_pending.push_back({ pending.node, pending.depth, true, false });
+        m_children.clear();
+        forEachChild(*pending.node, [&](const Expression& child) { m_children.push_back(&child); });
+        for (std::size_t i = m_children.size(); i-- > 0;) {
+            m_pending.push_back({ m_children[i], pending.depth + 1, false, i == 0 });
+        }
+    }
+    m_out.put('\n');
+}
+
+void frontend::Emitter::separate(std::size_t depth, bool first)
+{
+    if (m_options.format == Format::Json) {
+        if (!first) m_out.put(',');
+    } else if (m_options.indent == 0) {
+        m_out.put(' ');
+    }
+    if (m_options.indent > 0) {
+        m_out.put('\n');
+        m_out.indent(depth * m_options.indent);
+    }
+}
+
+bool frontend::Emitter::open(const Expression& node)
+{
+    std::string_view value;
+    switch (node.nodeType()) {
+        case NodeType::Identifier:
+            value = static_cast<const Identifier&>(node).identifier().str();
+            break;
+        case NodeType::NumericLiteral:
+            value = static_cast<const NumericLiteral&>(node).literal().str();
+            break;
+        case NodeType::StringLiteral:
+            value = static_cast<const StringLiteral&>(node).literal().str();
+            break;
+        default:
+            break;
+    }
+    bool terminal = node.nodeType() <= NodeType::StringLiteral;
+    if (m_options.format == Format::SExpression) {
+        if (node.nodeType() == NodeType::StringLiteral) {
+            quote(value);
+        } else if (terminal) {
+            m_out.append(value);
+        } else {
+            m_out.put('(');
+            m_out.append(nameOf(node.nodeType()));
+        }
+        return !terminal;
+    }
+    m_out.append("{\"type\":\"");
+    m_out.append(nameOf(node.nodeType()));
+    m_out.append("\",\"from\":");
+    m_out.appendNumber(node.from());
+    m_out.append(",\"to\":");
+    m_out.appendNumber(node.to());
+    if (terminal) {
+        m_out.append(",\"value\":");
+        quote(value);
+        m_out.put('}');
+    } else {
+        m_out.append(",\"children\":[");
+    }
+    return !terminal;
+}
+
+void frontend::Emitter::close()
+{
+    m_out.append(m_options.format == Format::Json ? "]}" : ")");
+}
+
+void frontend::Emitter::quote(std::string_view text)
+{
+    static constexpr char hex[] = "0123456789abcdef";
+    m_out.put('"');
+    while (!text.empty()) {
+        // Copy the longest run that needs no escape at once.
+        auto special = std::find_if(text.begin(), text.end(), [](char c) {
+            return c == '"' || c == '\\' || static_cast<unsigned char>(c) < 0x20;
+        });
+        m_out.append(std::string_view(text.begin(), special));
+        if (special == text.end()) break;
+        char c = *special;
+        if (c == '"' || c == '\\') {
+            m_out.put('\\');
+            m_out.put(c);
+        } else if (c == '\n') {
+            m_out.append("\\n");
+        } else if (c == '\t') {
+            m_out.append("\\t");
+        } else {
+            char escape[] = { '\\', 'u', '0', '0', hex[c >> 4 & 0xf], hex[c & 0xf] };
+            m_out.append(std::string_view(escape, sizeof(escape)));
+        }
+        text.remove_prefix(special - text.begin() + 1);
+    }
+    m_out.put('"');
+}
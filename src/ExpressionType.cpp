@@ -0,0 +1,87 @@
+#include "ExpressionType.hpp"
+
+#include <new>
+#include <stdexcept>
+
+namespace {
+
+constexpr std::size_t basicTypeCount = static_cast<std::size_t>(frontend::BasicExpressionType::Array);
+
+std::atomic<std::size_t> arrayTypes = 0;
+
+} // namespace
+
+frontend::ExpressionType::ExpressionType(BasicExpressionType type, const ExpressionType* elementType) noexcept
+    : m_type(type)
+    , m_depth(elementType ? elementType->m_depth + 1 : 0)
+    , m_elementType(elementType)
+    , m_arrayType(nullptr)
+{
+}
+
+auto frontend::ExpressionType::basic(BasicExpressionType type) -> const ExpressionType&
+{
+    // Never destroyed: array types point back at them and are never freed either, so a
+    // type taken from a static destructor is still valid.
+    static const ExpressionType* const types = [] {
+        auto* created = static_cast<ExpressionType*>(::operator new(sizeof(ExpressionType) * basicTypeCount));
+        for (std::size_t i = 0; i < basicTypeCount; ++i) {
+            new (created + i) ExpressionType(static_cast<BasicExpressionType>(i), nullptr);
+        }
+        return created;
+    }();
+    if (type == BasicExpressionType::Array) {
+        throw std::logic_error("ExpressionType::basic: arrays need an element type, use arrayOf().");
+    }
+    return types[static_cast<std::size_t>(type)];
+}
+
+auto frontend::ExpressionType::arrayOf(const ExpressionType& elementType, std::uint32_t depth) -> const ExpressionType&
+{
+    const ExpressionType* type = &elementType;
+    for (std::uint32_t i = 0; i < depth; ++i) {
+        type = &arrayOf(*type);
+    }
+    return *type;
+}
+
+auto frontend::ExpressionType::createArrayOf(const ExpressionType& elementType) -> const ExpressionType&
+{
+    // The slot of an element type goes from nullptr to its array type once and never
+    // changes again, so one compare-exchange publishes it. A thread that loses frees its
+    // own copy and returns the winner's, which arrayOf() then reads without this call.
+    const ExpressionType* array = nullptr;
+    auto* created = new ExpressionType(BasicExpressionType::Array, &elementType);
+    if (elementType.m_arrayType.compare_exchange_strong(array, created, std::memory_order_acq_rel)) {
+        arrayTypes.fetch_add(1, std::memory_order_relaxed);
+        return *created;
+    }
+    delete created;
+    return *array;
+}
+
+auto frontend::ExpressionType::arrayTypeCount() noexcept -> std::size_t
+{
+    return arrayTypes.load(std::memory_order_relaxed);
+}
+
+auto frontend::ExpressionType::toString() const -> std::string
+{
+    const ExpressionType* type = this;
+    while (type->m_elementType) type = type->m_elementType;
+    auto index = static_cast<unsigned>(type->m_type);
+    auto firstInt = static_cast<unsigned>(BasicExpressionType::Int8);
+    auto firstUint = static_cast<unsigned>(BasicExpressionType::Uint8);
+    std::string text;
+    if (type->m_type == BasicExpressionType::Bool) {
+        text = "bool";
+    } else if (type->m_type == BasicExpressionType::String) {
+        text = "string";
+    } else if (index >= firstInt) {
+        text = "int" + std::to_string((index - firstInt + 1) * 8);
+    } else {
+        text = "uint" + std::to_string((index - firstUint + 1) * 8);
+    }
+    for (std::uint32_t i = 0; i < m_depth; ++i) text += "[]";
+    return text;
+}
@@ -0,0 +1,169 @@
+#include "FlatAST.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+#include "Visitor.hpp"
+
+namespace {
+
+using namespace frontend;
+
+std::uint32_t payloadOf(const Expression& node)
+{
+    switch (node.nodeType()) {
+        case NodeType::Identifier:
+            return static_cast<const Identifier&>(node).identifier().handle();
+        case NodeType::NumericLiteral:
+            return static_cast<const NumericLiteral&>(node).literal().handle();
+        case NodeType::StringLiteral:
+            return static_cast<const StringLiteral&>(node).literal().handle();
+        default: {
+            std::uint32_t count = 0;
+            forEachChild(node, [&](const Expression&) { ++count; });
+            return count;
+        }
+    }
+}
+
+NodePtr<Expression> pop(std::vector<NodePtr<Expression>>& stack)
+{
+    auto node = std::move(stack.back());
+    stack.pop_back();
+    return node;
+}
+
+template <typename T>
+NodePtr<Expression> makeBinary(NodeFactory& factory, std::vector<NodePtr<Expression>>& stack)
+{
+    auto lhs = pop(stack);
+    auto rhs = pop(stack);
+    return factory.make<T>(std::move(lhs), std::move(rhs));
+}
+
+} // namespace
+
+auto frontend::FlatAST::fromTree(const Expression& root) -> FlatAST
+{
+    // The nodes to append, the next one on top. An appended node stays below its
+    // children until they are all appended, then its end is known.
+    struct Frame {
+        const Expression* node;
+        Index index;
+    };
+    constexpr Index notAppended = std::numeric_limits<Index>::max();
+    FlatAST flat;
+    std::vector<Frame> frames{ { &root, notAppended } };
+    while (!frames.empty()) {
+        Frame& frame = frames.back();
+        if (frame.index != notAppended) {
+            flat.m_ends[frame.index] = static_cast<Index>(flat.size());
+            frames.pop_back();
+            continue;
+        }
+        const Expression& node = *frame.node;
+        frame.index = flat.append(node.nodeType(), node.from(), node.to(), payloadOf(node));
+        std::size_t first = frames.size();
+        forEachChild(node, [&](const Expression& child) { frames.push_back({ &child, notAppended }); });
+        std::reverse(frames.begin() + first, frames.end());
+    }
+    return flat;
+}
+
+auto frontend::FlatAST::toTree(Index root, NodeFactory factory) const -> NodePtr<Expression>
+{
+    if (root >= size()) return nullptr;
+    // In reverse preorder the children of a node are built before it,
+    // and they are on top of the stack with the first child last pushed.
+    std::vector<NodePtr<Expression>> stack;
+    for (Index node = m_ends[root]; node-- > root;) {
+        NodePtr<Expression> built;
+        switch (m_types[node]) {
+            case NodeType::Identifier:
+                built = factory.make<Identifier>(value(node), m_from[node], m_to[node]);
+                break;
+            case NodeType::NumericLiteral:
+                built = factory.make<NumericLiteral>(value(node), m_from[node], m_to[node]);
+                break;
+            case NodeType::StringLiteral:
+                built = factory.make<StringLiteral>(value(node), m_from[node], m_to[node]);
+                break;
+            case NodeType::ArrayLiteral: {
+                auto elements = factory.list();
+                elements.reserve(m_payloads[node]);
+                for (std::uint32_t i = 0; i < m_payloads[node]; ++i) {
+                    elements.push_back(pop(stack));
+                }
+                built = factory.make<ArrayLiteral>(std::move(elements), m_from[node], m_to[node]);
+                break;
+            }
+            case NodeType::MemberAccess: {
+                auto argument = pop(stack);
+                NodePtr<Identifier> identifier(static_cast<Identifier*>(pop(stack).release()));
+                built = factory.make<MemberAccess>(std::move(argument), std::move(identifier));
+                break;
+            }
+            case NodeType::FunctionCall: {
+                auto function = pop(stack);
+                auto arguments = factory.list();
+                arguments.reserve(m_payloads[node] - 1);
+                for (std::uint32_t i = 1; i < m_payloads[node]; ++i) {
+                    arguments.push_back(pop(stack));
+                }
+                built = factory.make<FunctionCall>(std::move(function), std::move(arguments), m_to[node]);
+                break;
+            }
+            case NodeType::SubscriptAccess: {
+                auto argument = pop(stack);
+                auto subscript = pop(stack);
+                built = factory.make<SubscriptAccess>(std::move(argument), std::move(subscript), m_to[node]);
+                break;
+            }
+            case NodeType::PostIncrement: built = factory.make<PostIncrement>(pop(stack), m_to[node]); break;
+            case NodeType::PostDecrement: built = factory.make<PostDecrement>(pop(stack), m_to[node]); break;
+            case NodeType::PreIncrement: built = factory.make<PreIncrement>(pop(stack), m_from[node]); break;
+            case NodeType::PreDecrement: built = factory.make<PreDecrement>(pop(stack), m_from[node]); break;
+            case NodeType::Negative: built = factory.make<Negative>(pop(stack), m_from[node]); break;
+            case NodeType::Positive: built = factory.make<Positive>(pop(stack), m_from[node]); break;
+            case NodeType::LogicalNegation: built = factory.make<LogicalNegation>(pop(stack), m_from[node]); break;
+            case NodeType::BitwiseNot: built = factory.make<BitwiseNot>(pop(stack), m_from[node]); break;
+            case NodeType::Addition: built = makeBinary<Addition>(factory, stack); break;
+            case NodeType::Subtraction: built = makeBinary<Subtraction>(factory, stack); break;
+            case NodeType::Multiplication: built = makeBinary<Multiplication>(factory, stack); break;
+            case NodeType::Division: built = makeBinary<Division>(factory, stack); break;
+            case NodeType::Remainder: built = makeBinary<Remainder>(factory, stack); break;
+            case NodeType::ShiftLeft: built = makeBinary<ShiftLeft>(factory, stack); break;
+            case NodeType::ShiftRight: built = makeBinary<ShiftRight>(factory, stack); break;
+            case NodeType::ShiftRightLogic: built = makeBinary<ShiftRightLogic>(factory, stack); break;
+            case NodeType::LessThan: built = makeBinary<LessThan>(factory, stack); break;
+            case NodeType::LessEquals: built = makeBinary<LessEquals>(factory, stack); break;
+            case NodeType::GreaterThan: built = makeBinary<GreaterThan>(factory, stack); break;
+            case NodeType::GreaterEquals: built = makeBinary<GreaterEquals>(factory, stack); break;
+            case NodeType::Equals: built = makeBinary<Equals>(factory, stack); break;
+            case NodeType::NotEquals: built = makeBinary<NotEquals>(factory, stack); break;
+        }
+        stack.push_back(std::move(built));
+    }
+    return stack.empty() ? nullptr : pop(stack);
+}
+
+std::size_t frontend::FlatAST::memoryUsage() const noexcept
+{
+    return m_types.capacity() * sizeof(NodeType)
+        + (m_from.capacity() + m_to.capacity() + m_ends.capacity() + m_payloads.capacity()) * sizeof(std::uint32_t);
+}
+
+auto frontend::FlatAST::append(NodeType type, std::size_t from, std::size_t to, std::uint32_t payload) -> Index
+{
+    if (to > std::numeric_limits<std::uint32_t>::max() || size() >= std::numeric_limits<Index>::max()) {
+        throw std::range_error("FlatAST: source offsets and node count are limited to 32 bits.");
+    }
+    m_types.push_back(type);
+    m_from.push_back(static_cast<std::uint32_t>(from));
+    m_to.push_back(static_cast<std::uint32_t>(to));
+    m_ends.push_back(0);
+    m_payloads.push_back(payload);
+    return static_cast<Index>(size() - 1);
+}
@@ -0,0 +1,285 @@
+#include "IncrementalParser.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <ranges>
+#include <utility>
+#include <vector>
+
+#include "Parser.hpp"
+#include "Visitor.hpp"
+
+namespace {
+
+using Index = frontend::TokenGapBuffer::Index;
+
+// The tokens [first, last] of a node, found from its offsets.
+struct TokenRange {
+    Index first;
+    Index last;
+};
+
+TokenRange tokenRange(const frontend::TokenGapBuffer& tokens, std::size_t from, std::size_t to)
+{
+    Index first = tokens.firstFrom(static_cast<std::uint32_t>(from));
+    Index end = tokens.firstFrom(static_cast<std::uint32_t>(to), first);
+    return { first, static_cast<Index>(end - 1) };
+}
+
+// A single edit covering all of them, so that the tokens are lexed again only once.
+frontend::TextEdit merge(std::span<const frontend::TextEdit> edits)
+{
+    if (edits.empty()) {
+        return { 0, 0, 0 };
+    }
+    frontend::TextEdit merged = { edits.front().from, edits.back().to, edits.back().to - edits.front().from };
+    for (const auto& edit : edits) {
+        merged.length += edit.length - (edit.to - edit.from);
+    }
+    return merged;
+}
+
+// Parses the tokens [begin, end) as one expression on the heap, tokens left over are an error.
+frontend::NodePtr<frontend::Expression> parse(const frontend::TokenGapBuffer& tokens, Index begin, Index end)
+{
+    auto slice = tokens.slice(begin, end);
+    frontend::Parser<frontend::TokenCursor> parser{ slice.cursor() };
+    return parser.parseExpressionInto({});
+}
+
+// The children by index, in the order of forEachChild(): the child holding an offset is
+// found by binary search, without walking the lists of wide nodes.
+std::size_t childCount(const frontend::ASTNode& node) noexcept
+{
+    return frontend::dispatch(node, [&]<typename T>(const T& typed) -> std::size_t {
+        if constexpr (std::same_as<T, frontend::ArrayLiteral>) {
+            return typed.elements().size();
+        } else if constexpr (std::same_as<T, frontend::FunctionCall>) {
+            return 1 + typed.arguments().size();
+        } else {
+            std::size_t count = 0;
+            frontend::forEachChild(node, [&](const frontend::Expression&) { ++count; });
+            return count;
+        }
+    });
+}
+
+frontend::ASTNode* childAt(frontend::ASTNode& node, std::size_t index) noexcept
+{
+    return frontend::dispatch(node, [&]<typename T>(T& typed) -> frontend::ASTNode* {
+        if constexpr (std::same_as<T, frontend::ArrayLiteral>) {
+            return typed.elements()[index].get();
+        } else if constexpr (std::same_as<T, frontend::FunctionCall>) {
+            // The accessors are const, the children of a mutable node are mutable too.
+            return index == 0 ? const_cast<frontend::Expression*>(&typed.function()) : typed.arguments()[index - 1].get();
+        } else {
+            frontend::ASTNode* found = nullptr;
+            std::size_t at = 0;
+            frontend::forEachChild(node, [&](frontend::Expression& child) {
+                if (at++ == index) found = &child;
+            });
+            return found;
+        }
+    });
+}
+
+} // namespace
+
+frontend::IncrementalParser::IncrementalParser(std::string_view text)
+    : m_tokens(text)
+    , m_tree(parse(m_tokens, 0, static_cast<Index>(m_tokens.size() - 1)))
+{
+}
+
+auto frontend::IncrementalParser::reparse(std::string_view text, std::span<const TextEdit> edits) -> Reparsed
+{
+    TextEdit edit = merge(edits);
+    TokenColumns lexed;
+    TokenGapBuffer::Change change = m_tokens.lex(text, edit, lexed);
+    auto delta = static_cast<std::ptrdiff_t>(edit.length) - static_cast<std::ptrdiff_t>(edit.to - edit.from);
+    auto tokenDelta = static_cast<std::ptrdiff_t>(change.newEnd) - static_cast<std::ptrdiff_t>(change.oldEnd);
+    // Every old token from oldEnd on moves by delta.
+    std::size_t boundary = m_tokens.from(change.oldEnd);
+
+    // The delimited children holding the changed tokens, from the outermost in, found with
+    // the offsets of the old text.
+    struct Slot {
+        ASTNode* parent;
+        std::size_t index;
+        TokenRange range;
+        // The number of nodes in path above the parent.
+        std::size_t depth;
+    };
+    std::vector<Slot> slots;
+    // The nodes holding the change, and the index of the child on the way to it.
+    std::vector<std::pair<ASTNode*, std::size_t>> path;
+    bool changed = change.first != change.oldEnd || change.first != change.newEnd;
+    auto holdsChange = [&](const TokenRange& range) {
+        return range.first <= change.first && change.oldEnd <= range.last + 1;
+    };
+    std::ptrdiff_t shift = 0;
+    for (ASTNode* node = changed ? m_tree.get() : nullptr; node != nullptr;) {
+        auto childRange = [&](std::size_t index) {
+            const ASTNode& child = *childAt(*node, index);
+            std::ptrdiff_t childShift = shift + pendingShift(*node, index);
+            return tokenRange(m_tokens, child.from() + childShift, child.to() + childShift);
+        };
+        // Children come in source order: only the first one not ending before the change can hold it.
+        auto indices = std::views::iota(std::size_t(0), childCount(*node));
+        auto next = static_cast<std::size_t>(std::ranges::partition_point(indices, [&](std::size_t index) {
+            return childRange(index).last + 1 < change.first;
+        }) - indices.begin());
+        // Only the function of a call or the argument of a subscript comes before the delimited children.
+        std::size_t delimited = next;
+        while (delimited < childCount(*node) && !delimitedChild(*node, delimited)) ++delimited;
+        if (delimited < childCount(*node) && holdsChange(childRange(delimited))) {
+            slots.push_back({ node, delimited, childRange(delimited), path.size() });
+        }
+        if (next < childCount(*node) && holdsChange(childRange(next))) {
+            path.emplace_back(node, next);
+            shift += pendingShift(*node, next);
+            node = childAt(*node, next);
+        } else {
+            node = nullptr;
+        }
+    }
+
+    // Lexed and parsed again with the new tokens, put back when the new text has an error.
+    std::string_view oldText = m_tokens.text();
+    TokenColumns removed = m_tokens.columns(change.first, change.oldEnd);
+    m_tokens.replace(change.first, change.oldEnd, lexed, text);
+    NodePtr<Expression> replacement;
+    const Slot* replaced = nullptr;
+    std::size_t reparsedTokens = 0;
+    // An edit can make a child spill over its delimiters, then the enclosing one is parsed.
+    for (auto slot = slots.rbegin(); slot != slots.rend() && !replacement; ++slot) {
+        auto end = static_cast<Index>(slot->range.last + 1 + tokenDelta);
+        try {
+            replacement = parse(m_tokens, slot->range.first, end);
+            replaced = &*slot;
+            reparsedTokens = end - slot->range.first;
+        } catch (std::exception&) {
+        }
+    }
+    std::size_t relexedTokens = change.newEnd - change.first;
+    if (changed && !replacement) {
+        auto end = static_cast<Index>(m_tokens.size() - 1);
+        try {
+            m_tree = parse(m_tokens, 0, end);
+        } catch (std::exception&) {
+            m_tokens.replace(change.first, change.newEnd, removed, oldText);
+            throw;
+        }
+        m_shifts.clear();
+        return { relexedTokens, end };
+    }
+
+    if (delta != 0) {
+        moveAfter(boundary, delta, replaced ? childAt(*replaced->parent, replaced->index) : nullptr);
+    }
+    if (replaced) {
+        NodePtr<Expression>& child = *delimitedChild(*replaced->parent, replaced->index);
+        // The pending shifts inside the old child go with it, the new one is stored off by
+        // the pending shift of its place, which moveAfter() may have changed.
+        std::vector<ASTNode*> pending{ child.get() };
+        while (!pending.empty()) {
+            ASTNode* node = pending.back();
+            pending.pop_back();
+            m_shifts.erase(node);
+            forEachChild(*node, [&](Expression& child) { pending.push_back(&child); });
+        }
+        std::ptrdiff_t shift = pendingShift(*replaced->parent, replaced->index);
+        for (std::size_t depth = 0; depth < replaced->depth; ++depth) {
+            shift += pendingShift(*path[depth].first, path[depth].second);
+        }
+        pending.push_back(replacement.get());
+        while (!pending.empty()) {
+            ASTNode* node = pending.back();
+            pending.pop_back();
+            node->shift(-shift);
+            forEachChild(*node, [&](Expression& child) { pending.push_back(&child); });
+        }
+        child = std::move(replacement);
+    }
+    return { relexedTokens, reparsedTokens };
+}
+
+auto frontend::IncrementalParser::tree() -> const Expression&
+{
+    if (!m_shifts.empty()) {
+        std::vector<std::pair<ASTNode*, std::ptrdiff_t>> pending{ { m_tree.get(), 0 } };
+        while (!pending.empty()) {
+            auto [node, shift] = pending.back();
+            pending.pop_back();
+            node->shift(shift);
+            auto shifts = m_shifts.find(node);
+            std::size_t index = 0;
+            forEachChild(*node, [&](Expression& child) {
+                std::ptrdiff_t childShift = shift;
+                if (shifts != m_shifts.end()) {
+                    for (const auto& entry : shifts->second) {
+                        if (entry.first <= index) childShift += entry.delta;
+                    }
+                }
+                pending.emplace_back(&child, childShift);
+                ++index;
+            });
+        }
+        m_shifts.clear();
+    }
+    return *m_tree;
+}
+
+auto frontend::IncrementalParser::pendingShift(const ASTNode& node, std::size_t child) const noexcept -> std::ptrdiff_t
+{
+    auto shifts = m_shifts.find(&node);
+    if (shifts == m_shifts.end()) {
+        return 0;
+    }
+    std::ptrdiff_t delta = 0;
+    for (const auto& shift : shifts->second) {
+        if (shift.first <= child) delta += shift.delta;
+    }
+    return delta;
+}
+
+void frontend::IncrementalParser::addShift(const ASTNode& node, std::size_t first, std::ptrdiff_t delta)
+{
+    auto& shifts = m_shifts[&node];
+    auto shift = std::ranges::find(shifts, first, &Shift::first);
+    if (shift != shifts.end()) {
+        shift->delta += delta;
+    } else {
+        shifts.push_back({ first, delta });
+    }
+}
+
+// Moves what starts from boundary, an offset of the old text, by delta. Only the nodes
+// holding the boundary are changed, every other one is moved by tree().
+void frontend::IncrementalParser::moveAfter(std::size_t boundary, std::ptrdiff_t delta, const ASTNode* replaced)
+{
+    ASTNode* node = m_tree.get();
+    if (node->from() >= boundary) {
+        node->shift(delta);
+        addShift(*node, 0, delta);
+        return;
+    }
+    std::ptrdiff_t shift = 0;
+    while (node != replaced && node->to() + shift > boundary) {
+        node->shiftEnd(delta);
+        auto indices = std::views::iota(std::size_t(0), childCount(*node));
+        auto moved = static_cast<std::size_t>(std::ranges::partition_point(indices, [&](std::size_t index) {
+            return childAt(*node, index)->from() + shift + pendingShift(*node, index) < boundary;
+        }) - indices.begin());
+        std::ptrdiff_t childShift = moved > 0 ? shift + pendingShift(*node, moved - 1) : 0;
+        if (moved < childCount(*node)) {
+            addShift(*node, moved, delta);
+        }
+        if (moved == 0) {
+            return;
+        }
+        node = childAt(*node, moved - 1);
+        shift = childShift;
+    }
+}
@@ -0,0 +1,124 @@
+#include "ParallelParser.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "BracketIndex.hpp"
+
+namespace {
+
+using Index = frontend::TokenStream::Index;
+
+// Whether a callee parsed alone is also the callee of the whole expression. Calls
+// bind tighter than prefix and binary operators, so -f(x) is -(f(x)), not (-f)(x).
+bool isCallee(const frontend::Expression& callee) noexcept
+{
+    using frontend::NodeType;
+    switch (callee.nodeType()) {
+        case NodeType::Identifier:
+        case NodeType::NumericLiteral:
+        case NodeType::StringLiteral:
+        case NodeType::ArrayLiteral:
+        case NodeType::MemberAccess:
+        case NodeType::FunctionCall:
+        case NodeType::SubscriptAccess:
+        case NodeType::PostIncrement:
+        case NodeType::PostDecrement:
+            return true;
+        default:
+            return false;
+    }
+}
+
+} // namespace
+
+auto frontend::ParallelParser::parseSequential(const TokenStream& stream) const -> ParseResult
+{
+    Parser<TokenCursor> parser{ TokenCursor(stream) };
+    return parser.parseExpressionInArena(m_options.arena);
+}
+
+auto frontend::ParallelParser::parse(const TokenStream& stream) const -> ParseResult
+{
+    // The list must close on the last token before EndOfFile.
+    if (stream.size() < 3) {
+        return parseSequential(stream);
+    }
+    Index last = static_cast<Index>(stream.size() - 2);
+    if (stream.type(last) != TokenType::CloseBracket && stream.type(last) != TokenType::CloseParenthesis) {
+        return parseSequential(stream);
+    }
+    BracketIndex brackets(stream);
+    Index open = brackets.match(last);
+    bool array = stream.type(last) == TokenType::CloseBracket && open == 0;
+    bool call = stream.type(last) == TokenType::CloseParenthesis && open != BracketIndex::none && open > 0;
+    if ((!array && !call) || open + 1 == last) {
+        return parseSequential(stream);
+    }
+    std::vector<Index> commas = brackets.commas(open);
+    std::size_t elements = commas.size() + 1;
+    if (elements < m_options.minimumElements) {
+        return parseSequential(stream);
+    }
+
+    // Declared first: the nodes in the lists below are checked by NodeDeleter.
+    auto arena = std::make_unique<Arena>(m_options.arena);
+    std::size_t chunks = std::min(elements, m_pool->size() * std::max<std::size_t>(m_options.chunksPerThread, 1));
+    std::vector<std::unique_ptr<Arena>> arenas(chunks);
+    NodeFactory factory(arena.get());
+    NodePtr<Expression> callee;
+    if (call) {
+        try {
+            Parser<TokenCursor> parser{ TokenCursor(stream, 0, open) };
+            callee = parser.parseExpressionInto(arena.get());
+        } catch (std::exception&) {
+            return parseSequential(stream);
+        }
+        if (!isCallee(*callee)) {
+            return parseSequential(stream);
+        }
+    }
+
+    // Element i spans the tokens [elementBegin(i), elementEnd(i)).
+    auto elementBegin = [&](std::size_t i) { return i == 0 ? open + 1 : commas[i - 1] + 1; };
+    auto elementEnd = [&](std::size_t i) { return i == commas.size() ? last : commas[i]; };
+    NodeList list = factory.list();
+    list.resize(elements);
+    std::atomic<bool> failed = false;
+    m_pool->parallelFor(chunks, [&](std::size_t chunk) {
+        std::size_t first = elements * chunk / chunks;
+        std::size_t end = elements * (chunk + 1) / chunks;
+        arenas[chunk] = std::make_unique<Arena>(m_options.arena);
+        try {
+            Parser<TokenCursor> parser{ TokenCursor(stream, elementBegin(first), elementEnd(end - 1)) };
+            NodeList parsed = parser.parseListInto(arenas[chunk].get());
+            // An empty element parses into nothing.
+            if (parsed.size() != end - first) {
+                failed.store(true, std::memory_order_relaxed);
+                return;
+            }
+            std::move(parsed.begin(), parsed.end(), list.begin() + first);
+        } catch (std::exception&) {
+            failed.store(true, std::memory_order_relaxed);
+        }
+    });
+    if (failed.load(std::memory_order_relaxed)) {
+        // Reports the error exactly where the sequential parser finds it.
+        return parseSequential(stream);
+    }
+
+    NodePtr<Expression> root;
+    if (array) {
+        root = factory.make<ArrayLiteral>(std::move(list), stream.from(open), stream.to(last));
+    } else {
+        root = factory.make<FunctionCall>(std::move(callee), std::move(list), stream.to(last));
+    }
+    for (auto& chunkArena : arenas) {
+        arena->adopt(std::move(*chunkArena));
+    }
+    return ParseResult(std::move(arena), std::move(root));
+}
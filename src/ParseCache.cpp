@@ -0,0 +1,118 @@
+#include "ParseCache.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+
+#include "Lexer.hpp"
+#include "Source.hpp"
+
+namespace {
+
+// Roughly the arena bytes of a tree per byte of its text, and the smallest first chunk.
+constexpr std::size_t arenaBytesPerTextByte = 32;
+constexpr std::size_t minimumChunkSize = 128;
+
+} // namespace
+
+frontend::ParseCache::ParseCache(Options options)
+    : m_options(options)
+    , m_shardBytes(options.maxBytes / std::max<std::size_t>(options.shards, 1))
+    , m_hits(0)
+    , m_misses(0)
+    , m_evictions(0)
+{
+    for (std::size_t i = 0; i < std::max<std::size_t>(options.shards, 1); ++i) {
+        m_shards.push_back(std::make_unique<Shard>());
+    }
+}
+
+auto frontend::ParseCache::find(Shard& shard, std::string_view text, std::size_t hash) noexcept -> Lru::iterator
+{
+    auto [begin, end] = shard.entries.equal_range(hash);
+    for (auto found = begin; found != end; ++found) {
+        if (found->second->text == text) {
+            return found->second;
+        }
+    }
+    return shard.lru.end();
+}
+
+auto frontend::ParseCache::parse(std::string_view text) -> std::shared_ptr<const ParseResult>
+{
+    std::size_t hash = std::hash<std::string_view>{}(text);
+    Shard& shard = shardOf(hash);
+    {
+        std::lock_guard lock(shard.mutex);
+        auto found = find(shard, text, hash);
+        if (found != shard.lru.end()) {
+            shard.lru.splice(shard.lru.begin(), shard.lru, found);
+            m_hits.fetch_add(1, std::memory_order_relaxed);
+            return found->result;
+        }
+    }
+    m_misses.fetch_add(1, std::memory_order_relaxed);
+    // Parsed without the lock, other texts of the shard are served meanwhile.
+    using BufferLexer = Lexer<2, BufferSource>;
+    Parser<BufferLexer> parser{ BufferLexer(BufferSource(text)) };
+    // A small tree gets a small first chunk, a larger one grows into more chunks.
+    Arena::Options arena = m_options.arena;
+    arena.chunkSize = std::clamp(text.size() * arenaBytesPerTextByte, minimumChunkSize,
+        std::max(m_options.arena.chunkSize, minimumChunkSize));
+    // The tree of the whole text: tokens left after the expression are an error, not cached.
+    auto owned = std::make_unique<Arena>(arena);
+    auto root = parser.parseExpressionInto(NodeFactory(owned.get()));
+    auto result = std::make_shared<const ParseResult>(std::move(owned), std::move(root));
+    // Charged for the whole chunks of the arena.
+    std::size_t bytes = sizeof(Entry) + text.size() + sizeof(ParseResult) + sizeof(Arena) + result->arena()->reservedBytes();
+
+    std::lock_guard lock(shard.mutex);
+    // Another thread may have parsed the same text first, keep its tree.
+    auto found = find(shard, text, hash);
+    if (found != shard.lru.end()) {
+        shard.lru.splice(shard.lru.begin(), shard.lru, found);
+        return found->result;
+    }
+    if (bytes > m_shardBytes) {
+        return result;
+    }
+    shard.lru.push_front({ std::string(text), hash, bytes, result });
+    shard.entries.emplace(hash, shard.lru.begin());
+    shard.bytes += bytes;
+    while (shard.bytes > m_shardBytes) {
+        Entry& oldest = shard.lru.back();
+        auto [begin, end] = shard.entries.equal_range(oldest.hash);
+        shard.entries.erase(std::find_if(begin, end, [&](const auto& entry) { return &*entry.second == &oldest; }));
+        shard.bytes -= oldest.bytes;
+        shard.lru.pop_back();
+        m_evictions.fetch_add(1, std::memory_order_relaxed);
+    }
+    return result;
+}
+
+auto frontend::ParseCache::stats() const -> Stats
+{
+    Stats stats = {
+        m_hits.load(std::memory_order_relaxed),
+        m_misses.load(std::memory_order_relaxed),
+        m_evictions.load(std::memory_order_relaxed),
+        0,
+        0
+    };
+    for (const auto& shard : m_shards) {
+        std::lock_guard lock(shard->mutex);
+        stats.entries += shard->lru.size();
+        stats.bytes += shard->bytes;
+    }
+    return stats;
+}
+
+void frontend::ParseCache::clear()
+{
+    for (auto& shard : m_shards) {
+        std::lock_guard lock(shard->mutex);
+        shard->entries.clear();
+        shard->lru.clear();
+        shard->bytes = 0;
+    }
+}
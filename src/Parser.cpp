@@ -1,280 +1,223 @@
 #include "Parser.hpp"
 
+#include <string>
 #include <utility>
+#include <vector>
 
-auto frontend::Parser::parseList(TokenType delimiter) -> std::vector<std::unique_ptr<Expression>>
+template <typename LexerType>
+void frontend::Parser<LexerType>::throwExpected(std::string_view expected)
 {
-    std::vector<std::unique_ptr<Expression>> list;
-    // Check for immediate termination.
-    if (m_lexer.peek().type == delimiter) {
-        return list;
-    }
-    // There is, at least, one element.
-    list.push_back(std::move(parseEquality()));
-    auto opType = m_lexer.peek().type;
-    while (opType == TokenType::Comma) {
-        m_lexer.skip();
-        list.push_back(std::move(parseEquality()));
-        opType = m_lexer.peek().type;
-    }
-    // Should have reached delimiter, check should be done by the caller.
-    return list;
+    const auto& token = m_lexer.peek();
+    throw std::runtime_error(
+        "Expected " + std::string(expected) + ", but got '" +
+        std::string(m_lexer.lexeme(token)) +
+        "' from " + std::to_string(token.from) +
+        " to " + std::to_string(token.to) + "."
+    );
 }
 
-auto frontend::Parser::parseEquality() -> std::unique_ptr<Expression>
+template <typename LexerType>
+bool frontend::Parser<LexerType>::skipSeparators()
 {
-    auto lhs = parseRelational();
-    auto opType = m_lexer.peek().type;
-    while (opType == TokenType::DoubleEquals || opType == TokenType::ExclamationEquals) {
+    while (m_lexer.peek().type == TokenType::Semicolon) {
         m_lexer.skip();
-        auto rhs = parseRelational();
-        if (opType == TokenType::DoubleEquals) {
-            lhs = std::make_unique<Equals>(std::move(lhs), std::move(rhs));
-        } else {
-            lhs = std::make_unique<NotEquals>(std::move(lhs), std::move(rhs));
-        }
-        opType = m_lexer.peek().type;
     }
-    return lhs;
+    return m_lexer.peek().type != TokenType::EndOfFile;
 }
 
-auto frontend::Parser::parseRelational() -> std::unique_ptr<Expression>
+template <typename LexerType>
+void frontend::Parser<LexerType>::expectSeparator()
 {
-    auto lhs = parseShift();
-    auto opType = m_lexer.peek().type;
-    while (
-        opType == TokenType::LessThan ||
-        opType == TokenType::LessEquals ||
-        opType == TokenType::GreaterThan ||
-        opType == TokenType::GreaterEquals
-    ) {
-        m_lexer.skip();
-        auto rhs = parseShift();
-        if (opType == TokenType::LessThan) {
-            lhs = std::make_unique<LessThan>(std::move(lhs), std::move(rhs));
-        } else if (opType == TokenType::LessEquals) {
-            lhs = std::make_unique<LessEquals>(std::move(lhs), std::move(rhs));
-        } else if (opType == TokenType::GreaterThan) {
-            lhs = std::make_unique<GreaterThan>(std::move(lhs), std::move(rhs));
-        } else {
-            lhs = std::make_unique<GreaterEquals>(std::move(lhs), std::move(rhs));
-        }
-        opType = m_lexer.peek().type;
+    auto type = m_lexer.peek().type;
+    if (type != TokenType::Semicolon && type != TokenType::EndOfFile && !atLineBreak()) {
+        throwExpected("';' or a line break");
     }
-    return lhs;
 }
 
-auto frontend::Parser::parseShift() -> std::unique_ptr<Expression>
+template <typename LexerType>
+auto frontend::Parser<LexerType>::parseNext() -> NodePtr<Expression>
 {
-    auto lhs = parseAdditive();
-    auto opType = m_lexer.peek().type;
-    while (opType == TokenType::DoubleLessThan || opType == TokenType::DoubleGreaterThan || opType == TokenType::TripleGreaterThan) {
-        m_lexer.skip();
-        auto rhs = parseAdditive();
-        if (opType == TokenType::DoubleLessThan) {
-            lhs = std::make_unique<ShiftLeft>(std::move(lhs), std::move(rhs));
-        } else if (opType == TokenType::DoubleGreaterThan) {
-            lhs = std::make_unique<ShiftRight>(std::move(lhs), std::move(rhs));
-        } else {
-            lhs = std::make_unique<ShiftRightLogic>(std::move(lhs), std::move(rhs));
-        }
-        opType = m_lexer.peek().type;
+    if (!skipSeparators()) {
+        return nullptr;
     }
-    return lhs;
+    begin(true);
+    auto expression = parseOperators(0);
+    expectSeparator();
+    return expression;
 }
 
-auto frontend::Parser::parseAdditive() -> std::unique_ptr<Expression>
+template <typename LexerType>
+auto frontend::Parser<LexerType>::parseAll() -> std::vector<NodePtr<Expression>>
 {
-    auto lhs = parseMultiplicative();
-    auto opType = m_lexer.peek().type;
-    while (opType == TokenType::Plus || opType == TokenType::Minus) {
-        m_lexer.skip();
-        auto rhs = parseMultiplicative();
-        if (opType == TokenType::Plus) {
-            lhs = std::make_unique<Addition>(std::move(lhs), std::move(rhs));
-        } else {
-            lhs = std::make_unique<Subtraction>(std::move(lhs), std::move(rhs));
-        }
-        opType = m_lexer.peek().type;
+    std::vector<NodePtr<Expression>> expressions;
+    while (auto expression = parseNext()) {
+        expressions.push_back(std::move(expression));
     }
-    return lhs;
+    return expressions;
 }
 
-auto frontend::Parser::parseMultiplicative() -> std::unique_ptr<Expression>
+template <typename LexerType>
+auto frontend::Parser<LexerType>::parseNext(Arena& arena) -> const Expression*
 {
-    auto lhs = parseUnaryRightAssociative();
-    auto opType = m_lexer.peek().type;
-    while (opType == TokenType::Star || opType == TokenType::Slash || opType == TokenType::Percent) {
-        m_lexer.skip();
-        auto rhs = parseUnaryRightAssociative();
-        if (opType == TokenType::Star) {
-            lhs = std::make_unique<Multiplication>(std::move(lhs), std::move(rhs));
-        } else if (opType == TokenType::Slash) {
-            lhs = std::make_unique<Division>(std::move(lhs), std::move(rhs));
-        } else {
-            lhs = std::make_unique<Remainder>(std::move(lhs), std::move(rhs));
-        }
-        opType = m_lexer.peek().type;
+    if (!skipSeparators()) {
+        return nullptr;
+    }
+    arena.reset();
+    begin(true);
+    m_factory = NodeFactory(&arena);
+    NodePtr<Expression> root;
+    try {
+        root = parseOperators(0);
+        expectSeparator();
+    } catch (...) {
+        m_factory = NodeFactory();
+        throw;
     }
-    return lhs;
+    m_factory = NodeFactory();
+    // Arena nodes are never deleted one by one, the arena owns the tree.
+    return root.release();
 }
 
-auto frontend::Parser::parseUnaryRightAssociative() -> std::unique_ptr<Expression>
+template <typename LexerType>
+auto frontend::Parser<LexerType>::parseExpressionInto(NodeFactory factory) -> NodePtr<Expression>
 {
+    return parseInto(factory, [this] { return parseOperators(0); });
+}
+
+template <typename LexerType>
+auto frontend::Parser<LexerType>::parseListInto(NodeFactory factory) -> NodeList
+{
+    return parseInto(factory, [this] { return parseList(TokenType::EndOfFile); });
+}
+
+template <typename LexerType>
+auto frontend::Parser<LexerType>::parseList(TokenType delimiter) -> NodeList
+{
+    NodeList list = m_factory.list();
+    // Check for immediate termination.
+    if (m_lexer.peek().type == delimiter) {
+        return list;
+    }
+    ++m_nesting;
+    // There is, at least, one element.
+    list.push_back(std::move(parseOperators(0)));
     auto opType = m_lexer.peek().type;
-    switch (opType) {
-        case TokenType::Increment: {
-            std::size_t from = m_lexer.peek().from;
-            m_lexer.skip();
-            return std::make_unique<PreIncrement>(std::move(parseUnaryRightAssociative()), from);
-        }
-        case TokenType::Decrement: {
-            std::size_t from = m_lexer.peek().from;
-            m_lexer.skip();
-            return std::make_unique<PreDecrement>(std::move(parseUnaryRightAssociative()), from);
-        }
-        case TokenType::Plus: {
-            std::size_t from = m_lexer.peek().from;
-            m_lexer.skip();
-            return std::make_unique<Negative>(std::move(parseUnaryRightAssociative()), from);
-        }
-        case TokenType::Minus: {
-            std::size_t from = m_lexer.peek().from;
-            m_lexer.skip();
-            return std::make_unique<Positive>(std::move(parseUnaryRightAssociative()), from);
-        }
-        case TokenType::Exclamation: {
-            std::size_t from = m_lexer.peek().from;
-            m_lexer.skip();
-            return std::make_unique<LogicalNegation>(std::move(parseUnaryRightAssociative()), from);
-        }
-        case TokenType::Tilde: {
-            std::size_t from = m_lexer.peek().from;
-            m_lexer.skip();
-            return std::make_unique<BitwiseNot>(std::move(parseUnaryRightAssociative()), from);
-        }
-        default:
-            return parseUnaryLeftAssociative();
+    while (opType == TokenType::Comma) {
+        m_lexer.skip();
+        list.push_back(std::move(parseOperators(0)));
+        opType = m_lexer.peek().type;
     }
+    --m_nesting;
+    // Should have reached delimiter, check should be done by the caller.
+    return list;
 }
 
-auto frontend::Parser::parseUnaryLeftAssociative() -> std::unique_ptr<Expression>
+template <typename LexerType>
+auto frontend::Parser<LexerType>::parseOperators(std::uint8_t minimumPower) -> NodePtr<Expression>
 {
-    // By precondition, there should be some term.
-    auto target = parseTerminal();
-    auto opType = m_lexer.peek().type;
-    // TODO: extend the supported operators.
-    while (
-        opType == TokenType::Dot ||
-        opType == TokenType::OpenParenthesis ||
-        opType == TokenType::OpenBracket ||
-        opType == TokenType::Increment ||
-        opType == TokenType::Decrement
-    ) {
-        switch (opType) {
-            case TokenType::Dot: {
+    auto lhs = parsePrefix();
+    while (true) {
+        const auto& entry = operatorEntry(m_lexer.peek().type);
+        // Operators of the same power stop here, which makes them left-associative.
+        if (entry.infixPower <= minimumPower || atLineBreak()) {
+            return lhs;
+        }
+        switch (entry.infixKind) {
+            case InfixKind::Binary: {
+                m_lexer.skip();
+                auto rhs = parseOperators(entry.infixPower);
+                lhs = entry.infix(m_factory, std::move(lhs), std::move(rhs));
+                break;
+            }
+            case InfixKind::Postfix: {
+                // Put the 'to' from '++' or '--'.
+                lhs = entry.postfix(m_factory, std::move(lhs), m_lexer.peek().to);
+                m_lexer.skip();
+                break;
+            }
+            case InfixKind::MemberAccess: {
                 // Skip '.';
                 m_lexer.skip();
                 if (m_lexer.peek().type != TokenType::Identifier) {
-                    throw std::runtime_error(
-                        "Expected identifier, but got '" +
-                        m_lexer.peek().lexeme.str() +
-                        "' from " + std::to_string(m_lexer.peek().from) +
-                        " to " + std::to_string(m_lexer.peek().to) + "."
-                    );
+                    throwExpected("identifier");
                 }
-                auto identifier = std::make_unique<Identifier>(m_lexer.peek().lexeme, m_lexer.peek().from, m_lexer.peek().to);
-                target = std::make_unique<MemberAccess>(std::move(target), std::move(identifier));
+                auto identifier = m_factory.make<Identifier>(m_lexer.lexeme(m_lexer.peek()), m_lexer.peek().from, m_lexer.peek().to);
+                lhs = m_factory.make<MemberAccess>(std::move(lhs), std::move(identifier));
                 // Skip identifier.
                 m_lexer.skip();
                 break;
             }
-            case TokenType::OpenParenthesis: {
+            case InfixKind::FunctionCall: {
                 // Skip '(';
                 m_lexer.skip();
                 auto arguments = parseList(TokenType::CloseParenthesis);
                 if (m_lexer.peek().type != TokenType::CloseParenthesis) {
-                    throw std::runtime_error(
-                        "Expected ')', but got '" +
-                        m_lexer.peek().lexeme.str() +
-                        "' from " + std::to_string(m_lexer.peek().from) +
-                        " to " + std::to_string(m_lexer.peek().to) + "."
-                    );
+                    throwExpected("')'");
                 }
                 // Put the 'to' from ')'.
-                target = std::make_unique<FunctionCall>(std::move(target), std::move(arguments), m_lexer.peek().to);
+                lhs = m_factory.make<FunctionCall>(std::move(lhs), std::move(arguments), m_lexer.peek().to);
                 // Skip ')'.
                 m_lexer.skip();
                 break;
             }
-            case TokenType::OpenBracket: {
+            case InfixKind::SubscriptAccess: {
                 // Skip '['.
                 m_lexer.skip();
-                auto subscript = parseExpression();
+                ++m_nesting;
+                auto subscript = parseOperators(0);
+                --m_nesting;
                 if (m_lexer.peek().type != TokenType::CloseBracket) {
-                    throw std::runtime_error(
-                        "Expected ']', but got '" +
-                        m_lexer.peek().lexeme.str() +
-                        "' from " + std::to_string(m_lexer.peek().from) +
-                        " to " + std::to_string(m_lexer.peek().to) + "."
-                    );
+                    throwExpected("']'");
                 }
                 // Put the 'to' from ']'.
-                target = std::make_unique<SubscriptAccess>(std::move(target), std::move(subscript), m_lexer.peek().to);
+                lhs = m_factory.make<SubscriptAccess>(std::move(lhs), std::move(subscript), m_lexer.peek().to);
                 // Skip ']'.
                 m_lexer.skip();
                 break;
             }
-            case TokenType::Increment: {
-                // Put the 'to' from '++'.
-                target = std::make_unique<PostIncrement>(std::move(target), m_lexer.peek().to);
-                // Skip '++'.
-                m_lexer.skip();
-                break;
-            }
-            case TokenType::Decrement: {
-                // Put the 'to' from '--'.
-                target = std::make_unique<PostDecrement>(std::move(target), m_lexer.peek().to);
-                // Skip '--'.
-                m_lexer.skip();
-                break;
-            }
-            // Should never reach default.
-	    default: std::unreachable();
+            // A non-zero power always comes with a kind.
+            case InfixKind::None: std::unreachable();
         }
-        opType = m_lexer.peek().type;
     }
-    return target;
 }
 
-auto frontend::Parser::parseTerminal() -> std::unique_ptr<Expression>
+template <typename LexerType>
+auto frontend::Parser<LexerType>::parsePrefix() -> NodePtr<Expression>
 {
-    auto type = m_lexer.peek().type;
-    if (type == TokenType::Identifier) {
-        auto node = std::make_unique<Identifier>(m_lexer.peek().lexeme, m_lexer.peek().from, m_lexer.peek().to);
-        m_lexer.skip();
-        return node;
-    } else if (type == TokenType::NumericLiteral) {
-        auto node = std::make_unique<NumericLiteral>(m_lexer.peek().lexeme, m_lexer.peek().from, m_lexer.peek().to);
-        m_lexer.skip();
-        return node;
-    } else if (type == TokenType::StringLiteral) {
-        auto node = std::make_unique<StringLiteral>(m_lexer.peek().lexeme, m_lexer.peek().from, m_lexer.peek().to);
-        m_lexer.skip();
-        return node;
-    } else if (type == TokenType::OpenBracket) {
-        return parseArrayLiteral();
-    } else {
-        throw std::runtime_error(
-            "Expected terminal, but got '" +
-            m_lexer.peek().lexeme.str() +
-            "' from " + std::to_string(m_lexer.peek().from) +
-            " to " + std::to_string(m_lexer.peek().to) + "."
-        );
+    const auto& token = m_lexer.peek();
+    switch (token.type) {
+        case TokenType::Identifier: {
+            auto node = m_factory.make<Identifier>(m_lexer.lexeme(token), token.from, token.to);
+            m_lexer.skip();
+            return node;
+        }
+        case TokenType::NumericLiteral: {
+            auto node = m_factory.make<NumericLiteral>(m_lexer.lexeme(token), token.from, token.to);
+            m_lexer.skip();
+            return node;
+        }
+        case TokenType::StringLiteral: {
+            auto node = m_factory.make<StringLiteral>(m_lexer.lexeme(token), token.from, token.to);
+            m_lexer.skip();
+            return node;
+        }
+        case TokenType::OpenBracket:
+            return parseArrayLiteral();
+        default: {
+            const auto& entry = operatorEntry(token.type);
+            if (entry.prefix == nullptr) {
+                throwExpected("terminal");
+            }
+            std::size_t from = token.from;
+            m_lexer.skip();
+            auto argument = parseOperators(entry.prefixPower);
+            return entry.prefix(m_factory, std::move(argument), from);
+        }
     }
 }
 
-auto frontend::Parser::parseArrayLiteral() -> std::unique_ptr<Expression>
+template <typename LexerType>
+auto frontend::Parser<LexerType>::parseArrayLiteral() -> NodePtr<Expression>
 {
     // Save the 'from' from '['.
     std::size_t from = m_lexer.peek().from;
@@ -283,16 +226,188 @@ auto frontend::Parser::parseArrayLiteral() -> std::unique_ptr<Expression>
     auto array = parseList(TokenType::CloseBracket);
     // Assert that the next token is a ']'.
     if (m_lexer.peek().type != TokenType::CloseBracket) {
-        throw std::runtime_error(
-            "Expected ']', but got '" +
-            m_lexer.peek().lexeme.str() +
-            "' from " + std::to_string(m_lexer.peek().from) +
-            " to " + std::to_string(m_lexer.peek().to) + "."
-        );
+        throwExpected("']'");
     }
     // Save the 'to' from ']'.
     std::size_t to = m_lexer.peek().to;
     // Skip ']'.
     m_lexer.skip();
-    return std::make_unique<ArrayLiteral>(std::move(array), from, to);
+    return m_factory.make<ArrayLiteral>(std::move(array), from, to);
+}
+
+template <typename LexerType>
+auto frontend::Parser<LexerType>::parseIterative() -> NodePtr<Expression>
+{
+    // The recursive parser unrolled: Prefix reads an operand, Continue extends the
+    // value with the operators of the top frame, Return hands a finished value to
+    // the frame waiting for it.
+    enum class State { Prefix, Continue, Return };
+    State state = State::Prefix;
+    std::vector<Frame> stack;
+    stack.push_back(frame(Frame::Kind::Operators));
+    NodePtr<Expression> value;
+    while (true) {
+        switch (state) {
+            case State::Prefix: {
+                const auto& token = m_lexer.peek();
+                switch (token.type) {
+                    case TokenType::Identifier:
+                        value = m_factory.make<Identifier>(m_lexer.lexeme(token), token.from, token.to);
+                        m_lexer.skip();
+                        state = State::Continue;
+                        break;
+                    case TokenType::NumericLiteral:
+                        value = m_factory.make<NumericLiteral>(m_lexer.lexeme(token), token.from, token.to);
+                        m_lexer.skip();
+                        state = State::Continue;
+                        break;
+                    case TokenType::StringLiteral:
+                        value = m_factory.make<StringLiteral>(m_lexer.lexeme(token), token.from, token.to);
+                        m_lexer.skip();
+                        state = State::Continue;
+                        break;
+                    case TokenType::OpenBracket: {
+                        std::size_t from = token.from;
+                        // Skip '['.
+                        m_lexer.skip();
+                        if (m_lexer.peek().type == TokenType::CloseBracket) {
+                            value = m_factory.make<ArrayLiteral>(m_factory.list(), from, m_lexer.peek().to);
+                            m_lexer.skip();
+                            state = State::Continue;
+                        } else {
+                            ++m_nesting;
+                            stack.push_back(frame(Frame::Kind::Array, 0, nullptr, from));
+                            stack.push_back(frame(Frame::Kind::Operators));
+                        }
+                        break;
+                    }
+                    default: {
+                        const auto& entry = operatorEntry(token.type);
+                        if (entry.prefix == nullptr) {
+                            throwExpected("terminal");
+                        }
+                        stack.push_back(frame(Frame::Kind::Prefix, 0, &entry, token.from));
+                        m_lexer.skip();
+                        stack.push_back(frame(Frame::Kind::Operators, entry.prefixPower));
+                        break;
+                    }
+                }
+                break;
+            }
+            case State::Continue: {
+                Frame& top = stack.back();
+                const auto& entry = operatorEntry(m_lexer.peek().type);
+                if (entry.infixPower <= top.power || atLineBreak()) {
+                    stack.pop_back();
+                    state = State::Return;
+                    break;
+                }
+                switch (entry.infixKind) {
+                    case InfixKind::Binary:
+                        m_lexer.skip();
+                        top.pending = InfixKind::Binary;
+                        top.entry = &entry;
+                        top.node = std::move(value);
+                        stack.push_back(frame(Frame::Kind::Operators, entry.infixPower));
+                        state = State::Prefix;
+                        break;
+                    case InfixKind::Postfix:
+                        value = entry.postfix(m_factory, std::move(value), m_lexer.peek().to);
+                        m_lexer.skip();
+                        break;
+                    case InfixKind::MemberAccess: {
+                        m_lexer.skip();
+                        if (m_lexer.peek().type != TokenType::Identifier) {
+                            throwExpected("identifier");
+                        }
+                        auto identifier = m_factory.make<Identifier>(m_lexer.lexeme(m_lexer.peek()), m_lexer.peek().from, m_lexer.peek().to);
+                        value = m_factory.make<MemberAccess>(std::move(value), std::move(identifier));
+                        m_lexer.skip();
+                        break;
+                    }
+                    case InfixKind::FunctionCall:
+                        m_lexer.skip();
+                        if (m_lexer.peek().type == TokenType::CloseParenthesis) {
+                            value = m_factory.make<FunctionCall>(std::move(value), m_factory.list(), m_lexer.peek().to);
+                            m_lexer.skip();
+                            break;
+                        }
+                        ++m_nesting;
+                        top.pending = InfixKind::FunctionCall;
+                        top.node = std::move(value);
+                        stack.push_back(frame(Frame::Kind::Operators));
+                        state = State::Prefix;
+                        break;
+                    case InfixKind::SubscriptAccess:
+                        m_lexer.skip();
+                        ++m_nesting;
+                        top.pending = InfixKind::SubscriptAccess;
+                        top.node = std::move(value);
+                        stack.push_back(frame(Frame::Kind::Operators));
+                        state = State::Prefix;
+                        break;
+                    case InfixKind::None: std::unreachable();
+                }
+                break;
+            }
+            case State::Return: {
+                if (stack.empty()) {
+                    return value;
+                }
+                Frame& top = stack.back();
+                if (top.kind == Frame::Kind::Prefix) {
+                    value = top.entry->prefix(m_factory, std::move(value), top.from);
+                    stack.pop_back();
+                    state = State::Continue;
+                } else if (top.kind == Frame::Kind::Array || top.pending == InfixKind::FunctionCall) {
+                    top.list.push_back(std::move(value));
+                    if (m_lexer.peek().type == TokenType::Comma) {
+                        m_lexer.skip();
+                        stack.push_back(frame(Frame::Kind::Operators));
+                        state = State::Prefix;
+                        break;
+                    }
+                    if (top.kind == Frame::Kind::Array) {
+                        if (m_lexer.peek().type != TokenType::CloseBracket) {
+                            throwExpected("']'");
+                        }
+                        value = m_factory.make<ArrayLiteral>(std::move(top.list), top.from, m_lexer.peek().to);
+                        m_lexer.skip();
+                        stack.pop_back();
+                        --m_nesting;
+                    } else {
+                        if (m_lexer.peek().type != TokenType::CloseParenthesis) {
+                            throwExpected("')'");
+                        }
+                        value = m_factory.make<FunctionCall>(std::move(top.node), std::move(top.list), m_lexer.peek().to);
+                        m_lexer.skip();
+                        --m_nesting;
+                        top.pending = InfixKind::None;
+                        top.list.clear();
+                    }
+                    state = State::Continue;
+                } else if (top.pending == InfixKind::SubscriptAccess) {
+                    if (m_lexer.peek().type != TokenType::CloseBracket) {
+                        throwExpected("']'");
+                    }
+                    value = m_factory.make<SubscriptAccess>(std::move(top.node), std::move(value), m_lexer.peek().to);
+                    m_lexer.skip();
+                    --m_nesting;
+                    top.pending = InfixKind::None;
+                    state = State::Continue;
+                } else {
+                    // A binary operator waiting for its rhs.
+                    value = top.entry->infix(m_factory, std::move(top.node), std::move(value));
+                    top.pending = InfixKind::None;
+                    state = State::Continue;
+                }
+                break;
+            }
+        }
+    }
 }
+
+template class frontend::Parser<frontend::Lexer<2, frontend::StreamSource>>;
+template class frontend::Parser<frontend::Lexer<2, frontend::BufferSource>>;
+template class frontend::Parser<frontend::Lexer<2, frontend::MappedFileSource>>;
+template class frontend::Parser<frontend::TokenCursor>;
@@ -0,0 +1,274 @@
+#include "Scanner.hpp"
+
+#include <atomic>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define FRONTEND_SCANNER_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+using namespace frontend::scanner;
+
+// Locale-free character classes.
+bool isWhitespace(unsigned char c) noexcept { return c == ' ' || static_cast<unsigned>(c - '\t') <= 4u; }
+bool isDigit(unsigned char c) noexcept { return static_cast<unsigned>(c - '0') <= 9u; }
+bool isIdentifierChar(unsigned char c) noexcept
+{
+    return static_cast<unsigned>((c | 0x20) - 'a') <= 25u || isDigit(c) || c == '_';
+}
+
+template <bool (*inClass)(unsigned char) noexcept>
+const char* skipScalar(const char* p, const char* end) noexcept
+{
+    while (p != end && inClass(static_cast<unsigned char>(*p))) ++p;
+    return p;
+}
+
+const char* findLineEndScalar(const char* p, const char* end) noexcept
+{
+    while (p != end && *p != '\n') ++p;
+    return p;
+}
+
+const char* findBlockCommentEndScalar(const char* p, const char* end) noexcept
+{
+    for (; end - p >= 2; ++p) {
+        if (p[0] == '*' && p[1] == '/') return p + 2;
+    }
+    return nullptr;
+}
+
+struct Kernels {
+    const char* (*skipWhitespace)(const char*, const char*) noexcept;
+    const char* (*findLineEnd)(const char*, const char*) noexcept;
+    const char* (*findBlockCommentEnd)(const char*, const char*) noexcept;
+    const char* (*skipIdentifier)(const char*, const char*) noexcept;
+    const char* (*skipDigits)(const char*, const char*) noexcept;
+};
+
+constexpr Kernels scalarKernels = {
+    skipScalar<isWhitespace>,
+    findLineEndScalar,
+    findBlockCommentEndScalar,
+    skipScalar<isIdentifierChar>,
+    skipScalar<isDigit>
+};
+
+#ifdef FRONTEND_SCANNER_X86
+
+// Each mask function sets bit i when byte i of the block belongs to the class.
+// Unsigned range checks are done as min(x, limit) == x.
+
+__m128i inRange(__m128i v, char low, char width) noexcept
+{
+    __m128i shifted = _mm_sub_epi8(v, _mm_set1_epi8(low));
+    return _mm_cmpeq_epi8(_mm_min_epu8(shifted, _mm_set1_epi8(width)), shifted);
+}
+
+unsigned whitespaceMask(__m128i v) noexcept
+{
+    __m128i space = _mm_cmpeq_epi8(v, _mm_set1_epi8(' '));
+    return _mm_movemask_epi8(_mm_or_si128(space, inRange(v, '\t', 4)));
+}
+
+unsigned digitMask(__m128i v) noexcept
+{
+    return _mm_movemask_epi8(inRange(v, '0', 9));
+}
+
+unsigned identifierMask(__m128i v) noexcept
+{
+    __m128i alpha = inRange(_mm_or_si128(v, _mm_set1_epi8(0x20)), 'a', 25);
+    __m128i underscore = _mm_cmpeq_epi8(v, _mm_set1_epi8('_'));
+    return _mm_movemask_epi8(_mm_or_si128(_mm_or_si128(alpha, underscore), inRange(v, '0', 9)));
+}
+
+__m128i load16(const char* p) noexcept { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+
+template <unsigned (*mask)(__m128i) noexcept, bool (*inClass)(unsigned char) noexcept>
+const char* skipSse2(const char* p, const char* end) noexcept
+{
+    for (; end - p >= 16; p += 16) {
+        unsigned outside = ~mask(load16(p)) & 0xFFFFu;
+        if (outside) return p + __builtin_ctz(outside);
+    }
+    return skipScalar<inClass>(p, end);
+}
+
+const char* findLineEndSse2(const char* p, const char* end) noexcept
+{
+    for (; end - p >= 16; p += 16) {
+        unsigned found = _mm_movemask_epi8(_mm_cmpeq_epi8(load16(p), _mm_set1_epi8('\n')));
+        if (found) return p + __builtin_ctz(found);
+    }
+    return findLineEndScalar(p, end);
+}
+
+const char* findBlockCommentEndSse2(const char* p, const char* end) noexcept
+{
+    // Compares the block with itself shifted by one byte, so it needs one extra byte.
+    for (; end - p >= 17; p += 16) {
+        __m128i stars = _mm_cmpeq_epi8(load16(p), _mm_set1_epi8('*'));
+        __m128i slashes = _mm_cmpeq_epi8(load16(p + 1), _mm_set1_epi8('/'));
+        unsigned found = _mm_movemask_epi8(_mm_and_si128(stars, slashes));
+        if (found) return p + __builtin_ctz(found) + 2;
+    }
+    return findBlockCommentEndScalar(p, end);
+}
+
+constexpr Kernels sse2Kernels = {
+    skipSse2<whitespaceMask, isWhitespace>,
+    findLineEndSse2,
+    findBlockCommentEndSse2,
+    skipSse2<identifierMask, isIdentifierChar>,
+    skipSse2<digitMask, isDigit>
+};
+
+#define FRONTEND_AVX2 __attribute__((target("avx2")))
+
+FRONTEND_AVX2 __m256i inRange32(__m256i v, char low, char width) noexcept
+{
+    __m256i shifted = _mm256_sub_epi8(v, _mm256_set1_epi8(low));
+    return _mm256_cmpeq_epi8(_mm256_min_epu8(shifted, _mm256_set1_epi8(width)), shifted);
+}
+
+FRONTEND_AVX2 unsigned whitespaceMask32(__m256i v) noexcept
+{
+    __m256i space = _mm256_cmpeq_epi8(v, _mm256_set1_epi8(' '));
+    return _mm256_movemask_epi8(_mm256_or_si256(space, inRange32(v, '\t', 4)));
+}
+
+FRONTEND_AVX2 unsigned digitMask32(__m256i v) noexcept
+{
+    return _mm256_movemask_epi8(inRange32(v, '0', 9));
+}
+
+FRONTEND_AVX2 unsigned identifierMask32(__m256i v) noexcept
+{
+    __m256i alpha = inRange32(_mm256_or_si256(v, _mm256_set1_epi8(0x20)), 'a', 25);
+    __m256i underscore = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('_'));
+    return _mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(alpha, underscore), inRange32(v, '0', 9)));
+}
+
+FRONTEND_AVX2 __m256i load32(const char* p) noexcept
+{
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+}
+
+template <unsigned (*mask)(__m256i) noexcept, bool (*inClass)(unsigned char) noexcept>
+FRONTEND_AVX2 const char* skipAvx2(const char* p, const char* end) noexcept
+{
+    for (; end - p >= 32; p += 32) {
+        unsigned outside = ~mask(load32(p));
+        if (outside) return p + __builtin_ctz(outside);
+    }
+    return skipScalar<inClass>(p, end);
+}
+
+FRONTEND_AVX2 const char* findLineEndAvx2(const char* p, const char* end) noexcept
+{
+    for (; end - p >= 32; p += 32) {
+        unsigned found = _mm256_movemask_epi8(_mm256_cmpeq_epi8(load32(p), _mm256_set1_epi8('\n')));
+        if (found) return p + __builtin_ctz(found);
+    }
+    return findLineEndScalar(p, end);
+}
+
+FRONTEND_AVX2 const char* findBlockCommentEndAvx2(const char* p, const char* end) noexcept
+{
+    for (; end - p >= 33; p += 32) {
+        __m256i stars = _mm256_cmpeq_epi8(load32(p), _mm256_set1_epi8('*'));
+        __m256i slashes = _mm256_cmpeq_epi8(load32(p + 1), _mm256_set1_epi8('/'));
+        unsigned found = _mm256_movemask_epi8(_mm256_and_si256(stars, slashes));
+        if (found) return p + __builtin_ctz(found) + 2;
+    }
+    return findBlockCommentEndScalar(p, end);
+}
+
+constexpr Kernels avx2Kernels = {
+    skipAvx2<whitespaceMask32, isWhitespace>,
+    findLineEndAvx2,
+    findBlockCommentEndAvx2,
+    skipAvx2<identifierMask32, isIdentifierChar>,
+    skipAvx2<digitMask32, isDigit>
+};
+
+#undef FRONTEND_AVX2
+
+#endif // FRONTEND_SCANNER_X86
+
+const Kernels& kernelsFor(Isa isa) noexcept
+{
+    switch (isa) {
+#ifdef FRONTEND_SCANNER_X86
+        case Isa::AVX2: return avx2Kernels;
+        case Isa::SSE2: return sse2Kernels;
+#endif
+        default: return scalarKernels;
+    }
+}
+
+// Constant-initialized, resolved on first use.
+std::atomic<const Kernels*> activeKernels = nullptr;
+std::atomic<Isa> activeIsa = Isa::Scalar;
+
+const Kernels& kernels() noexcept
+{
+    const Kernels* current = activeKernels.load(std::memory_order_acquire);
+    if (!current) {
+        use(detect());
+        current = activeKernels.load(std::memory_order_acquire);
+    }
+    return *current;
+}
+
+} // namespace
+
+auto frontend::scanner::detect() noexcept -> Isa
+{
+#ifdef FRONTEND_SCANNER_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return Isa::AVX2;
+    if (__builtin_cpu_supports("sse2")) return Isa::SSE2;
+#endif
+    return Isa::Scalar;
+}
+
+auto frontend::scanner::active() noexcept -> Isa
+{
+    kernels();
+    return activeIsa.load(std::memory_order_relaxed);
+}
+
+void frontend::scanner::use(Isa isa) noexcept
+{
+    activeIsa.store(isa, std::memory_order_relaxed);
+    activeKernels.store(&kernelsFor(isa), std::memory_order_release);
+}
+
+const char* frontend::scanner::skipWhitespace(const char* begin, const char* end) noexcept
+{
+    return kernels().skipWhitespace(begin, end);
+}
+
+const char* frontend::scanner::findLineEnd(const char* begin, const char* end) noexcept
+{
+    return kernels().findLineEnd(begin, end);
+}
+
+const char* frontend::scanner::findBlockCommentEnd(const char* begin, const char* end) noexcept
+{
+    return kernels().findBlockCommentEnd(begin, end);
+}
+
+const char* frontend::scanner::skipIdentifier(const char* begin, const char* end) noexcept
+{
+    return kernels().skipIdentifier(begin, end);
+}
+
+const char* frontend::scanner::skipDigits(const char* begin, const char* end) noexcept
+{
+    return kernels().skipDigits(begin, end);
+}
@@ -0,0 +1,72 @@
+#include "Source.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+frontend::MappedFileSource::MappedFileSource(const std::string& path)
+    : m_mapping(nullptr)
+    , m_length(0)
+{
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open file \"" + path + "\".");
+    }
+    struct stat status;
+    if (::fstat(fd, &status) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Failed to stat file \"" + path + "\".");
+    }
+    m_length = static_cast<std::size_t>(status.st_size);
+    // Empty files cannot be mapped, they are scanned as an empty buffer.
+    if (m_length > 0) {
+        m_mapping = ::mmap(nullptr, m_length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (m_mapping == MAP_FAILED) {
+            m_mapping = nullptr;
+            ::close(fd);
+            throw std::runtime_error("Failed to map file \"" + path + "\".");
+        }
+        ::madvise(m_mapping, m_length, MADV_SEQUENTIAL);
+    }
+    ::close(fd);
+    m_begin = static_cast<const char*>(m_mapping);
+    m_cursor = m_begin;
+    m_end = m_begin + (m_mapping ? m_length : 0);
+}
+
+frontend::MappedFileSource::MappedFileSource(MappedFileSource&& other) noexcept
+    : BufferSource(other)
+    , m_mapping(std::exchange(other.m_mapping, nullptr))
+    , m_length(std::exchange(other.m_length, 0))
+{
+    other.m_begin = other.m_cursor = other.m_end = nullptr;
+}
+
+auto frontend::MappedFileSource::operator=(MappedFileSource&& other) noexcept -> MappedFileSource&
+{
+    if (this != &other) {
+        unmap();
+        BufferSource::operator=(other);
+        m_mapping = std::exchange(other.m_mapping, nullptr);
+        m_length = std::exchange(other.m_length, 0);
+        other.m_begin = other.m_cursor = other.m_end = nullptr;
+    }
+    return *this;
+}
+
+frontend::MappedFileSource::~MappedFileSource()
+{
+    unmap();
+}
+
+void frontend::MappedFileSource::unmap() noexcept
+{
+    if (m_mapping) {
+        ::munmap(m_mapping, m_length);
+        m_mapping = nullptr;
+    }
+}
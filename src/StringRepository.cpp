@@ -0,0 +1,63 @@
+#include "StringRepository.hpp"
+
+#include <functional>
+#include <stdexcept>
+
+auto frontend::string::StringRepository::instance() -> StringRepository&
+{
+    // Intentionally leaked, so handles stay valid during static destruction.
+    static StringRepository* repository = new StringRepository();
+    return *repository;
+}
+
+frontend::string::StringRepository::StringRepository()
+    : m_size(0)
+{
+    for (auto& chunk : m_chunks) {
+        chunk.store(nullptr, std::memory_order_relaxed);
+    }
+    intern("");
+}
+
+frontend::string::StringRepository::~StringRepository()
+{
+    for (auto& chunk : m_chunks) {
+        delete[] chunk.load(std::memory_order_relaxed);
+    }
+}
+
+auto frontend::string::StringRepository::intern(std::string_view data) -> Handle
+{
+    std::size_t hash = std::hash<std::string_view>{}(data);
+    Shard& shard = m_shards[hash % shardCount];
+    std::lock_guard lock(shard.mutex);
+    auto found = shard.handles.find(data);
+    if (found != shard.handles.end()) {
+        return found->second;
+    }
+    std::size_t index = m_size.fetch_add(1, std::memory_order_relaxed);
+    if (index >= chunkSize * maxChunks) {
+        throw std::length_error("StringRepository: too many distinct strings.");
+    }
+    Handle handle = static_cast<Handle>(index);
+    std::string& stored = slot(handle);
+    stored.assign(data);
+    shard.handles.emplace(stored, handle);
+    return handle;
+}
+
+auto frontend::string::StringRepository::slot(Handle handle) -> std::string&
+{
+    auto& chunk = m_chunks[handle >> chunkBits];
+    std::string* strings = chunk.load(std::memory_order_acquire);
+    if (!strings) {
+        // Several threads may race to create the same chunk, only one wins.
+        auto* created = new std::string[chunkSize];
+        if (chunk.compare_exchange_strong(strings, created, std::memory_order_acq_rel)) {
+            strings = created;
+        } else {
+            delete[] created;
+        }
+    }
+    return strings[handle & (chunkSize - 1)];
+}
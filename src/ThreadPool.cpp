@@ -0,0 +1,111 @@
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+
+frontend::ThreadPool::ThreadPool(std::size_t threads)
+    : m_queued(0)
+    , m_stopping(false)
+{
+    threads = std::max<std::size_t>(threads, 1);
+    for (std::size_t i = 0; i < threads; ++i) {
+        m_queues.push_back(std::make_unique<Queue>());
+    }
+    // Queue 0 belongs to the threads calling parallelFor().
+    for (std::size_t i = 1; i < threads; ++i) {
+        m_threads.emplace_back([this, i] { work(i); });
+    }
+}
+
+frontend::ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+    for (auto& thread : m_threads) {
+        thread.join();
+    }
+}
+
+void frontend::ThreadPool::run(Group& group, std::size_t count)
+{
+    if (count == 0) return;
+    group.remaining.store(count, std::memory_order_relaxed);
+    // Counted before they are published, runOne() may take one as soon as it is pushed.
+    {
+        std::lock_guard lock(m_mutex);
+        m_queued.fetch_add(count, std::memory_order_relaxed);
+    }
+    // Contiguous indices per queue, stealing evens out the rest.
+    std::size_t queues = m_queues.size();
+    for (std::size_t queue = 0; queue < queues; ++queue) {
+        std::lock_guard lock(m_queues[queue]->mutex);
+        for (std::size_t index = count * queue / queues; index < count * (queue + 1) / queues; ++index) {
+            // The owner pops from the back, so it runs them in order and thieves take the last ones.
+            m_queues[queue]->tasks.push_front({ &group, index });
+        }
+    }
+    m_wake.notify_all();
+    while (group.remaining.load(std::memory_order_acquire) > 0 && runOne(0)) {
+    }
+    // Every task is taken, wait for those still running on other threads.
+    std::unique_lock lock(group.mutex);
+    group.done.wait(lock, [&] { return group.remaining.load(std::memory_order_relaxed) == 0; });
+    if (group.error) {
+        std::rethrow_exception(group.error);
+    }
+}
+
+void frontend::ThreadPool::work(std::size_t queue)
+{
+    while (true) {
+        if (runOne(queue)) continue;
+        std::unique_lock lock(m_mutex);
+        m_wake.wait(lock, [&] { return m_stopping || m_queued.load(std::memory_order_relaxed) > 0; });
+        if (m_stopping) return;
+    }
+}
+
+bool frontend::ThreadPool::runOne(std::size_t queue)
+{
+    std::size_t queues = m_queues.size();
+    for (std::size_t i = 0; i < queues; ++i) {
+        Queue& victim = *m_queues[(queue + i) % queues];
+        Task task;
+        {
+            std::lock_guard lock(victim.mutex);
+            if (victim.tasks.empty()) continue;
+            // The owner works from the back, thieves from the front.
+            if (i == 0) {
+                task = victim.tasks.back();
+                victim.tasks.pop_back();
+            } else {
+                task = victim.tasks.front();
+                victim.tasks.pop_front();
+            }
+        }
+        m_queued.fetch_sub(1, std::memory_order_relaxed);
+        execute(task);
+        return true;
+    }
+    return false;
+}
+
+void frontend::ThreadPool::execute(const Task& task) noexcept
+{
+    Group& group = *task.group;
+    std::exception_ptr error;
+    try {
+        group.call(group.body, task.index);
+    } catch (...) {
+        error = std::current_exception();
+    }
+    std::lock_guard lock(group.mutex);
+    if (error && !group.error) {
+        group.error = error;
+    }
+    if (group.remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        group.done.notify_all();
+    }
+}
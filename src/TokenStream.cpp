@@ -0,0 +1,186 @@
+#include "TokenStream.hpp"
+
+#include <algorithm>
+#include <ranges>
+#include <utility>
+
+#include "Lexer.hpp"
+
+namespace {
+
+// Roughly one token every four bytes of source.
+constexpr std::size_t bytesPerToken = 4;
+
+void reserveFor(std::string_view text, frontend::TokenColumns& columns)
+{
+    std::size_t expected = text.size() / bytesPerToken + 1;
+    columns.types.reserve(expected);
+    columns.from.reserve(expected);
+    columns.to.reserve(expected);
+}
+
+} // namespace
+
+frontend::TokenStream::TokenStream(std::string_view text, std::shared_ptr<const void>&& owner)
+    : m_owner(std::move(owner))
+    , m_text(text)
+{
+    reserveFor(text, m_columns);
+    Lexer<1, BufferSource>::tokenize(BufferSource(text), m_columns);
+}
+
+frontend::TokenStream::TokenStream(std::string_view text, TokenColumns&& columns) noexcept
+    : m_text(text)
+    , m_columns(std::move(columns))
+{
+}
+
+auto frontend::TokenStream::tokenize(std::string_view text) -> TokenStream
+{
+    return TokenStream(text, nullptr);
+}
+
+auto frontend::TokenStream::tokenize(std::string&& text) -> TokenStream
+{
+    auto owned = std::make_shared<const std::string>(std::move(text));
+    std::string_view view = *owned;
+    return TokenStream(view, std::move(owned));
+}
+
+auto frontend::TokenStream::tokenize(MappedFileSource&& file) -> TokenStream
+{
+    auto owned = std::make_shared<const MappedFileSource>(std::move(file));
+    std::string_view view(owned->begin(), owned->end() - owned->begin());
+    return TokenStream(view, std::move(owned));
+}
+
+auto frontend::TokenStream::tokenize(StreamSource&& stream) -> TokenStream
+{
+    return tokenize(stream.readAll());
+}
+
+frontend::TokenGapBuffer::TokenGapBuffer(std::string_view text)
+    : m_text(text)
+{
+    reserveFor(text, m_columns);
+    Lexer<1, BufferSource>::tokenize(BufferSource(text), m_columns);
+    m_gapBegin = m_gapEnd = m_columns.types.size();
+}
+
+auto frontend::TokenGapBuffer::firstFrom(std::uint32_t offset, Index first) const noexcept -> Index
+{
+    auto tokens = std::views::iota(first, static_cast<Index>(size()));
+    auto found = std::ranges::partition_point(tokens, [&](Index token) { return from(token) < offset; });
+    return static_cast<Index>(first + (found - tokens.begin()));
+}
+
+auto frontend::TokenGapBuffer::lex(std::string_view text, const TextEdit& edit, TokenColumns& lexed) const -> Change
+{
+    std::uint32_t delta = edit.length - (edit.to - edit.from);
+    std::uint32_t editEnd = edit.from + edit.length;
+    // Restart one token before the first one reaching the edit: the lexer looks at the
+    // characters after a token to find where it ends.
+    auto tokens = std::views::iota(Index(0), static_cast<Index>(size()));
+    auto found = std::ranges::partition_point(tokens, [&](Index token) { return to(token) < edit.from; });
+    auto first = static_cast<Index>(found - tokens.begin());
+    if (first > 0) --first;
+    std::uint32_t start = first > 0 ? to(first - 1) : 0;
+
+    Index oldEnd = static_cast<Index>(size() - 1);
+    Lexer<1, BufferSource> lexer(BufferSource(text.substr(start)));
+    Index old = first;
+    // Tokens lexed again but unchanged, before the edit, are left out.
+    Index same = first;
+    while (true) {
+        const Token& token = lexer.peek();
+        std::uint32_t from = start + token.from;
+        if (from >= editEnd) {
+            // Behind the edit, lexing goes on like before from the first token starting at the same place.
+            // Unsigned arithmetic wraps, so a negative delta works too.
+            old = firstFrom(from - delta, old);
+            if (old < size() && this->from(old) == from - delta) {
+                oldEnd = old;
+                break;
+            }
+        }
+        // Only reached when the old stream does not end like the text.
+        if (token.type == TokenType::EndOfFile) break;
+        if (same == first + lexed.types.size() && same < oldEnd && to(same) <= edit.from && token.type == type(same) &&
+            from == this->from(same) && start + token.to == to(same)) {
+            ++same;
+        } else {
+            lexed.types.push_back(token.type);
+            lexed.from.push_back(from);
+            lexed.to.push_back(start + token.to);
+        }
+        lexer.skip();
+    }
+    return { same, oldEnd, static_cast<Index>(same + lexed.types.size()) };
+}
+
+void frontend::TokenGapBuffer::replace(Index first, Index end, const TokenColumns& tokens, std::string_view text)
+{
+    moveGap(first);
+    m_gapEnd += end - first;
+    reserveGap(tokens.types.size());
+    std::ranges::copy(tokens.types, m_columns.types.begin() + m_gapBegin);
+    std::ranges::copy(tokens.from, m_columns.from.begin() + m_gapBegin);
+    std::ranges::copy(tokens.to, m_columns.to.begin() + m_gapBegin);
+    m_gapBegin += tokens.types.size();
+    m_text = text;
+}
+
+auto frontend::TokenGapBuffer::columns(Index begin, Index end) const -> TokenColumns
+{
+    TokenColumns columns;
+    columns.types.reserve(end - begin);
+    columns.from.reserve(end - begin);
+    columns.to.reserve(end - begin);
+    for (Index token = begin; token < end; ++token) {
+        columns.types.push_back(type(token));
+        columns.from.push_back(from(token));
+        columns.to.push_back(to(token));
+    }
+    return columns;
+}
+
+auto frontend::TokenGapBuffer::slice(Index begin, Index end) const -> Slice
+{
+    Index first = begin > 0 ? begin - 1 : 0;
+    Index last = std::min(static_cast<Index>(end + 1), static_cast<Index>(size()));
+    return { TokenStream(m_text, columns(first, last)), begin - first, end - first };
+}
+
+void frontend::TokenGapBuffer::moveGap(Index position) noexcept
+{
+    auto size = static_cast<std::uint32_t>(m_text.size());
+    while (m_gapBegin > position) {
+        --m_gapBegin;
+        --m_gapEnd;
+        m_columns.types[m_gapEnd] = m_columns.types[m_gapBegin];
+        m_columns.from[m_gapEnd] = size - m_columns.from[m_gapBegin];
+        m_columns.to[m_gapEnd] = size - m_columns.to[m_gapBegin];
+    }
+    while (m_gapBegin < position) {
+        m_columns.types[m_gapBegin] = m_columns.types[m_gapEnd];
+        m_columns.from[m_gapBegin] = size - m_columns.from[m_gapEnd];
+        m_columns.to[m_gapBegin] = size - m_columns.to[m_gapEnd];
+        ++m_gapBegin;
+        ++m_gapEnd;
+    }
+}
+
+void frontend::TokenGapBuffer::reserveGap(std::size_t count)
+{
+    if (m_gapEnd - m_gapBegin >= count) return;
+    std::size_t capacity = m_columns.types.size();
+    std::size_t grown = std::max(capacity * 2, capacity + count);
+    auto grow = [&](auto& column) {
+        column.resize(grown);
+        std::move_backward(column.begin() + m_gapEnd, column.begin() + capacity, column.end());
+    };
+    grow(m_columns.types);
+    grow(m_columns.from);
+    grow(m_columns.to);
+    m_gapEnd += grown - capacity;
+}
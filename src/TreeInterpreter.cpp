@@ -0,0 +1,108 @@
+#include "TreeInterpreter.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+auto backend::TreeInterpreter::evaluate(const frontend::Expression& expression) -> Value
+{
+    using frontend::NodeType;
+    switch (expression.nodeType()) {
+        case NodeType::Identifier:
+            return variable(expression);
+        case NodeType::NumericLiteral: {
+            const auto& literal = static_cast<const frontend::NumericLiteral&>(expression).literal();
+            auto value = Integer::parse(literal.str());
+            if (!value) {
+                throw std::range_error("Integer literal does not fit in 64 bits: " + literal.str());
+            }
+            return *value;
+        }
+        case NodeType::StringLiteral:
+            return Value(static_cast<const frontend::StringLiteral&>(expression).literal().str());
+        case NodeType::ArrayLiteral: {
+            Array elements;
+            for (const auto& element : static_cast<const frontend::ArrayLiteral&>(expression).elements()) {
+                elements.push_back(evaluate(*element));
+            }
+            return Value(std::move(elements));
+        }
+        case NodeType::MemberAccess: {
+            const auto& access = static_cast<const frontend::MemberAccess&>(expression);
+            return member(evaluate(access.argument()), access.identifier().identifier());
+        }
+        case NodeType::FunctionCall: {
+            const auto& call = static_cast<const frontend::FunctionCall&>(expression);
+            Value function = evaluate(call.function());
+            Array arguments;
+            for (const auto& argument : call.arguments()) {
+                arguments.push_back(evaluate(*argument));
+            }
+            return backend::call(function, arguments);
+        }
+        case NodeType::SubscriptAccess: {
+            const auto& access = static_cast<const frontend::SubscriptAccess&>(expression);
+            Value array = evaluate(access.argument());
+            return element(array, evaluate(access.subscript()));
+        }
+        case NodeType::PreIncrement:
+        case NodeType::PreDecrement:
+        case NodeType::PostIncrement:
+        case NodeType::PostDecrement:
+            return increment(static_cast<const frontend::UnaryOperator&>(expression));
+        case NodeType::Positive:
+        case NodeType::Negative:
+        case NodeType::LogicalNegation:
+        case NodeType::BitwiseNot:
+            return evaluateUnary(expression.nodeType(),
+                evaluate(static_cast<const frontend::UnaryOperator&>(expression).argument()));
+        default: {
+            const auto& binary = static_cast<const frontend::BinaryOperator&>(expression);
+            Value lhs = evaluate(binary.lhs());
+            return evaluateBinary(expression.nodeType(), lhs, evaluate(binary.rhs()));
+        }
+    }
+}
+
+auto backend::TreeInterpreter::increment(const frontend::UnaryOperator& node) -> Value
+{
+    using frontend::NodeType;
+    bool post = node.nodeType() == NodeType::PostIncrement || node.nodeType() == NodeType::PostDecrement;
+    const auto& target = node.argument();
+    // The container and subscript are evaluated first, then the target is read once.
+    Value container;
+    Value subscript;
+    Value* slot = nullptr;
+    switch (target.nodeType()) {
+        case NodeType::Identifier:
+            slot = &variable(target);
+            break;
+        case NodeType::SubscriptAccess: {
+            const auto& access = static_cast<const frontend::SubscriptAccess&>(target);
+            container = evaluate(access.argument());
+            subscript = evaluate(access.subscript());
+            slot = &element(container, subscript);
+            break;
+        }
+        case NodeType::MemberAccess: {
+            const auto& access = static_cast<const frontend::MemberAccess&>(target);
+            container = evaluate(access.argument());
+            slot = &member(container, access.identifier().identifier());
+            break;
+        }
+        default:
+            throw std::runtime_error("Only variables, elements and members can be incremented.");
+    }
+    Value old = *slot;
+    *slot = evaluateUnary(node.nodeType(), old);
+    return post ? old : *slot;
+}
+
+auto backend::TreeInterpreter::variable(const frontend::Expression& identifier) -> Value&
+{
+    const auto& name = static_cast<const frontend::Identifier&>(identifier).identifier().str();
+    auto found = m_environment.find(name);
+    if (found == m_environment.end()) {
+        throw std::runtime_error("Unknown variable '" + name + "'.");
+    }
+    return found->second;
+}
@@ -0,0 +1,206 @@
+#include "TypeInference.hpp"
+
+#include <algorithm>
+#include <bit>
+
+#include "WideInt.hpp"
+
+namespace {
+
+using namespace frontend;
+
+bool isInteger(const ExpressionType& type) noexcept
+{
+    return integerWidth(type.basicExpressionType()) != 0;
+}
+
+const ExpressionType& integerType(unsigned width, bool isSigned)
+{
+    auto first = static_cast<unsigned>(isSigned ? BasicExpressionType::Int8 : BasicExpressionType::Uint8);
+    return ExpressionType::basic(static_cast<BasicExpressionType>(first + width / 8 - 1));
+}
+
+// The narrowest integer type that holds the values of both, nullptr when it would
+// need more than 256 bits: uint256 and any signed type.
+const ExpressionType* commonType(const ExpressionType& lhs, const ExpressionType& rhs)
+{
+    unsigned lhsWidth = integerWidth(lhs.basicExpressionType());
+    unsigned rhsWidth = integerWidth(rhs.basicExpressionType());
+    bool lhsSigned = isSignedInteger(lhs.basicExpressionType());
+    bool rhsSigned = isSignedInteger(rhs.basicExpressionType());
+    if (lhsSigned == rhsSigned) return &integerType(std::max(lhsWidth, rhsWidth), lhsSigned);
+    unsigned signedWidth = lhsSigned ? lhsWidth : rhsWidth;
+    unsigned unsignedWidth = lhsSigned ? rhsWidth : lhsWidth;
+    unsigned width = std::max(signedWidth, unsignedWidth + 8);
+    return width <= 256 ? &integerType(width, true) : nullptr;
+}
+
+std::string expected(std::string_view what, const ExpressionType& lhs, const ExpressionType& rhs)
+{
+    return "Expected " + std::string(what) + ", got " + lhs.toString() + " and " + rhs.toString() + ".";
+}
+
+std::string noCommonType(const ExpressionType& lhs, const ExpressionType& rhs)
+{
+    return "No integer type holds both " + lhs.toString() + " and " + rhs.toString() + ".";
+}
+
+} // namespace
+
+auto frontend::TypeInference::infer(const FlatAST& tree) -> void
+{
+    std::size_t size = tree.size();
+    m_types.assign(size, nullptr);
+    m_unboundNames.assign(size, false);
+    m_diagnostics.clear();
+    for (FlatAST::Index node = 0; node < size; ++node) {
+        if (tree.type(node) == NodeType::MemberAccess) {
+            m_unboundNames[tree.end(tree.firstChild(node))] = true;
+        } else if (tree.type(node) == NodeType::FunctionCall) {
+            m_unboundNames[tree.firstChild(node)] = tree.type(tree.firstChild(node)) == NodeType::Identifier;
+        }
+    }
+    // Backward: the children of a node come after it.
+    for (std::size_t i = size; i-- > 0;) {
+        auto node = static_cast<FlatAST::Index>(i);
+        m_types[node] = inferNode(tree, node);
+    }
+}
+
+auto frontend::TypeInference::inferNode(const FlatAST& tree, FlatAST::Index node) -> const ExpressionType*
+{
+    FlatAST::Index first = tree.firstChild(node);
+    switch (tree.type(node)) {
+        case NodeType::Identifier: {
+            if (m_unboundNames[node]) return nullptr;
+            auto found = m_environment.find(tree.value(node));
+            if (found == m_environment.end()) {
+                return diagnose(tree, node, "Unknown variable '" + tree.value(node).str() + "'.");
+            }
+            return found->second;
+        }
+        case NodeType::NumericLiteral: {
+            const ExpressionType* type = literalType(tree.value(node));
+            return type ? type : diagnose(tree, node, "Integer literal does not fit in 256 bits.");
+        }
+        case NodeType::StringLiteral:
+            return &ExpressionType::basic(BasicExpressionType::String);
+        case NodeType::ArrayLiteral: {
+            if (tree.childCount(node) == 0) {
+                return diagnose(tree, node, "The element type of an empty array is unknown.");
+            }
+            const ExpressionType* element = m_types[first];
+            FlatAST::Index child = first;
+            for (std::uint32_t i = 0; i < tree.childCount(node); ++i, child = tree.end(child)) {
+                const ExpressionType* type = m_types[child];
+                if (!type || !element) return nullptr;
+                if (*type == *element) continue;
+                if (!isInteger(*type) || !isInteger(*element)) {
+                    return diagnose(tree, node, expected("elements of one type", *element, *type));
+                }
+                const ExpressionType* common = commonType(*element, *type);
+                if (!common) return diagnose(tree, node, noCommonType(*element, *type));
+                element = common;
+            }
+            return &ExpressionType::arrayOf(*element);
+        }
+        case NodeType::MemberAccess:
+        case NodeType::FunctionCall:
+            return nullptr;
+        case NodeType::SubscriptAccess: {
+            const ExpressionType* array = m_types[first];
+            const ExpressionType* index = m_types[tree.end(first)];
+            if (!array || !index) return nullptr;
+            if (!array->isArray() || !isInteger(*index)) {
+                return diagnose(tree, node, expected("an array and an integer", *array, *index));
+            }
+            return array->elementType();
+        }
+        case NodeType::PostIncrement:
+        case NodeType::PostDecrement:
+        case NodeType::PreIncrement:
+        case NodeType::PreDecrement:
+        case NodeType::Negative:
+        case NodeType::Positive:
+        case NodeType::LogicalNegation:
+        case NodeType::BitwiseNot: {
+            const ExpressionType* argument = m_types[first];
+            if (!argument) return nullptr;
+            auto basic = argument->basicExpressionType();
+            if (tree.type(node) == NodeType::LogicalNegation) {
+                if (basic != BasicExpressionType::Bool && !isInteger(*argument)) {
+                    return diagnose(tree, node, "Expected a boolean or an integer, got " + argument->toString() + ".");
+                }
+                return &ExpressionType::basic(BasicExpressionType::Bool);
+            }
+            if (!isInteger(*argument)) {
+                return diagnose(tree, node, "Expected an integer, got " + argument->toString() + ".");
+            }
+            if (tree.type(node) == NodeType::Negative && !isSignedInteger(basic)) {
+                unsigned width = integerWidth(basic) + 8;
+                if (width > 256) {
+                    return diagnose(tree, node, "No integer type holds the negation of " + argument->toString() + ".");
+                }
+                return &integerType(width, true);
+            }
+            return argument;
+        }
+        default: {
+            const ExpressionType* lhs = m_types[first];
+            const ExpressionType* rhs = m_types[tree.end(first)];
+            if (!lhs || !rhs) return nullptr;
+            const ExpressionType& boolean = ExpressionType::basic(BasicExpressionType::Bool);
+            const ExpressionType& string = ExpressionType::basic(BasicExpressionType::String);
+            bool integers = isInteger(*lhs) && isInteger(*rhs);
+            bool strings = *lhs == string && *rhs == string;
+            switch (tree.type(node)) {
+                case NodeType::Equals:
+                case NodeType::NotEquals:
+                    if (integers || *lhs == *rhs) return &boolean;
+                    return diagnose(tree, node, expected("integers or operands of one type", *lhs, *rhs));
+                case NodeType::LessThan:
+                case NodeType::LessEquals:
+                case NodeType::GreaterThan:
+                case NodeType::GreaterEquals:
+                    if (integers || strings) return &boolean;
+                    return diagnose(tree, node, expected("integers or strings", *lhs, *rhs));
+                case NodeType::ShiftLeft:
+                case NodeType::ShiftRight:
+                case NodeType::ShiftRightLogic:
+                    if (integers) return lhs;
+                    return diagnose(tree, node, expected("integers", *lhs, *rhs));
+                default:
+                    if (strings && tree.type(node) == NodeType::Addition) return &string;
+                    if (!integers) return diagnose(tree, node, expected("integers", *lhs, *rhs));
+                    if (const ExpressionType* common = commonType(*lhs, *rhs)) return common;
+                    return diagnose(tree, node, noCommonType(*lhs, *rhs));
+            }
+        }
+    }
+}
+
+auto frontend::TypeInference::literalType(string::FastString literal) -> const ExpressionType*
+{
+    auto [found, inserted] = m_literals.try_emplace(literal, nullptr);
+    if (!inserted) return found->second;
+    if (auto value = WideInt<256, false>::parse(literal.str())) {
+        // The bits used by the value, 0 takes one byte like 1.
+        unsigned bits = 0;
+        auto limbs = value->limbs();
+        for (std::size_t i = limbs.size(); i-- > 0;) {
+            if (limbs[i] != 0) {
+                bits = static_cast<unsigned>(i * 64 + std::bit_width(limbs[i]));
+                break;
+            }
+        }
+        found->second = &integerType(std::max(8u, (bits + 7) / 8 * 8), false);
+    }
+    return found->second;
+}
+
+auto frontend::TypeInference::diagnose(const FlatAST& tree, FlatAST::Index node, std::string_view message)
+    -> const ExpressionType*
+{
+    m_diagnostics.push_back({ tree.from(node), tree.to(node), std::string(message) });
+    return nullptr;
+}
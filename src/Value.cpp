@@ -0,0 +1,197 @@
+#include "Value.hpp"
+
+#include <stdexcept>
+
+namespace {
+
+const char* spelling(frontend::NodeType type) noexcept
+{
+    using frontend::NodeType;
+    switch (type) {
+        case NodeType::Addition: return "+";
+        case NodeType::Subtraction: return "-";
+        case NodeType::Multiplication: return "*";
+        case NodeType::Division: return "/";
+        case NodeType::Remainder: return "%";
+        case NodeType::ShiftLeft: return "<<";
+        case NodeType::ShiftRight: return ">>";
+        case NodeType::ShiftRightLogic: return ">>>";
+        case NodeType::LessThan: return "<";
+        case NodeType::LessEquals: return "<=";
+        case NodeType::GreaterThan: return ">";
+        case NodeType::GreaterEquals: return ">=";
+        case NodeType::Equals: return "==";
+        case NodeType::NotEquals: return "!=";
+        case NodeType::Positive: return "unary +";
+        case NodeType::Negative: return "unary -";
+        case NodeType::LogicalNegation: return "!";
+        case NodeType::BitwiseNot: return "~";
+        case NodeType::PreIncrement:
+        case NodeType::PostIncrement: return "++";
+        case NodeType::PreDecrement:
+        case NodeType::PostDecrement: return "--";
+        default: return "?";
+    }
+}
+
+[[noreturn]] void throwOperands(frontend::NodeType type, const backend::Value& lhs, const backend::Value& rhs)
+{
+    throw std::runtime_error(std::string("Invalid operands of '") + spelling(type) + "': " + kindName(lhs.kind()) +
+        " and " + kindName(rhs.kind()) + ".");
+}
+
+} // namespace
+
+auto backend::kindName(Value::Kind kind) noexcept -> const char*
+{
+    switch (kind) {
+        case Value::Kind::None: return "none";
+        case Value::Kind::Boolean: return "boolean";
+        case Value::Kind::Integer: return "integer";
+        case Value::Kind::String: return "string";
+        case Value::Kind::Array: return "array";
+        case Value::Kind::Object: return "object";
+        case Value::Kind::Function: return "function";
+    }
+    return "?";
+}
+
+auto backend::Value::throwKind(Kind expected) const -> void
+{
+    throw std::runtime_error(std::string("Expected ") + kindName(expected) + ", got " + kindName(kind()) + ".");
+}
+
+auto backend::operator==(const Value& lhs, const Value& rhs) -> bool
+{
+    if (lhs.kind() != rhs.kind()) return false;
+    switch (lhs.kind()) {
+        case Value::Kind::None: return true;
+        case Value::Kind::Boolean: return lhs.boolean() == rhs.boolean();
+        case Value::Kind::Integer: return lhs.integer() == rhs.integer();
+        case Value::Kind::String: return lhs.string() == rhs.string();
+        case Value::Kind::Array: return lhs.array() == rhs.array();
+        case Value::Kind::Object: return &lhs.object() == &rhs.object();
+        case Value::Kind::Function: return &lhs.function() == &rhs.function();
+    }
+    return false;
+}
+
+auto backend::Value::toString() const -> std::string
+{
+    switch (kind()) {
+        case Kind::None: return "none";
+        case Kind::Boolean: return boolean() ? "true" : "false";
+        case Kind::Integer: return integer().toString();
+        case Kind::String: return '"' + string() + '"';
+        case Kind::Array: {
+            std::string text = "[";
+            for (const auto& element : array()) {
+                if (text.size() > 1) text += ", ";
+                text += element.toString();
+            }
+            return text + "]";
+        }
+        case Kind::Object: {
+            std::string text = "{";
+            for (const auto& [name, value] : object()) {
+                if (text.size() > 1) text += ", ";
+                text += name.str() + ": " + value.toString();
+            }
+            return text + "}";
+        }
+        case Kind::Function: return "function";
+    }
+    return "?";
+}
+
+auto backend::evaluateBinary(frontend::NodeType type, const Value& lhs, const Value& rhs) -> Value
+{
+    using frontend::NodeType;
+    switch (type) {
+        case NodeType::Equals: return lhs == rhs;
+        case NodeType::NotEquals: return !(lhs == rhs);
+        default: break;
+    }
+    if (lhs.kind() == Value::Kind::String && rhs.kind() == Value::Kind::String) {
+        const std::string& a = lhs.string();
+        const std::string& b = rhs.string();
+        switch (type) {
+            case NodeType::Addition: return Value(a + b);
+            case NodeType::LessThan: return a < b;
+            case NodeType::LessEquals: return a <= b;
+            case NodeType::GreaterThan: return a > b;
+            case NodeType::GreaterEquals: return a >= b;
+            default: throwOperands(type, lhs, rhs);
+        }
+    }
+    if (!lhs.isInteger() || !rhs.isInteger()) {
+        throwOperands(type, lhs, rhs);
+    }
+    Integer a = lhs.integerUnchecked();
+    Integer b = rhs.integerUnchecked();
+    switch (type) {
+        case NodeType::Addition: return a + b;
+        case NodeType::Subtraction: return a - b;
+        case NodeType::Multiplication: return a * b;
+        case NodeType::Division: return a / b;
+        case NodeType::Remainder: return a % b;
+        case NodeType::ShiftLeft: return a << shiftCount(b);
+        case NodeType::ShiftRight: return a >> shiftCount(b);
+        case NodeType::ShiftRightLogic: return a.shiftRightLogic(shiftCount(b));
+        case NodeType::LessThan: return a < b;
+        case NodeType::LessEquals: return a <= b;
+        case NodeType::GreaterThan: return a > b;
+        case NodeType::GreaterEquals: return a >= b;
+        default: throwOperands(type, lhs, rhs);
+    }
+}
+
+auto backend::evaluateUnary(frontend::NodeType type, const Value& argument) -> Value
+{
+    using frontend::NodeType;
+    if (type == NodeType::LogicalNegation && argument.kind() == Value::Kind::Boolean) {
+        return !argument.boolean();
+    }
+    if (!argument.isInteger()) {
+        throw std::runtime_error(std::string("Invalid operand of '") + spelling(type) + "': " +
+            kindName(argument.kind()) + ".");
+    }
+    Integer a = argument.integerUnchecked();
+    switch (type) {
+        case NodeType::Positive: return a;
+        case NodeType::Negative: return -a;
+        case NodeType::LogicalNegation: return a.isZero();
+        case NodeType::BitwiseNot: return ~a;
+        case NodeType::PreIncrement:
+        case NodeType::PostIncrement: return a + 1;
+        case NodeType::PreDecrement:
+        case NodeType::PostDecrement: return a - 1;
+        default: throw std::logic_error("evaluateUnary: not a unary operator.");
+    }
+}
+
+auto backend::element(const Value& array, const Value& index) -> Value&
+{
+    Array& elements = array.array();
+    auto position = static_cast<std::int64_t>(index.integer().low());
+    if (position < 0 || static_cast<std::uint64_t>(position) >= elements.size()) {
+        throw std::out_of_range("Index " + std::to_string(position) + " out of bounds of an array of " +
+            std::to_string(elements.size()) + " elements.");
+    }
+    return elements[position];
+}
+
+auto backend::member(const Value& object, frontend::string::FastString name) -> Value&
+{
+    Object& members = object.object();
+    auto found = members.find(name);
+    if (found == members.end()) {
+        throw std::runtime_error("No member named '" + name.str() + "'.");
+    }
+    return found->second;
+}
+
+auto backend::call(const Value& function, std::span<const Value> arguments) -> Value
+{
+    return function.function()(arguments);
+}
@@ -0,0 +1,126 @@
+#include "VirtualMachine.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+auto backend::VirtualMachine::load(const Program& program) -> void
+{
+    m_registers.clear();
+    m_registers.resize(program.registerCount());
+    std::copy(program.constants().begin(), program.constants().end(), m_registers.begin());
+    m_loaded = program.id();
+}
+
+auto backend::VirtualMachine::run(const Program& program, std::span<Value> inputs) -> Value
+{
+    if (inputs.size() != program.inputs().size()) {
+        throw std::logic_error("VirtualMachine: expected " + std::to_string(program.inputs().size()) + " inputs.");
+    }
+    if (m_loaded != program.id()) {
+        load(program);
+    }
+    Value* registers = m_registers.data();
+    std::copy(inputs.begin(), inputs.end(), registers + program.firstInput());
+    // Writes the incremented inputs back, also when the program throws.
+    struct WriteBack {
+        const Program& program;
+        Value* registers;
+        std::span<Value> inputs;
+        ~WriteBack()
+        {
+            for (auto input : program.outputs()) {
+                inputs[input - program.firstInput()] = registers[input];
+            }
+        }
+    } writeBack{ program, registers, inputs };
+
+// Integers take the inline path, anything else the shared semantics.
+#define INTEGER_BINARY(OPCODE, NODE_TYPE, SETTER, EXPRESSION)                                       \
+    case Opcode::OPCODE: {                                                                          \
+        const Value& lhs = registers[pc->b];                                                        \
+        const Value& rhs = registers[pc->c];                                                        \
+        if (lhs.isInteger() && rhs.isInteger()) {                                                   \
+            Integer a = lhs.integerUnchecked();                                                     \
+            Integer b = rhs.integerUnchecked();                                                     \
+            registers[pc->a].SETTER(EXPRESSION);                                                    \
+        } else {                                                                                    \
+            registers[pc->a] = evaluateBinary(frontend::NodeType::NODE_TYPE, lhs, rhs);             \
+        }                                                                                           \
+        break;                                                                                      \
+    }
+
+#define INTEGER_UNARY(OPCODE, NODE_TYPE, EXPRESSION)                                                \
+    case Opcode::OPCODE: {                                                                          \
+        const Value& argument = registers[pc->b];                                                   \
+        if (argument.isInteger()) {                                                                 \
+            Integer a = argument.integerUnchecked();                                                \
+            registers[pc->a].setInteger(EXPRESSION);                                                \
+        } else {                                                                                    \
+            registers[pc->a] = evaluateUnary(frontend::NodeType::NODE_TYPE, argument);              \
+        }                                                                                           \
+        break;                                                                                      \
+    }
+
+    for (const Instruction* pc = program.code().data();; ++pc) {
+        switch (pc->opcode) {
+            case Opcode::Move:
+                registers[pc->a] = registers[pc->b];
+                break;
+            INTEGER_BINARY(Add, Addition, setInteger, a + b)
+            INTEGER_BINARY(Subtract, Subtraction, setInteger, a - b)
+            INTEGER_BINARY(Multiply, Multiplication, setInteger, a * b)
+            INTEGER_BINARY(Divide, Division, setInteger, a / b)
+            INTEGER_BINARY(Remainder, Remainder, setInteger, a % b)
+            INTEGER_BINARY(Less, LessThan, setBoolean, a < b)
+            INTEGER_BINARY(LessEquals, LessEquals, setBoolean, a <= b)
+            INTEGER_BINARY(Greater, GreaterThan, setBoolean, a > b)
+            INTEGER_BINARY(GreaterEquals, GreaterEquals, setBoolean, a >= b)
+            INTEGER_BINARY(Equals, Equals, setBoolean, a == b)
+            INTEGER_BINARY(NotEquals, NotEquals, setBoolean, a != b)
+            INTEGER_BINARY(ShiftLeft, ShiftLeft, setInteger, a << shiftCount(b))
+            INTEGER_BINARY(ShiftRight, ShiftRight, setInteger, a >> shiftCount(b))
+            INTEGER_BINARY(ShiftRightLogic, ShiftRightLogic, setInteger, a.shiftRightLogic(shiftCount(b)))
+            INTEGER_UNARY(Plus, Positive, a)
+            INTEGER_UNARY(Negate, Negative, -a)
+            INTEGER_UNARY(BitwiseNot, BitwiseNot, ~a)
+            INTEGER_UNARY(Increment, PreIncrement, a + 1)
+            INTEGER_UNARY(Decrement, PreDecrement, a - 1)
+            case Opcode::Not:
+                if (registers[pc->b].kind() == Value::Kind::Boolean) {
+                    registers[pc->a].setBoolean(!registers[pc->b].boolean());
+                } else {
+                    registers[pc->a] = evaluateUnary(frontend::NodeType::LogicalNegation, registers[pc->b]);
+                }
+                break;
+            case Opcode::NewArray:
+                registers[pc->a] = Value(Array(registers + pc->b, registers + pc->b + pc->c));
+                break;
+            case Opcode::Call:
+                registers[pc->a] = call(registers[pc->b], std::span<const Value>(registers + pc->b + 1, pc->c));
+                break;
+            case Opcode::GetElement: {
+                // A copy first, the destination may hold the last reference to the array.
+                Value value = element(registers[pc->b], registers[pc->c]);
+                registers[pc->a] = std::move(value);
+                break;
+            }
+            case Opcode::SetElement:
+                element(registers[pc->a], registers[pc->b]) = registers[pc->c];
+                break;
+            case Opcode::GetMember: {
+                Value value = member(registers[pc->b], frontend::string::FastString::fromHandle(pc->c));
+                registers[pc->a] = std::move(value);
+                break;
+            }
+            case Opcode::SetMember:
+                member(registers[pc->a], frontend::string::FastString::fromHandle(pc->c)) = registers[pc->b];
+                break;
+            case Opcode::Return:
+                return registers[pc->a];
+        }
+    }
+
+#undef INTEGER_BINARY
+#undef INTEGER_UNARY
+}
@@ -0,0 +1,209 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+
+#include "Emitter.hpp"
+
+namespace benchmark {
+
+// Synthetic source files for the benchmarks, the same for the same seed. Every
+// kind is a sequence of expressions, one per line, of a given size each:
+//
+//     wide      array literals of size elements
+//     deep      size levels of brackets, calls, subscripts and prefixes around an operand
+//     chain     size binary operators in a row
+//     comments  small expressions between line and block comments, size per line
+//     literals  array literals of size numbers in every base and strings
+//     lines     small expressions, size terms at most
+//
+// Files of any size stream through an OutputBuffer, see generate_corpus.
+enum class CorpusKind { Wide, Deep, Chain, Comments, Literals, Lines };
+
+struct CorpusKindInfo {
+    CorpusKind kind;
+    std::string_view name;
+    std::size_t defaultSize;
+};
+
+inline constexpr CorpusKindInfo corpusKinds[] = {
+    { CorpusKind::Wide, "wide", 100000 },
+    { CorpusKind::Deep, "deep", 1000 },
+    { CorpusKind::Chain, "chain", 10000 },
+    { CorpusKind::Comments, "comments", 2 },
+    { CorpusKind::Literals, "literals", 1000 },
+    { CorpusKind::Lines, "lines", 4 },
+};
+
+inline std::optional<CorpusKindInfo> corpusKind(std::string_view name)
+{
+    for (const auto& info : corpusKinds) {
+        if (info.name == name) return info;
+    }
+    return std::nullopt;
+}
+
+class CorpusGenerator {
+public:
+    CorpusGenerator(CorpusKind kind, std::uint64_t seed, std::size_t size)
+        : m_kind(kind)
+        , m_random(seed)
+        , m_size(size)
+    {
+    }
+
+    // Writes whole expressions until at least bytes were written, returns their count.
+    std::size_t generate(frontend::OutputBuffer& out, std::size_t bytes)
+    {
+        std::size_t expressions = 0;
+        for (std::size_t written = 0; written < bytes; ++expressions) {
+            m_expression.clear();
+            appendExpression();
+            m_expression += '\n';
+            out.append(m_expression);
+            written += m_expression.size();
+        }
+        return expressions;
+    }
+
+    // The same, in memory.
+    std::string generate(std::size_t bytes, std::size_t* expressions = nullptr)
+    {
+        frontend::OutputBuffer out;
+        std::size_t count = generate(out, bytes);
+        if (expressions) *expressions = count;
+        return std::string(out.view());
+    }
+
+private:
+    std::size_t pick(std::size_t count) { return m_random() % count; }
+
+    void appendExpression()
+    {
+        switch (m_kind) {
+            case CorpusKind::Wide:
+                m_expression += '[';
+                for (std::size_t i = 0; i < m_size; ++i) {
+                    if (i > 0) m_expression += ", ";
+                    appendOperation(pick(3));
+                }
+                m_expression += ']';
+                return;
+            case CorpusKind::Deep:
+                appendNested();
+                return;
+            case CorpusKind::Chain:
+                appendOperation(m_size);
+                return;
+            case CorpusKind::Comments:
+                for (std::size_t i = 0; i < m_size; ++i) {
+                    m_expression += pick(2) == 0 ? "// A line comment about the next expression, as long as most.\n"
+                                                 : "/* A block comment\n   on two lines. */ ";
+                }
+                appendOperation(pick(4));
+                m_expression += " // and a comment after it";
+                return;
+            case CorpusKind::Literals:
+                m_expression += '[';
+                for (std::size_t i = 0; i < m_size; ++i) {
+                    if (i > 0) m_expression += ", ";
+                    appendLiteral();
+                }
+                m_expression += ']';
+                return;
+            case CorpusKind::Lines:
+                appendOperation(pick(m_size + 1));
+                return;
+        }
+    }
+
+    // A term, then operators and terms.
+    void appendOperation(std::size_t operators)
+    {
+        static const char* const binary[] = {
+            " + ", " - ", " * ", " / ", " % ", " << ", " >> ", " >>> ", " < ", " <= ", " > ", " >= ", " == ", " != "
+        };
+        appendTerm(0);
+        for (std::size_t i = 0; i < operators; ++i) {
+            m_expression += binary[pick(std::size(binary))];
+            appendTerm(0);
+        }
+    }
+
+    void appendTerm(std::size_t depth)
+    {
+        static const char* const names[] = { "a", "value", "someIdentifier", "_private", "x1" };
+        switch (depth > 1 ? pick(3) : pick(9)) {
+            case 0: m_expression += names[pick(std::size(names))]; return;
+            case 1: appendLiteral(); return;
+            case 2: m_expression += "object.member"; return;
+            case 3:
+                m_expression += "call(";
+                appendTerm(depth + 1);
+                m_expression += ", ";
+                appendTerm(depth + 1);
+                m_expression += ')';
+                return;
+            case 4:
+                m_expression += '[';
+                appendTerm(depth + 1);
+                m_expression += ", ";
+                appendTerm(depth + 1);
+                m_expression += ']';
+                return;
+            case 5:
+                m_expression += "items[";
+                appendTerm(depth + 1);
+                m_expression += ']';
+                return;
+            case 6: m_expression += '-'; appendTerm(depth + 1); return;
+            case 7: m_expression += "!"; appendTerm(depth + 1); return;
+            default: m_expression += "counter++"; return;
+        }
+    }
+
+    void appendLiteral()
+    {
+        static const char digits[] = "0123456789abcdef";
+        static const char* const prefixes[] = { "", "0x", "0b", "0o" };
+        static const unsigned bases[] = { 10, 16, 2, 8 };
+        auto base = pick(5);
+        if (base == 4) {
+            m_expression += '"';
+            m_expression.append(1 + pick(24), static_cast<char>('a' + pick(26)));
+            m_expression += '"';
+            return;
+        }
+        m_expression += prefixes[base];
+        std::size_t length = 1 + pick(base == 2 ? 32 : 12);
+        // Decimals other than 0 cannot start with 0.
+        m_expression += base == 0 ? digits[1 + pick(9)] : digits[pick(bases[base])];
+        for (std::size_t i = 1; i < length; ++i) m_expression += digits[pick(bases[base])];
+    }
+
+    void appendNested()
+    {
+        static const char* const opens[] = { "[", "f(", "xs[", "~", "-", "!" };
+        static const char* const closes[] = { "]", ")", "]", "", "", "" };
+        m_closes.clear();
+        for (std::size_t i = 0; i < m_size; ++i) {
+            auto kind = pick(std::size(opens));
+            m_expression += opens[kind];
+            m_closes += closes[kind];
+        }
+        m_expression += 'a';
+        m_expression.append(m_closes.rbegin(), m_closes.rend());
+    }
+
+    CorpusKind m_kind;
+    std::mt19937_64 m_random;
+    std::size_t m_size;
+    std::string m_expression;
+    std::string m_closes;
+};
+
+} // namespace benchmark
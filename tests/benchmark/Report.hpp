@@ -0,0 +1,98 @@
+#pragma once
+
+#include <charconv>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace benchmark {
+
+// The measurements of a benchmark run. Lines of text go to out() as they are
+// measured; with --json on the command line they go to std::cerr instead, and
+// finish() prints every measurement as one JSON document on std::cout:
+//
+//     {"benchmark":"bench_lexer","results":[{"name":"buffer","mb_per_s":812.4,"tokens_per_s":1.3e+08}]}
+//
+// Metric names carry their unit, so that runs can be compared over time.
+class Results {
+public:
+    using Metrics = std::vector<std::pair<std::string_view, double>>;
+
+    explicit Results(std::string benchmark) : m_benchmark(std::move(benchmark)) {}
+
+    // Takes --json out of the arguments, leaving the others in order.
+    void parseOptions(int& argc, char* argv[])
+    {
+        int kept = 1;
+        for (int i = 1; i < argc; ++i) {
+            if (std::string_view(argv[i]) == "--json") {
+                m_json = true;
+            } else {
+                argv[kept++] = argv[i];
+            }
+        }
+        argc = kept;
+    }
+
+    std::ostream& out() const noexcept { return m_json ? std::cerr : std::cout; }
+
+    void add(std::string_view name, const Metrics& metrics)
+    {
+        std::string result = "{\"name\":";
+        appendString(result, name);
+        for (const auto& [metric, value] : metrics) {
+            result += ',';
+            appendString(result, metric);
+            result += ':';
+            appendNumber(result, value);
+        }
+        result += '}';
+        m_results.push_back(std::move(result));
+    }
+
+    void finish() const
+    {
+        if (!m_json) return;
+        std::string document = "{\"benchmark\":";
+        appendString(document, m_benchmark);
+        document += ",\"results\":[";
+        for (std::size_t i = 0; i < m_results.size(); ++i) {
+            if (i > 0) document += ",\n";
+            document += m_results[i];
+        }
+        document += "]}\n";
+        std::cout << document << std::flush;
+    }
+
+private:
+    static void appendString(std::string& out, std::string_view text)
+    {
+        out += '"';
+        for (char c : text) {
+            if (c == '"' || c == '\\') out += '\\';
+            out += c;
+        }
+        out += '"';
+    }
+
+    // Infinities and NaN, from runs too short to time, are not JSON numbers.
+    static void appendNumber(std::string& out, double value)
+    {
+        if (!std::isfinite(value)) {
+            out += "null";
+            return;
+        }
+        char digits[32];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        out.append(digits, result.ptr);
+    }
+
+    std::string m_benchmark;
+    bool m_json = false;
+    std::vector<std::string> m_results;
+};
+
+} // namespace benchmark
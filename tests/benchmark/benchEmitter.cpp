@@ -0,0 +1,83 @@
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+#include "Emitter.hpp"
+#include "Lexer.hpp"
+#include "Parser.hpp"
+#include "Report.hpp"
+#include "Source.hpp"
+#include "Visitor.hpp"
+
+namespace {
+
+using BufferLexer = frontend::Lexer<2, frontend::BufferSource>;
+using BufferParser = frontend::Parser<BufferLexer>;
+
+benchmark::Results results("bench_emitter");
+
+BufferParser makeParser(std::string_view text)
+{
+    return BufferParser(BufferLexer(frontend::BufferSource(text)));
+}
+
+// Times function, which writes the tree and returns the bytes written, runs times.
+template <typename Function>
+void report(const char* name, std::size_t nodes, std::size_t runs, Function&& function)
+{
+    std::size_t bytes = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < runs; ++i) bytes += function();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    double megabytesPerSecond = bytes / elapsed.count() / 1e6;
+    double nanosecondsPerNode = elapsed.count() * 1e9 / (runs * nodes);
+    results.out() << name << ": " << bytes / runs / 1e6 << " MB, " << megabytesPerSecond << " MB/s, "
+                  << nanosecondsPerNode << " ns/node" << std::endl;
+    results.add(name, { { "mb_per_s", megabytesPerSecond }, { "ns_per_node", nanosecondsPerNode } });
+}
+
+} // namespace
+
+// Writes a large and shallow tree as JSON, as S-expressions and with dump().
+int main(int argc, char* argv[])
+{
+    results.parseOptions(argc, argv);
+    std::size_t terms = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+    std::size_t runs = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 10;
+    try {
+        std::string wide = "[a";
+        for (std::size_t i = 0; i < terms; ++i) wide += ", a + f(x, \"s\") * [1, 2][i]";
+        wide += "]";
+        auto tree = makeParser(wide).parseExpressionIterative();
+        struct NodeCounter : frontend::ConstVisitor<NodeCounter> {
+            std::size_t nodes = 0;
+            void visitExpression(const frontend::Expression&) { ++nodes; }
+        } counter;
+        counter.traverse(*tree);
+
+        auto emitted = [&](frontend::Emitter::Format format) {
+            std::size_t size = 0;
+            frontend::OutputBuffer sized([&](std::string_view block) { size += block.size(); });
+            frontend::Emitter(sized, { .format = format }).emit(*tree);
+            sized.flush();
+            return size;
+        };
+        report("json", counter.nodes, runs, [&] { return emitted(frontend::Emitter::Format::Json); });
+        report("sexpr", counter.nodes, runs, [&] { return emitted(frontend::Emitter::Format::SExpression); });
+        report("dump", counter.nodes, runs, [&] {
+            std::ostringstream os;
+            tree->dump(os, 0);
+            return os.str().size();
+        });
+    } catch (std::exception& exception) {
+        std::cerr << "Error: " << exception.what() << std::endl;
+        return 1;
+    }
+    results.finish();
+    return 0;
+}
@@ -0,0 +1,167 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Arena.hpp"
+#include "Corpus.hpp"
+#include "Emitter.hpp"
+#include "Lexer.hpp"
+#include "Parser.hpp"
+#include "Report.hpp"
+#include "Source.hpp"
+#include "Visitor.hpp"
+
+namespace {
+
+using MappedLexer = frontend::Lexer<2, frontend::MappedFileSource>;
+using MappedParser = frontend::Parser<MappedLexer>;
+
+benchmark::Results results("bench_end_to_end");
+
+MappedParser openParser(const std::string& path)
+{
+    return MappedParser(MappedLexer(frontend::MappedFileSource(path)));
+}
+
+// What a file holds, counted once before the timed runs.
+struct Counts {
+    std::size_t bytes = 0;
+    std::size_t tokens = 0;
+    std::size_t nodes = 0;
+    std::size_t expressions = 0;
+};
+
+Counts count(const std::string& path)
+{
+    Counts counts;
+    {
+        frontend::Lexer<1, frontend::MappedFileSource> lexer{ frontend::MappedFileSource(path) };
+        while (lexer.peek().type != frontend::TokenType::EndOfFile) {
+            ++counts.tokens;
+            lexer.skip();
+        }
+    }
+    struct NodeCounter : frontend::ConstVisitor<NodeCounter> {
+        std::size_t nodes = 0;
+        void visitExpression(const frontend::Expression&) { ++nodes; }
+    } counter;
+    auto parser = openParser(path);
+    frontend::Arena arena;
+    for (const auto& expression : parser.expressions(arena)) {
+        counter.traverse(expression);
+        ++counts.expressions;
+    }
+    counts.nodes = counter.nodes;
+    frontend::MappedFileSource file(path);
+    counts.bytes = static_cast<std::size_t>(file.end() - file.begin());
+    return counts;
+}
+
+// Times function, which returns the expressions it went through, and reports the
+// rates of the whole file.
+template <typename Function>
+void report(const std::string& name, const Counts& counts, Function&& function)
+{
+    auto start = std::chrono::steady_clock::now();
+    std::size_t expressions = function();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    if (expressions != counts.expressions) {
+        throw std::runtime_error(name + ": " + std::to_string(expressions) + " expressions instead of "
+            + std::to_string(counts.expressions) + ".");
+    }
+    double seconds = elapsed.count();
+    double megabytesPerSecond = counts.bytes / seconds / 1e6;
+    double tokensPerSecond = counts.tokens / seconds;
+    double nodesPerSecond = counts.nodes / seconds;
+    double nanosecondsPerExpression = seconds * 1e9 / counts.expressions;
+    results.out() << name << ": " << megabytesPerSecond << " MB/s, " << tokensPerSecond / 1e6 << " Mtokens/s, "
+                  << nodesPerSecond / 1e6 << " Mnodes/s, " << nanosecondsPerExpression << " ns/expression"
+                  << std::endl;
+    results.add(name, {
+        { "mb_per_s", megabytesPerSecond },
+        { "tokens_per_s", tokensPerSecond },
+        { "nodes_per_s", nodesPerSecond },
+        { "ns_per_expression", nanosecondsPerExpression },
+    });
+}
+
+// Lexes, parses, and parses then writes as JSON every expression of the file.
+void run(const std::string& name, const std::string& path)
+{
+    Counts counts = count(path);
+    results.out() << name << ": " << counts.bytes / 1e6 << " MB, " << counts.tokens << " tokens, " << counts.nodes
+                  << " nodes, " << counts.expressions << " expressions" << std::endl;
+    report(name + " lex", counts, [&] {
+        frontend::Lexer<1, frontend::MappedFileSource> lexer{ frontend::MappedFileSource(path) };
+        std::size_t tokens = 0;
+        while (lexer.peek().type != frontend::TokenType::EndOfFile) {
+            ++tokens;
+            lexer.skip();
+        }
+        // Every token counted, the expressions are not known to the lexer.
+        return tokens == counts.tokens ? counts.expressions : 0;
+    });
+    report(name + " parse", counts, [&] {
+        auto parser = openParser(path);
+        frontend::Arena arena;
+        std::size_t expressions = 0;
+        for (const auto& expression : parser.expressions(arena)) expressions += expression.to() >= expression.from();
+        return expressions;
+    });
+    report(name + " parse+emit", counts, [&] {
+        auto parser = openParser(path);
+        frontend::Arena arena;
+        std::size_t bytes = 0;
+        frontend::OutputBuffer out([&](std::string_view block) { bytes += block.size(); });
+        frontend::Emitter emitter(out, { .format = frontend::Emitter::Format::Json });
+        std::size_t expressions = 0;
+        for (const auto& expression : parser.expressions(arena)) {
+            emitter.emit(expression);
+            ++expressions;
+        }
+        out.flush();
+        return bytes > 0 ? expressions : 0;
+    });
+}
+
+} // namespace
+
+// Runs on every kind of generated corpus, of the given size in megabytes each, or on the given files.
+int main(int argc, char* argv[])
+{
+    results.parseOptions(argc, argv);
+    char* end = nullptr;
+    std::size_t megabytes = argc > 1 ? std::strtoull(argv[1], &end, 10) : 16;
+    bool files = argc > 1 && *end != '\0';
+    try {
+        if (files) {
+            for (int i = 1; i < argc; ++i) run(argv[i], argv[i]);
+        } else {
+            std::string path = "benchEndToEnd.corpus.js";
+            for (const auto& info : benchmark::corpusKinds) {
+                {
+                    std::FILE* file = std::fopen(path.c_str(), "wb");
+                    if (!file) throw std::runtime_error("Failed to create \"" + path + "\".");
+                    frontend::OutputBuffer out(file, 1 << 20);
+                    benchmark::CorpusGenerator(info.kind, 42, info.defaultSize).generate(out, megabytes << 20);
+                    out.flush();
+                    std::fclose(file);
+                }
+                run(std::string(info.name), path);
+            }
+            std::remove(path.c_str());
+        }
+    } catch (std::exception& exception) {
+        std::cerr << "Error: " << exception.what() << std::endl;
+        return 1;
+    }
+    results.finish();
+    return 0;
+}
@@ -0,0 +1,160 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <random>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "BatchEvaluator.hpp"
+#include "Bytecode.hpp"
+#include "Lexer.hpp"
+#include "Parser.hpp"
+#include "Report.hpp"
+#include "Scanner.hpp"
+#include "Source.hpp"
+#include "TreeInterpreter.hpp"
+#include "Value.hpp"
+#include "VirtualMachine.hpp"
+
+namespace {
+
+using BufferLexer = frontend::Lexer<2, frontend::BufferSource>;
+using BufferParser = frontend::Parser<BufferLexer>;
+
+benchmark::Results results("bench_evaluator");
+
+BufferParser makeParser(std::string_view text)
+{
+    return BufferParser(BufferLexer(frontend::BufferSource(text)));
+}
+
+backend::TreeInterpreter::Environment environment()
+{
+    backend::Object object;
+    object.emplace("n", backend::Value(std::int64_t(5)));
+    return {
+        { "a", backend::Value(std::int64_t(0)) },
+        { "b", backend::Value(std::int64_t(0)) },
+        { "xs", backend::Value(backend::Array{ std::int64_t(1), std::int64_t(2), std::int64_t(3) }) },
+        { "o", backend::Value(std::move(object)) },
+        { "f", backend::Value(backend::Function([](std::span<const backend::Value> arguments) {
+              return backend::Value(arguments[0].integer() + arguments[1].integer());
+          })) }
+    };
+}
+
+// Adds the results to checksum, which is printed so that the evaluations are kept.
+template <typename Function>
+double measure(std::size_t runs, std::int64_t& checksum, Function&& function)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < runs; ++i) {
+        backend::Value value = function(static_cast<std::int64_t>(i));
+        checksum += value.isInteger() ? static_cast<std::int64_t>(value.integer().low()) : value.boolean();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() * 1e9 / runs;
+}
+
+// Evaluates text runs times with new values of a and b, walking the tree and on the virtual machine.
+void compare(const char* name, std::string_view text, std::size_t runs)
+{
+    auto tree = makeParser(text).parseExpression();
+    auto variables = environment();
+    backend::TreeInterpreter interpreter(variables);
+    std::int64_t checksum = 0;
+    double walked = measure(runs, checksum, [&](std::int64_t i) {
+        variables.at("a") = backend::Value(i);
+        variables.at("b") = backend::Value(i * 7 + 1);
+        return interpreter.evaluate(*tree);
+    });
+    auto program = backend::Compiler::compile(*tree);
+    std::vector<backend::Value> inputs;
+    for (const auto& input : program.inputs()) {
+        inputs.push_back(variables.at(input.str()));
+    }
+    auto a = program.input("a");
+    auto b = program.input("b");
+    backend::VirtualMachine machine;
+    double executed = measure(runs, checksum, [&](std::int64_t i) {
+        if (a) inputs[*a] = backend::Value(i);
+        if (b) inputs[*b] = backend::Value(i * 7 + 1);
+        return machine.run(program, inputs);
+    });
+    results.out() << name << ": tree " << walked << " ns, bytecode " << executed << " ns per evaluation ("
+                  << program.code().size() << " instructions), " << walked / executed << "x (checksum " << checksum
+                  << ")" << std::endl;
+    results.add(std::string(name) + " tree", { { "ns_per_evaluation", walked } });
+    results.add(std::string(name) + " bytecode", { { "ns_per_evaluation", executed } });
+}
+
+// Rows per second on one core of the evaluations by batch, with the
+// scalar and the vector kernels, and row by row on the virtual machine.
+void batch(const char* name, std::string_view text, std::size_t rows)
+{
+    auto tree = makeParser(text).parseExpression();
+    auto program = backend::Compiler::compile(*tree);
+    std::mt19937_64 random(19);
+    std::vector<std::vector<std::int64_t>> values(program.inputs().size(), std::vector<std::int64_t>(rows));
+    std::vector<std::span<const std::int64_t>> columns;
+    for (auto& column : values) {
+        for (auto& value : column) value = static_cast<std::int64_t>(random() % 1000);
+        columns.emplace_back(column);
+    }
+    auto rate = [&](auto&& evaluate) {
+        auto start = std::chrono::steady_clock::now();
+        evaluate();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return rows / elapsed.count();
+    };
+    std::vector<std::int64_t> result(rows);
+    std::vector<std::uint64_t> selection((rows + 63) / 64);
+    auto run = [&](backend::BatchEvaluator& evaluator) {
+        if (evaluator.isPredicate()) {
+            evaluator.select(columns, rows, selection);
+        } else {
+            evaluator.evaluate(columns, result);
+        }
+    };
+    backend::VirtualMachine machine;
+    std::vector<backend::Value> inputs(columns.size());
+    double rowByRow = rate([&] {
+        for (std::size_t row = 0; row < rows; ++row) {
+            for (std::size_t i = 0; i < columns.size(); ++i) inputs[i] = backend::Value(columns[i][row]);
+            machine.run(program, inputs);
+        }
+    });
+    backend::BatchEvaluator scalar(*tree, frontend::scanner::Isa::Scalar);
+    double scalarRate = rate([&] { run(scalar); });
+    backend::BatchEvaluator vector(*tree);
+    double vectorRate = rate([&] { run(vector); });
+    results.out() << name << ": bytecode " << rowByRow / 1e6 << ", scalar batches " << scalarRate / 1e6
+                  << ", vector batches " << vectorRate / 1e6 << " million rows/s per core" << std::endl;
+    results.add(std::string(name) + " bytecode", { { "rows_per_s", rowByRow } });
+    results.add(std::string(name) + " scalar batches", { { "rows_per_s", scalarRate } });
+    results.add(std::string(name) + " vector batches", { { "rows_per_s", vectorRate } });
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    results.parseOptions(argc, argv);
+    std::size_t runs = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    try {
+        compare("arithmetic", "a * 3 + b / 7 - a % 5 + b * b - 3 * a * b + 17 * a - b % 3 + 12345 * 6789", runs);
+        compare("shifts and comparisons", "a << 3 >> 1 >>> 2 != b == a + 1 < b - ~a", runs);
+        compare("arrays, members and calls", "xs[a % 3] + o.n * f(a, b) - xs[b % 3]++ + [a, b, a + b][2]", runs);
+        batch("batch filter", "a * 2 + b >> 1 < c", runs * 10);
+        batch("batch projection", "a * 3 + b * b - c * 5 - ~a >>> 2", runs * 10);
+    } catch (std::exception& exception) {
+        std::cerr << "Error: " << exception.what() << std::endl;
+        return 1;
+    }
+    results.finish();
+    return 0;
+}
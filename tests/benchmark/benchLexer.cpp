@@ -0,0 +1,103 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+
+#include "Lexer.hpp"
+#include "Report.hpp"
+#include "Scanner.hpp"
+#include "Source.hpp"
+
+namespace {
+
+benchmark::Results results("bench_lexer");
+
+// Builds a token soup of roughly the requested size, with comments and indentation.
+// The trivia ratio is the chance out of 64 of emitting a comment instead of a token.
+std::string generateCorpus(std::size_t bytes, unsigned trivia)
+{
+    static const char* const pieces[] = {
+        "identifier", "someFunction", "_private", "0xff", "0b1010", "0o777", "12345",
+        "\"a string literal\"", "[", "]", "(", ")", ".", ",", "+", "-", "*", "/", "%",
+        "++", "--", "!", "~", "<", "<=", ">", ">=", "<<", ">>", ">>>", "==", "!="
+    };
+    constexpr std::size_t pieceCount = sizeof(pieces) / sizeof(pieces[0]);
+    std::mt19937 random(42);
+    std::string corpus;
+    corpus.reserve(bytes + 64);
+    while (corpus.size() < bytes) {
+        auto choice = random() % 64;
+        if (choice < trivia / 2) {
+            corpus += "\n    // A line comment describing the next expression.\n    ";
+        } else if (choice < trivia) {
+            corpus += "/* A block\n       comment. */ ";
+        } else {
+            corpus += pieces[random() % pieceCount];
+            corpus += ' ';
+        }
+    }
+    return corpus;
+}
+
+template <typename Source>
+std::size_t lexAll(Source&& source)
+{
+    frontend::Lexer<1, Source> lexer(std::move(source));
+    std::size_t tokens = 0;
+    while (lexer.peek().type != frontend::TokenType::EndOfFile) {
+        ++tokens;
+        lexer.skip();
+    }
+    return tokens;
+}
+
+template <typename Function>
+void report(const char* name, std::size_t bytes, Function&& function)
+{
+    auto start = std::chrono::steady_clock::now();
+    std::size_t tokens = function();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    results.out() << name << ": " << bytes / elapsed.count() / 1e6 << " MB/s, "
+                  << tokens / elapsed.count() / 1e6 << " Mtokens/s" << std::endl;
+    results.add(name, { { "mb_per_s", bytes / elapsed.count() / 1e6 }, { "tokens_per_s", tokens / elapsed.count() } });
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    results.parseOptions(argc, argv);
+    std::size_t megabytes = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 16;
+    std::string corpus = generateCorpus(megabytes << 20, 2);
+    std::string trivia = generateCorpus(megabytes << 20, 48);
+    std::string path = "benchLexer.corpus.js";
+    {
+        std::ofstream output(path, std::ios::binary);
+        output << corpus;
+    }
+    try {
+        report("stream", corpus.size(), [&] { return lexAll(frontend::StreamSource(std::ifstream(path))); });
+        report("buffer", corpus.size(), [&] { return lexAll(frontend::BufferSource(corpus)); });
+        report("mmap", corpus.size(), [&] { return lexAll(frontend::MappedFileSource(path)); });
+        // Scanning kernels on a comment-heavy corpus.
+        using frontend::scanner::Isa;
+        for (auto [isa, name] : { std::pair{ Isa::Scalar, "trivia scalar" }, { Isa::SSE2, "trivia sse2" }, { Isa::AVX2, "trivia avx2" } }) {
+            if (static_cast<int>(isa) > static_cast<int>(frontend::scanner::detect())) continue;
+            frontend::scanner::use(isa);
+            report(name, trivia.size(), [&] { return lexAll(frontend::BufferSource(trivia)); });
+        }
+        frontend::scanner::use(frontend::scanner::detect());
+    } catch (std::exception& exception) {
+        std::cerr << "Error: " << exception.what() << std::endl;
+        std::remove(path.c_str());
+        return 1;
+    }
+    std::remove(path.c_str());
+    results.finish();
+    return 0;
+}
@@ -0,0 +1,455 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "BinaryAST.hpp"
+#include "FlatAST.hpp"
+#include "IncrementalParser.hpp"
+#include "Lexer.hpp"
+#include "ParallelParser.hpp"
+#include "ParseCache.hpp"
+#include "Parser.hpp"
+#include "Report.hpp"
+#include "Source.hpp"
+#include "ThreadPool.hpp"
+#include "TokenStream.hpp"
+
+namespace {
+
+std::atomic<std::size_t> allocations = 0;
+benchmark::Results results("bench_parser");
+
+using BufferLexer = frontend::Lexer<2, frontend::BufferSource>;
+using BufferParser = frontend::Parser<BufferLexer>;
+
+BufferParser makeParser(std::string_view text)
+{
+    return BufferParser(BufferLexer(frontend::BufferSource(text)));
+}
+
+// Appends a random term and returns the number of nodes it parses into.
+std::size_t generateTerm(std::mt19937& random, std::string& out, std::size_t depth)
+{
+    switch (depth > 2 ? random() % 3 : random() % 8) {
+        case 0: out += "identifier"; return 1;
+        case 1: out += "0x1f"; return 1;
+        case 2: out += "\"text\""; return 1;
+        case 3: out += "object.member"; return 3;
+        case 4: {
+            out += "call(";
+            std::size_t nodes = 2 + generateTerm(random, out, depth + 1);
+            out += ", ";
+            nodes += generateTerm(random, out, depth + 1);
+            out += ')';
+            return nodes;
+        }
+        case 5: {
+            out += '[';
+            std::size_t nodes = 1 + generateTerm(random, out, depth + 1);
+            out += ", ";
+            nodes += generateTerm(random, out, depth + 1);
+            out += ']';
+            return nodes;
+        }
+        case 6: out += "-"; return 1 + generateTerm(random, out, depth + 1);
+        default: out += "counter++"; return 2;
+    }
+}
+
+// A large array literal of operator chains.
+std::string generateCorpus(std::size_t elements, std::size_t& nodes)
+{
+    static const char* const operators[] = {
+        " + ", " - ", " * ", " / ", " % ", " << ", " >> ", " >>> ", " < ", " <= ", " > ", " >= ", " == ", " != "
+    };
+    std::mt19937 random(42);
+    std::string corpus = "[";
+    nodes = 1;
+    for (std::size_t i = 0; i < elements; ++i) {
+        if (i > 0) corpus += ",\n";
+        nodes += generateTerm(random, corpus, 0);
+        for (std::size_t j = random() % 6; j > 0; --j) {
+            corpus += operators[random() % 14];
+            nodes += 1 + generateTerm(random, corpus, 0);
+        }
+    }
+    corpus += "]";
+    return corpus;
+}
+
+// Short operands buried in unary and binary operators, in the style of tests/data/examples.js.
+std::string generateOperatorCorpus(std::size_t elements, std::size_t& nodes)
+{
+    static const char* const operators[] = {
+        " + ", " - ", " * ", " / ", " % ", " << ", " >> ", " >>> ", " < ", " <= ", " > ", " >= ", " == ", " != "
+    };
+    static const char* const prefixes[] = { "-", "+", "!", "~", "++", "--" };
+    static const char* const operands[] = { "a", "1", "0xff", "\"s\"", "b.c", "d[1]", "e++", "f()" };
+    static const std::size_t operandNodes[] = { 1, 1, 1, 1, 3, 3, 2, 2 };
+    std::mt19937 random(42);
+    std::string corpus = "[";
+    nodes = 1;
+    for (std::size_t i = 0; i < elements; ++i) {
+        if (i > 0) corpus += ", ";
+        for (std::size_t j = 1 + random() % 8; j > 0; --j) {
+            for (std::size_t k = random() % 3; k > 0; --k) {
+                corpus += prefixes[random() % 6];
+                ++nodes;
+            }
+            auto operand = random() % 8;
+            corpus += operands[operand];
+            nodes += operandNodes[operand];
+            if (j > 1) {
+                corpus += operators[random() % 14];
+                ++nodes;
+            }
+        }
+    }
+    corpus += "]";
+    return corpus;
+}
+
+// One expression per line, every tenth one closed by ';'.
+std::string generateLines(std::size_t lines)
+{
+    static const char* const operators[] = {
+        " + ", " - ", " * ", " / ", " % ", " << ", " >> ", " >>> ", " < ", " <= ", " > ", " >= ", " == ", " != "
+    };
+    std::mt19937 random(7);
+    std::string corpus;
+    for (std::size_t i = 0; i < lines; ++i) {
+        generateTerm(random, corpus, 0);
+        for (std::size_t j = random() % 4; j > 0; --j) {
+            corpus += operators[random() % 14];
+            generateTerm(random, corpus, 0);
+        }
+        corpus += i % 10 == 9 ? ";\n" : "\n";
+    }
+    return corpus;
+}
+
+// Nests open/close around a single operand, depth times.
+std::string generateNested(const char* open, const char* close, std::size_t depth)
+{
+    std::string text;
+    for (std::size_t i = 0; i < depth; ++i) text += open;
+    text += 'a';
+    for (std::size_t i = 0; i < depth; ++i) text += close;
+    return text;
+}
+
+// Sums the source lengths of all nodes, walking the class tree.
+std::size_t walkTree(const frontend::Expression& node)
+{
+    using namespace frontend;
+    std::size_t sum = node.to() - node.from();
+    switch (node.nodeType()) {
+        case NodeType::Identifier:
+        case NodeType::NumericLiteral:
+        case NodeType::StringLiteral:
+            return sum;
+        case NodeType::ArrayLiteral:
+            for (auto& element : static_cast<const ArrayLiteral&>(node).elements()) sum += walkTree(*element);
+            return sum;
+        case NodeType::MemberAccess: {
+            auto& access = static_cast<const MemberAccess&>(node);
+            return sum + walkTree(access.argument()) + walkTree(access.identifier());
+        }
+        case NodeType::FunctionCall: {
+            auto& call = static_cast<const FunctionCall&>(node);
+            sum += walkTree(call.function());
+            for (auto& argument : call.arguments()) sum += walkTree(*argument);
+            return sum;
+        }
+        case NodeType::SubscriptAccess: {
+            auto& access = static_cast<const SubscriptAccess&>(node);
+            return sum + walkTree(access.argument()) + walkTree(access.subscript());
+        }
+        case NodeType::PostIncrement:
+        case NodeType::PostDecrement:
+        case NodeType::PreIncrement:
+        case NodeType::PreDecrement:
+        case NodeType::Negative:
+        case NodeType::Positive:
+        case NodeType::LogicalNegation:
+        case NodeType::BitwiseNot:
+            return sum + walkTree(static_cast<const UnaryOperator&>(node).argument());
+        default: {
+            auto& binary = static_cast<const BinaryOperator&>(node);
+            return sum + walkTree(binary.lhs()) + walkTree(binary.rhs());
+        }
+    }
+}
+
+// The same pass over the flat columns.
+std::size_t walkFlat(const frontend::FlatAST& flat)
+{
+    auto froms = flat.froms();
+    auto tos = flat.tos();
+    std::size_t sum = 0;
+    for (std::size_t i = 0; i < froms.size(); ++i) sum += tos[i] - froms[i];
+    return sum;
+}
+
+template <typename Function>
+void reportWalk(const char* name, std::size_t nodes, std::size_t bytes, Function&& function)
+{
+    constexpr int repetitions = 10;
+    std::size_t checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repetitions; ++i) checksum += function();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    results.out() << name << ": " << nodes * repetitions / elapsed.count() / 1e6 << " Mnodes/s walked, "
+                  << double(bytes) / nodes << " bytes/node (checksum " << checksum << ")" << std::endl;
+    results.add(name, {
+        { "nodes_per_s", nodes * repetitions / elapsed.count() },
+        { "bytes_per_node", double(bytes) / nodes },
+    });
+}
+
+template <typename Function>
+void reportExpressions(const char* name, std::size_t bytes, Function&& function)
+{
+    std::size_t allocationsBefore = allocations;
+    auto start = std::chrono::steady_clock::now();
+    std::size_t expressions = function();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    double allocationsPerExpression = double(allocations - allocationsBefore) / expressions;
+    results.out() << name << ": " << expressions / elapsed.count() / 1e6 << " Mexpressions/s, "
+                  << bytes / elapsed.count() / 1e6 << " MB/s, "
+                  << allocationsPerExpression << " allocations/expression" << std::endl;
+    results.add(name, {
+        { "ns_per_expression", elapsed.count() * 1e9 / expressions },
+        { "mb_per_s", bytes / elapsed.count() / 1e6 },
+        { "allocations_per_expression", allocationsPerExpression },
+    });
+}
+
+template <typename Function>
+void report(const char* name, std::size_t nodes, Function&& function)
+{
+    std::size_t allocationsBefore = allocations;
+    auto start = std::chrono::steady_clock::now();
+    function();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    double allocationsPerNode = double(allocations - allocationsBefore) / nodes;
+    results.out() << name << ": " << elapsed.count() * 1e3 << " ms parse+destroy, "
+                  << nodes / elapsed.count() / 1e6 << " Mnodes/s, "
+                  << allocationsPerNode << " allocations/node" << std::endl;
+    results.add(name, {
+        { "ms", elapsed.count() * 1e3 },
+        { "nodes_per_s", nodes / elapsed.count() },
+        { "allocations_per_node", allocationsPerNode },
+    });
+}
+
+} // namespace
+
+void* operator new(std::size_t size)
+{
+    ++allocations;
+    if (void* memory = std::malloc(size ? size : 1)) return memory;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+
+int main(int argc, char* argv[])
+{
+    results.parseOptions(argc, argv);
+    std::size_t elements = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+    std::size_t maxThreads = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : std::thread::hardware_concurrency();
+    std::size_t nodes = 0;
+    std::string corpus = generateCorpus(elements, nodes);
+    results.out() << corpus.size() / 1e6 << " MB, " << nodes << " nodes" << std::endl;
+    try {
+        report("heap", nodes, [&] {
+            auto parser = makeParser(corpus);
+            auto ast = parser.parseExpression();
+        });
+        report("arena", nodes, [&] {
+            auto parser = makeParser(corpus);
+            auto result = parser.parseExpressionInArena();
+        });
+        report("arena (huge pages)", nodes, [&] {
+            auto parser = makeParser(corpus);
+            auto result = parser.parseExpressionInArena({ .hugePages = true });
+        });
+        // Lexing interleaved with parsing, against tokenizing everything first.
+        report("arena (lexer)", nodes, [&] {
+            auto parser = makeParser(corpus);
+            auto result = parser.parseExpressionInArena();
+        });
+        report("arena (token stream)", nodes, [&] {
+            auto tokens = frontend::TokenStream::tokenize(std::string_view(corpus));
+            frontend::Parser<frontend::TokenCursor> parser{ frontend::TokenCursor(tokens) };
+            auto result = parser.parseExpressionInArena();
+        });
+        // Chunks of the same array parsed on 1 to maxThreads threads, tokenized beforehand.
+        auto tokens = frontend::TokenStream::tokenize(std::string_view(corpus));
+        report("sequential (token stream)", nodes, [&] {
+            frontend::Parser<frontend::TokenCursor> parser{ frontend::TokenCursor(tokens) };
+            auto result = parser.parseExpressionInArena();
+        });
+        std::vector<std::size_t> threadCounts;
+        for (std::size_t threads = 1; threads < maxThreads; threads *= 2) threadCounts.push_back(threads);
+        threadCounts.push_back(std::max<std::size_t>(maxThreads, 1));
+        for (std::size_t threads : threadCounts) {
+            frontend::ThreadPool pool(threads);
+            frontend::ParallelParser parallel(pool);
+            std::string name = "parallel (" + std::to_string(threads) + " threads)";
+            report(name.c_str(), nodes, [&] { auto result = parallel.parse(tokens); });
+        }
+        {
+            // A small edit in the middle of the array, undone at every other step.
+            auto position = static_cast<std::uint32_t>(corpus.find(',', corpus.size() / 2));
+            std::string edited = corpus;
+            edited.insert(position, " * c");
+            const frontend::TextEdit insertion{ position, position, 4 }, removal{ position, position + 4, 0 };
+            frontend::IncrementalParser parser(corpus);
+            constexpr int edits = 100;
+            std::size_t relexed = 0, reparsed = 0;
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < edits; ++i) {
+                bool insert = i % 2 == 0;
+                auto result = parser.reparse(insert ? edited : corpus, { insert ? &insertion : &removal, 1 });
+                relexed += result.relexedTokens;
+                reparsed += result.reparsedTokens;
+            }
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            results.out() << "incremental edit: " << elapsed.count() * 1e3 / edits << " ms/edit, "
+                          << double(relexed) / edits << " tokens lexed and " << double(reparsed) / edits
+                          << " parsed per edit" << std::endl;
+            results.add("incremental edit", {
+                { "ms_per_edit", elapsed.count() * 1e3 / edits },
+                { "tokens_lexed_per_edit", double(relexed) / edits },
+                { "tokens_parsed_per_edit", double(reparsed) / edits },
+            });
+        }
+        {
+            // Rules looked up again and again, all of them cached after the first round.
+            std::vector<std::string> rules;
+            for (int i = 0; i < 1000; ++i) {
+                rules.push_back("user.groups[" + std::to_string(i) + "].quota >= limits(\"disk\", " + std::to_string(i % 10) + ") * 1024");
+            }
+            frontend::ParseCache cache;
+            constexpr int rounds = 1000;
+            std::size_t checksum = 0;
+            auto start = std::chrono::steady_clock::now();
+            for (int round = 0; round < rounds; ++round) {
+                for (const auto& rule : rules) checksum += cache.parse(rule)->root().to();
+            }
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            auto stats = cache.stats();
+            double nanosecondsPerLookup = elapsed.count() * 1e9 / (rounds * rules.size());
+            results.out() << "parse cache: " << nanosecondsPerLookup << " ns/lookup, " << stats.hits << " hits, "
+                          << stats.misses << " misses (checksum " << checksum << ")" << std::endl;
+            results.add("parse cache", { { "ns_per_lookup", nanosecondsPerLookup } });
+        }
+        std::size_t operatorNodes = 0;
+        std::string operatorCorpus = generateOperatorCorpus(elements, operatorNodes);
+        report("arena (operators)", operatorNodes, [&] {
+            auto parser = makeParser(operatorCorpus);
+            auto result = parser.parseExpressionInArena();
+        });
+        auto parser = makeParser(corpus);
+        auto result = parser.parseExpressionInArena();
+        auto flat = frontend::FlatAST::fromTree(result.root());
+        reportWalk("walk tree", nodes, result.arena()->allocatedBytes(), [&] { return walkTree(result.root()); });
+        reportWalk("walk flat", nodes, flat.memoryUsage(), [&] { return walkFlat(flat); });
+        // A large file of independent expressions, parsed from a single lexer.
+        std::string lines = generateLines(elements * 5);
+        std::string path = "benchParser.lines.js";
+        {
+            std::ofstream output(path, std::ios::binary);
+            output << lines;
+        }
+        using MappedParser = frontend::Parser<frontend::Lexer<2, frontend::MappedFileSource>>;
+        auto openLines = [&] { return MappedParser(frontend::Lexer<2, frontend::MappedFileSource>(frontend::MappedFileSource(path))); };
+        reportExpressions("lines (heap)", lines.size(), [&] {
+            auto parser = openLines();
+            std::size_t count = 0;
+            while (auto expression = parser.parseNext()) ++count;
+            return count;
+        });
+        reportExpressions("lines (arena per expression)", lines.size(), [&] {
+            auto parser = openLines();
+            std::size_t count = 0;
+            while (true) {
+                frontend::Arena arena;
+                if (!parser.parseNext(arena)) break;
+                ++count;
+            }
+            return count;
+        });
+        reportExpressions("lines (reused arena)", lines.size(), [&] {
+            auto parser = openLines();
+            frontend::Arena arena;
+            std::size_t count = 0;
+            for (const auto& expression : parser.expressions(arena)) count += expression.to() > expression.from();
+            return count;
+        });
+        // The same expressions loaded from a binary cache instead of parsed again.
+        std::string cachePath = "benchParser.lines.ast";
+        {
+            auto parser = openLines();
+            frontend::Arena arena;
+            frontend::BinaryASTWriter writer;
+            for (const auto& expression : parser.expressions(arena)) writer.add(expression);
+            std::ofstream output(cachePath, std::ios::binary);
+            output << writer.finish();
+        }
+        reportExpressions("lines (binary cache)", lines.size(), [&] {
+            frontend::MappedFileSource file(cachePath);
+            frontend::BinaryAST binary(std::string_view(file.begin(), file.end() - file.begin()));
+            auto flat = binary.toFlat();
+            return std::size_t(binary.treeCount());
+        });
+        reportExpressions("lines (binary cache, trusted)", lines.size(), [&] {
+            frontend::MappedFileSource file(cachePath);
+            frontend::BinaryAST binary(std::string_view(file.begin(), file.end() - file.begin()),
+                frontend::BinaryAST::Trust::Trusted);
+            auto flat = binary.toFlat();
+            return std::size_t(binary.treeCount());
+        });
+        std::remove(cachePath.c_str());
+        std::remove(path.c_str());
+        // Nesting far beyond what the call stack holds, only the iterative parser survives it.
+        constexpr std::size_t depth = 1000000;
+        for (auto [open, close, nodesPerLevel, name] : {
+            std::tuple{ "[", "]", 1, "nested arrays" }, { "~", "", 1, "nested prefixes" }, { "f(", ")", 2, "nested calls" }
+        }) {
+            std::size_t nestedNodes = depth * nodesPerLevel + 1;
+            std::string nested = generateNested(open, close, depth);
+            std::string heap = std::string(name) + " (heap)";
+            std::string arena = std::string(name) + " (arena)";
+            report(heap.c_str(), nestedNodes, [&] {
+                auto parser = makeParser(nested);
+                auto ast = parser.parseExpressionIterative();
+            });
+            report(arena.c_str(), nestedNodes, [&] {
+                auto parser = makeParser(nested);
+                auto result = parser.parseExpressionIterativeInArena();
+            });
+        }
+    } catch (std::exception& exception) {
+        std::cerr << "Error: " << exception.what() << std::endl;
+        return 1;
+    }
+    results.finish();
+    return 0;
+}
@@ -0,0 +1,224 @@
+#include <algorithm>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "Lexer.hpp"
+#include "Parser.hpp"
+#include "Report.hpp"
+#include "Source.hpp"
+#include "Visitor.hpp"
+
+namespace {
+
+using BufferLexer = frontend::Lexer<2, frontend::BufferSource>;
+using BufferParser = frontend::Parser<BufferLexer>;
+
+benchmark::Results results("bench_visitor");
+
+BufferParser makeParser(std::string_view text)
+{
+    return BufferParser(BufferLexer(frontend::BufferSource(text)));
+}
+
+// An expression of every kind of node, terms terms long.
+std::string generate(std::size_t terms)
+{
+    static const char* const parts[] = { "a", "0x1f", "\"text\"", "o.m", "f(a, 2)", "[a, b]", "xs[i]", "-a",
+        "~b", "a++", "!c" };
+    static const char* const operators[] = { " + ", " * ", " << ", " < ", " == ", " - " };
+    std::mt19937 random(22);
+    std::string text = "a";
+    for (std::size_t i = 0; i < terms; ++i) {
+        text += operators[random() % std::size(operators)];
+        text += parts[random() % std::size(parts)];
+    }
+    return text;
+}
+
+// The per-node work of both traversals: positions, literals and operands.
+struct Summary {
+    std::uint64_t positions = 0;
+    std::uint64_t literals = 0;
+    std::uint64_t operands = 0;
+};
+
+class VirtualVisitor;
+
+// The virtual way, for comparison: a mirror of the tree whose nodes give their
+// children and call their handler through virtual calls, like a node hierarchy
+// with virtual children() and accept() would.
+class VirtualNode {
+public:
+    virtual ~VirtualNode() = default;
+    virtual void accept(VirtualVisitor& visitor) const = 0;
+    virtual void children(std::vector<const VirtualNode*>& children) const = 0;
+
+    void add(const VirtualNode& child) { m_children.push_back(&child); }
+
+protected:
+    std::vector<const VirtualNode*> m_children;
+};
+
+class VirtualVisitor {
+public:
+    virtual ~VirtualVisitor() = default;
+    virtual void visitNumericLiteral(const frontend::NumericLiteral& node) = 0;
+    virtual void visitBinaryOperator(const frontend::BinaryOperator& node) = 0;
+    virtual void visitExpression(const frontend::Expression& node) = 0;
+};
+
+// The mirror of a node of class Class.
+template <typename Class>
+class MirrorNode final : public VirtualNode {
+public:
+    explicit MirrorNode(const Class& node) noexcept : m_node(node) {}
+
+    void accept(VirtualVisitor& visitor) const override
+    {
+        if constexpr (std::same_as<Class, frontend::NumericLiteral>) {
+            visitor.visitNumericLiteral(m_node);
+        } else if constexpr (std::derived_from<Class, frontend::BinaryOperator>) {
+            visitor.visitBinaryOperator(m_node);
+        } else {
+            visitor.visitExpression(m_node);
+        }
+    }
+    void children(std::vector<const VirtualNode*>& children) const override
+    {
+        children.insert(children.end(), m_children.begin(), m_children.end());
+    }
+
+private:
+    const Class& m_node;
+};
+
+// Owns the mirror of every node, built without recursion; the root comes first.
+std::vector<std::unique_ptr<VirtualNode>> mirror(const frontend::Expression& root)
+{
+    std::vector<std::unique_ptr<VirtualNode>> nodes;
+    std::vector<std::pair<const frontend::Expression*, VirtualNode*>> pending{ { &root, nullptr } };
+    while (!pending.empty()) {
+        auto [node, parent] = pending.back();
+        pending.pop_back();
+        nodes.push_back(frontend::dispatch(*node, []<typename T>(const T& typed) -> std::unique_ptr<VirtualNode> {
+            return std::make_unique<MirrorNode<T>>(typed);
+        }));
+        if (parent) parent->add(*nodes.back());
+        std::size_t first = pending.size();
+        frontend::forEachChild(*node, [&](const frontend::Expression& child) {
+            pending.emplace_back(&child, nodes.back().get());
+        });
+        std::reverse(pending.begin() + first, pending.end());
+    }
+    return nodes;
+}
+
+struct VirtualSummarizer final : VirtualVisitor {
+    Summary summary;
+
+    void visitNumericLiteral(const frontend::NumericLiteral& node) override
+    {
+        summary.literals += node.literal().handle();
+        visitExpression(node);
+    }
+    void visitBinaryOperator(const frontend::BinaryOperator& node) override
+    {
+        summary.operands += node.rhs().to() - node.lhs().from();
+        visitExpression(node);
+    }
+    void visitExpression(const frontend::Expression& node) override { summary.positions += node.from(); }
+};
+
+Summary summarizeVirtually(const VirtualNode& root)
+{
+    VirtualSummarizer summarizer;
+    std::vector<const VirtualNode*> pending{ &root };
+    while (!pending.empty()) {
+        const VirtualNode* node = pending.back();
+        pending.pop_back();
+        node->accept(summarizer);
+        node->children(pending);
+    }
+    return summarizer.summary;
+}
+
+// The same with the switch of the visitor.
+struct Summarizer : frontend::ConstVisitor<Summarizer> {
+    Summary summary;
+
+    void visitNumericLiteral(const frontend::NumericLiteral& node)
+    {
+        summary.literals += node.literal().handle();
+        visitExpression(node);
+    }
+    void visitBinaryOperator(const frontend::BinaryOperator& node)
+    {
+        summary.operands += node.rhs().to() - node.lhs().from();
+        visitExpression(node);
+    }
+    void visitExpression(const frontend::Expression& node) { summary.positions += node.from(); }
+};
+
+template <typename Function>
+double measure(std::size_t runs, std::size_t nodes, Function&& function)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < runs; ++i) function();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() * 1e9 / (runs * nodes);
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    results.parseOptions(argc, argv);
+    std::size_t terms = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+    std::size_t runs = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 20;
+    try {
+        auto tree = makeParser(generate(terms)).parseExpressionIterative();
+        auto mirrored = mirror(*tree);
+        Summary expected = summarizeVirtually(*mirrored.front());
+        std::size_t nodes = 0;
+        struct NodeCounter : frontend::ConstVisitor<NodeCounter> {
+            std::size_t* nodes;
+            void visitExpression(const frontend::Expression&) { ++*nodes; }
+        } counter;
+        counter.nodes = &nodes;
+        counter.traverse(*tree);
+
+        Summary virtualSummary;
+        double virtualTime = measure(runs, nodes, [&] { virtualSummary = summarizeVirtually(*mirrored.front()); });
+        Summarizer summarizer;
+        double staticTime = measure(runs, nodes, [&] {
+            summarizer.summary = {};
+            summarizer.traverse(*tree);
+        });
+        const Summary& actual = summarizer.summary;
+        if (actual.positions != expected.positions || actual.literals != expected.literals ||
+            actual.operands != expected.operands || virtualSummary.positions != expected.positions) {
+            std::cerr << "Error: the traversals disagree." << std::endl;
+            return 1;
+        }
+        results.out() << nodes << " nodes: virtual calls " << virtualTime << " ns, static dispatch " << staticTime
+                      << " ns per node, " << virtualTime / staticTime << "x" << std::endl;
+        results.add("virtual calls", { { "ns_per_node", virtualTime } });
+        results.add("static dispatch", { { "ns_per_node", staticTime } });
+    } catch (std::exception& exception) {
+        std::cerr << "Error: " << exception.what() << std::endl;
+        return 1;
+    }
+    results.finish();
+    return 0;
+}
@@ -0,0 +1,44 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <string>
+
+#include "Corpus.hpp"
+#include "Emitter.hpp"
+
+namespace {
+
+void usage()
+{
+    std::cerr << "Usage: ./generate_corpus <kind> <megabytes> [seed] [size] > corpus.js" << std::endl
+              << "Kinds and their default size:";
+    for (const auto& info : benchmark::corpusKinds) std::cerr << ' ' << info.name << " (" << info.defaultSize << ")";
+    std::cerr << std::endl;
+    std::exit(1);
+}
+
+} // namespace
+
+// Streams a corpus of any size to the standard output, see Corpus.hpp.
+int main(int argc, char* argv[])
+{
+    if (argc < 3 || argc > 5) usage();
+    auto info = benchmark::corpusKind(argv[1]);
+    if (!info) usage();
+    std::size_t megabytes = std::strtoull(argv[2], nullptr, 10);
+    std::uint64_t seed = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 42;
+    std::size_t size = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : info->defaultSize;
+    try {
+        frontend::OutputBuffer out(stdout, 1 << 20);
+        benchmark::CorpusGenerator generator(info->kind, seed, size);
+        std::size_t expressions = generator.generate(out, megabytes << 20);
+        out.flush();
+        std::cerr << expressions << " expressions" << std::endl;
+    } catch (std::exception& exception) {
+        std::cerr << "Error: " << exception.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
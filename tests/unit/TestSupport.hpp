@@ -0,0 +1,60 @@
+#pragma once
+
+#include <exception>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+#include "ASTNode.hpp"
+#include "FlatAST.hpp"
+#include "Lexer.hpp"
+#include "Parser.hpp"
+#include "Source.hpp"
+
+// Helpers shared by the unit tests, each of which is its own program.
+
+using BufferLexer = frontend::Lexer<2, frontend::BufferSource>;
+using BufferParser = frontend::Parser<BufferLexer>;
+
+// The number of failed checks, the test fails when it is not zero.
+inline int failures = 0;
+
+inline BufferParser makeParser(std::string_view text)
+{
+    return BufferParser(BufferLexer(frontend::BufferSource(text)));
+}
+
+inline void expect(bool condition, std::string_view what)
+{
+    if (!condition) {
+        std::cerr << "Failed: " << what << std::endl;
+        ++failures;
+    }
+}
+
+// The dump() of a tree, for comparing trees that FlatAST cannot hold.
+inline std::string dump(const frontend::Expression& tree)
+{
+    std::ostringstream os;
+    tree.dump(os, 0);
+    return os.str();
+}
+
+// The flat columns of a tree, or the error message of building it.
+struct ParseOutcome {
+    frontend::FlatAST flat;
+    std::string error;
+
+    bool operator==(const ParseOutcome&) const = default;
+};
+
+template <typename Flatten>
+ParseOutcome outcomeOf(Flatten&& flatten)
+{
+    try {
+        return { flatten(), {} };
+    } catch (std::exception& exception) {
+        return { frontend::FlatAST(), exception.what() };
+    }
+}
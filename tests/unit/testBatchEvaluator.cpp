@@ -0,0 +1,155 @@
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "BatchEvaluator.hpp"
+#include "Bytecode.hpp"
+#include "Parser.hpp"
+#include "Scanner.hpp"
+#include "Value.hpp"
+#include "VirtualMachine.hpp"
+
+#include "TestSupport.hpp"
+
+// Evaluates random integer expressions over random columns in batches, with every
+// instruction set, and compares each row, and the errors, with the virtual machine.
+
+namespace {
+
+std::string generate(std::mt19937& random, int depth)
+{
+    static const char* const leaves[] = { "a", "b", "c", "0", "1", "2", "3", "63", "64", "-1",
+        "9223372036854775807" };
+    static const char* const binary[] = { "+", "-", "*", "/", "%", "<<", ">>", ">>>", "<", "<=", ">", ">=",
+        "==", "!=" };
+    static const char* const unary[] = { "-", "+", "!", "~" };
+    if (depth == 0) return leaves[random() % std::size(leaves)];
+    if (random() % 4 == 0) return std::string(unary[random() % std::size(unary)]) + ' ' + generate(random, 0);
+    return generate(random, depth - 1) + ' ' + binary[random() % std::size(binary)] + ' ' +
+        generate(random, depth - 1);
+}
+
+// Mostly small values, which make sensible shift counts and divisors, and the extremes.
+std::vector<std::int64_t> column(std::mt19937_64& random, std::size_t rows)
+{
+    std::vector<std::int64_t> values(rows);
+    for (auto& value : values) {
+        switch (random() % 8) {
+            case 0: value = std::numeric_limits<std::int64_t>::min(); break;
+            case 1: value = std::numeric_limits<std::int64_t>::max(); break;
+            case 2: value = static_cast<std::int64_t>(random()); break;
+            case 3: value = -static_cast<std::int64_t>(random() % 70); break;
+            default: value = static_cast<std::int64_t>(random() % 70) + 1;
+        }
+    }
+    return values;
+}
+
+// Compares every row with the virtual machine; returns whether the expression evaluated.
+bool compare(const std::string& text, frontend::scanner::Isa isa, std::mt19937_64& random, std::size_t rows)
+{
+    auto tree = makeParser(text).parseExpression();
+    auto program = backend::Compiler::compile(*tree);
+    std::vector<std::vector<std::int64_t>> values;
+    std::vector<std::span<const std::int64_t>> columns;
+    for (std::size_t i = 0; i < program.inputs().size(); ++i) {
+        values.push_back(column(random, rows));
+    }
+    for (const auto& value : values) columns.emplace_back(value);
+
+    backend::VirtualMachine machine;
+    std::vector<backend::Value> expected;
+    bool machineThrew = false;
+    try {
+        std::vector<backend::Value> inputs(values.size());
+        for (std::size_t row = 0; row < rows; ++row) {
+            for (std::size_t i = 0; i < values.size(); ++i) inputs[i] = backend::Value(values[i][row]);
+            expected.push_back(machine.run(program, inputs));
+        }
+    } catch (std::exception&) {
+        machineThrew = true;
+    }
+
+    bool batchThrew = false;
+    std::vector<backend::Value> actual;
+    try {
+        backend::BatchEvaluator evaluator(*tree, isa);
+        if (evaluator.isPredicate()) {
+            std::vector<std::uint64_t> selection((rows + 63) / 64, ~std::uint64_t(0));
+            evaluator.select(columns, rows, selection);
+            for (std::size_t row = 0; row < rows; ++row) {
+                actual.emplace_back(static_cast<bool>(selection[row / 64] >> row % 64 & 1));
+            }
+            if (rows % 64 != 0) expect(selection.back() >> rows % 64 == 0, "bits past the last row");
+        } else {
+            std::vector<std::int64_t> result(rows);
+            evaluator.evaluate(columns, result);
+            for (auto value : result) actual.emplace_back(value);
+        }
+    } catch (std::exception&) {
+        batchThrew = true;
+    }
+
+    if (batchThrew != machineThrew) {
+        std::cerr << "Mismatch for \"" << text << "\": " << (batchThrew ? "threw" : "did not throw") << std::endl;
+        ++failures;
+    } else if (!batchThrew) {
+        for (std::size_t row = 0; row < rows; ++row) {
+            if (!(actual[row] == expected[row])) {
+                std::cerr << "Mismatch for \"" << text << "\" at row " << row << ": " << actual[row].toString()
+                          << " instead of " << expected[row].toString() << std::endl;
+                ++failures;
+                break;
+            }
+        }
+    }
+    return !machineThrew;
+}
+
+} // namespace
+
+int main()
+{
+    using frontend::scanner::Isa;
+    std::vector<Isa> isas{ Isa::Scalar };
+    if (frontend::scanner::detect() == Isa::AVX2) isas.push_back(Isa::AVX2);
+    std::mt19937 random(19);
+    std::mt19937_64 values(19);
+    int evaluated = 0;
+    try {
+        for (Isa isa : isas) {
+            for (int round = 0; round < 3000 && failures < 10; ++round) {
+                // Partial blocks, partial words and several blocks.
+                std::size_t rows = round % 10 == 0 ? 2 * backend::BatchEvaluator::blockRows + 67 : 1 + round % 200;
+                evaluated += compare(generate(random, 1 + random() % 4), isa, values, rows);
+            }
+            evaluated += compare("a * 2 + b >> 1 < c", isa, values, 5000);
+        }
+        // Nothing but arithmetic, shifts and comparisons of integers.
+        for (const char* text : { "a + \"x\"", "[a][0]", "a++", "f(a)", "o.n" }) {
+            auto tree = makeParser(text).parseExpression();
+            bool threw = false;
+            try {
+                backend::BatchEvaluator evaluator(*tree);
+            } catch (std::runtime_error&) {
+                threw = true;
+            }
+            expect(threw, std::string("rejects ") + text);
+        }
+    } catch (std::exception& exception) {
+        std::cerr << "Failed: " << exception.what() << std::endl;
+        ++failures;
+    }
+    if (failures > 0) {
+        return 1;
+    }
+    std::cout << "Batch evaluation matches the virtual machine (" << evaluated << " valid expressions)." << std::endl;
+    return 0;
+}
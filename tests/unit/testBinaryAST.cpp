@@ -0,0 +1,146 @@
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "BinaryAST.hpp"
+#include "FlatAST.hpp"
+#include "Parser.hpp"
+
+#include "TestSupport.hpp"
+
+// Writes trees to the binary format and reads them back, then damages the bytes
+// in every way and expects the validating reader to throw, never to crash.
+
+namespace {
+
+const char* const texts[] = {
+    "a",
+    "a.b[1](c, \"s\", [2, -3]) + -x++ * ~y << 4 != !z >>> -5 - -w",
+    "f()",
+    "[]",
+    "[[], [1], [1, 2]]",
+    "0x7fffffff * 123456789012345678901234567890 % name.name.name",
+    "--a <= ++b == a-- >= b++",
+    "\"a string\" < \"a string\" > \"\"",
+};
+
+// Loads data untrusted and reads every node, so that the sanitizers see any overread.
+bool loads(std::string_view data)
+{
+    try {
+        frontend::BinaryAST binary(data);
+        auto flat = binary.toFlat();
+        for (frontend::FlatAST::Index root = 0; root < flat.size(); root = flat.end(root)) {
+            flat.toTree(root);
+        }
+        return true;
+    } catch (std::runtime_error&) {
+        return false;
+    }
+}
+
+} // namespace
+
+int main()
+{
+    try {
+        // Round trip, one tree per file and all trees in one file.
+        frontend::BinaryASTWriter all;
+        std::vector<std::string> dumps;
+        for (const char* text : texts) {
+            auto tree = makeParser(text).parseExpression();
+            dumps.push_back(dump(*tree));
+            frontend::BinaryASTWriter single;
+            single.add(*tree);
+            all.add(*tree);
+            std::string data = single.finish();
+            frontend::BinaryAST binary(data);
+            expect(binary.treeCount() == 1, std::string("one tree: ") + text);
+            auto loaded = binary.toFlat().toTree();
+            expect(loaded && dump(*loaded) == dumps.back(), std::string("round trip: ") + text);
+        }
+        expect(all.treeCount() == std::size(texts), "trees added");
+        std::string data = all.finish();
+        expect(all.treeCount() == 0, "finish() starts over");
+        frontend::BinaryAST binary(data);
+        expect(binary.treeCount() == std::size(texts), "tree count");
+        auto flat = binary.toFlat();
+        std::size_t tree = 0;
+        for (frontend::FlatAST::Index root = 0; root < flat.size(); root = flat.end(root), ++tree) {
+            expect(tree < dumps.size() && dump(*flat.toTree(root)) == dumps[tree],
+                "forest tree " + std::to_string(tree));
+        }
+        expect(tree == std::size(texts), "forest roots");
+
+        // Strings are stored once and read in place.
+        bool found = false;
+        for (std::uint32_t i = 0; i < binary.stringCount(); ++i) {
+            found |= binary.string(i) == "a string";
+            expect(binary.string(i).data() >= data.data() && binary.string(i).data() <= data.data() + data.size(),
+                "strings in the buffer");
+        }
+        expect(found, "string table");
+        std::size_t names = 0;
+        for (std::uint32_t i = 0; i < binary.stringCount(); ++i) names += binary.string(i) == "name";
+        expect(names == 1, "strings stored once");
+
+        // The cursor decodes the same nodes, trusted or not.
+        frontend::BinaryAST trusted(data, frontend::BinaryAST::Trust::Trusted);
+        auto cursor = trusted.nodes();
+        for (frontend::FlatAST::Index node = 0; node < flat.size(); ++node) {
+            auto decoded = cursor.next();
+            if (decoded.type != flat.type(node) || decoded.from != flat.from(node) || decoded.to != flat.to(node)) {
+                expect(false, "cursor node " + std::to_string(node));
+                break;
+            }
+        }
+        expect(cursor.atEnd(), "cursor end");
+
+        // Deep trees need no recursion.
+        std::string deep(100000, '~');
+        deep += "a";
+        frontend::BinaryASTWriter deepWriter;
+        deepWriter.add(*makeParser(deep).parseExpressionIterative());
+        std::string deepData = deepWriter.finish();
+        expect(frontend::BinaryAST(deepData).toFlat().size() == 100001, "deep tree");
+
+        // Every truncation, every byte changed, and random damage, are rejected or harmless.
+        for (std::size_t size = 0; size < data.size(); ++size) {
+            expect(!loads(std::string_view(data).substr(0, size)), "truncated to " + std::to_string(size));
+        }
+        expect(!loads(data + '\0'), "trailing byte");
+        std::mt19937 random(23);
+        for (std::size_t i = 0; i < data.size(); ++i) {
+            for (int value : { 0x00, 0x7f, 0x80, 0xff, static_cast<int>(random() & 0xff) }) {
+                std::string damaged = data;
+                damaged[i] = static_cast<char>(value);
+                loads(damaged);
+            }
+        }
+        for (int i = 0; i < 20000; ++i) {
+            std::string damaged = data;
+            for (int j = 0; j < 4; ++j) {
+                damaged[random() % damaged.size()] = static_cast<char>(random());
+            }
+            loads(damaged);
+        }
+        std::string wrongVersion = data;
+        wrongVersion[4] = 2;
+        expect(!loads(wrongVersion), "version");
+        expect(loads(frontend::BinaryASTWriter().finish()), "no trees");
+    } catch (std::exception& exception) {
+        std::cerr << "Failed: " << exception.what() << std::endl;
+        ++failures;
+    }
+    if (failures > 0) {
+        return 1;
+    }
+    std::cout << "Binary trees load back the same, and damaged files are rejected." << std::endl;
+    return 0;
+}
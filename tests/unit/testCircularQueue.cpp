@@ -0,0 +1,105 @@
+#include <cstddef>
+#include <deque>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "CircularQueue.hpp"
+
+#include "TestSupport.hpp"
+
+// Compares both CircularQueue layouts with std::deque under random pushes, pops,
+// copies and moves. Strings make leaks and double destructions visible to sanitizers.
+
+// Small rings are stored inline, larger ones on the heap.
+static_assert(sizeof(frontend::CircularQueue<std::string, 3>) >= 4 * sizeof(std::string));
+static_assert(sizeof(frontend::CircularQueue<std::string, 64>) < 64);
+
+namespace {
+
+template <std::size_t n, typename Queue>
+void compare(const Queue& queue, const std::deque<std::string>& reference)
+{
+    expect(queue.size() == reference.size(), "size");
+    expect(queue.empty() == reference.empty(), "empty");
+    expect(queue.full() == (reference.size() == n), "full");
+    for (std::size_t i = 0; i < reference.size(); ++i) {
+        expect(queue[i] == reference[i], "element");
+    }
+    if (!reference.empty()) {
+        expect(queue.front() == reference.front(), "front");
+        expect(queue.back() == reference.back(), "back");
+    }
+}
+
+template <std::size_t n>
+void run(std::mt19937& random)
+{
+    using Queue = frontend::CircularQueue<std::string, n>;
+    Queue queue;
+    std::deque<std::string> reference;
+    for (int step = 0; step < 2000; ++step) {
+        switch (random() % 6) {
+            case 0:
+            case 1:
+                if (reference.size() < n) {
+                    std::string element = "element " + std::to_string(step);
+                    queue.push(element);
+                    reference.push_back(element);
+                }
+                break;
+            case 2:
+            case 3:
+                if (!reference.empty()) {
+                    queue.pop();
+                    reference.pop_front();
+                }
+                break;
+            case 4: {
+                Queue copy(queue);
+                compare<n>(copy, reference);
+                queue = copy;
+                break;
+            }
+            default: {
+                // The moved-from queue must be empty and usable.
+                Queue moved(std::move(queue));
+                compare<n>(queue, {});
+                queue.push("reused");
+                queue.pop();
+                queue = std::move(moved);
+                compare<n>(moved, {});
+                break;
+            }
+        }
+        compare<n>(queue, reference);
+    }
+    bool threw = false;
+    try {
+        queue.at(reference.size());
+    } catch (std::out_of_range&) {
+        threw = true;
+    }
+    expect(threw, "at() out of bounds");
+}
+
+} // namespace
+
+int main()
+{
+    std::mt19937 random(99);
+    // Inline storage.
+    run<1>(random);
+    run<2>(random);
+    run<3>(random);
+    // Heap storage.
+    run<12>(random);
+    run<64>(random);
+    if (failures > 0) {
+        return 1;
+    }
+    std::cout << "CircularQueue matches std::deque." << std::endl;
+    return 0;
+}
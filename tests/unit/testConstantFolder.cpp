@@ -0,0 +1,160 @@
+#include <cstddef>
+#include <exception>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Arena.hpp"
+#include "ConstantFolder.hpp"
+#include "ExpressionType.hpp"
+#include "FlatAST.hpp"
+#include "Parser.hpp"
+#include "TypeInference.hpp"
+#include "Visitor.hpp"
+
+#include "TestSupport.hpp"
+
+// Checks which subtrees the constant folder replaces and which it reports.
+
+namespace {
+
+// Literals as their value, other nodes as (Type children...).
+void print(std::ostream& os, const frontend::ASTNode& node)
+{
+    if (node.nodeType() == frontend::NodeType::NumericLiteral) {
+        os << static_cast<const frontend::NumericLiteral&>(node).literal().str();
+        return;
+    }
+    if (node.nodeType() == frontend::NodeType::StringLiteral) {
+        os << '"' << static_cast<const frontend::StringLiteral&>(node).literal().str() << '"';
+        return;
+    }
+    std::ostringstream dump;
+    node.dump(dump, 0);
+    std::string type = dump.str();
+    os << '(' << type.substr(0, type.find('\n'));
+    frontend::forEachChild(node, [&](const frontend::Expression& child) {
+        os << ' ';
+        print(os, child);
+    });
+    os << ')';
+}
+
+void expectFolded(std::string_view text, std::string_view expected, std::vector<std::string> diagnostics = {})
+{
+    try {
+        auto tree = makeParser(text).parseExpression();
+        frontend::ConstantFolder folder;
+        folder.fold(tree);
+        std::ostringstream printed;
+        print(printed, *tree);
+        std::vector<std::string> reported;
+        for (const auto& diagnostic : folder.diagnostics()) {
+            reported.push_back(std::string(text.substr(diagnostic.from, diagnostic.to - diagnostic.from)) + ": " +
+                diagnostic.message);
+        }
+        if (printed.str() != expected || reported != diagnostics) {
+            std::cerr << "Folded \"" << text << "\" into " << printed.str() << std::endl;
+            for (const auto& line : reported) std::cerr << "  " << line << std::endl;
+            ++failures;
+        }
+        if (tree->from() != text.find_first_not_of(' ') || tree->to() != text.find_last_not_of(' ') + 1) {
+            std::cerr << "Wrong range after folding \"" << text << '"' << std::endl;
+            ++failures;
+        }
+    } catch (std::exception& exception) {
+        std::cerr << "Failed on \"" << text << "\": " << exception.what() << std::endl;
+        ++failures;
+    }
+}
+
+} // namespace
+
+int main()
+{
+    expectFolded("1 + 2 / 1", "3");
+    expectFolded("\"Hello\" + \" \" + \"World!\"", "\"Hello World!\"");
+    expectFolded("[0xff / 0x00] >>> []", "(ShiftRightLogic (ArrayLiteral (Division 0xff 0x00)) (ArrayLiteral))",
+        { "0xff / 0x00: Division by zero." });
+    // Comparisons keep their folded operands.
+    expectFolded("2 + 3 >>> 1 == 1 < 4", "(Equals 2 (LessThan 1 4))");
+    expectFolded("f(2 * 3, a + 1 * 2)[0b101 - 5]", "(SubscriptAccess (FunctionCall (Identifier) 6 (Addition (Identifier) 2)) 0)");
+    // Negative results are negated literals, which fold on like literals.
+    expectFolded("-7 / 2 + -7 % 2", "(Negative 4)");
+    expectFolded("~0 - -4611686018427387904 * 1", "4611686018427387903");
+    expectFolded("-1 >> 63 == -1 >>> 1", "(Equals (Negative 1) 9223372036854775807)");
+    expectFolded("-1 >>> 0", "(ShiftRightLogic (Negative 1) 0)", { "-1 >>> 0: Integer overflow." });
+    expectFolded("[1 - 2, 0 - 5 + x, 1 - 2 - 3]", "(ArrayLiteral (Negative 1) (Addition (Negative 5) (Identifier)) (Negative 4))");
+    expectFolded("-~4 + +-3", "2");
+    expectFolded("-9223372036854775807 - 1 - 0", "(Negative 9223372036854775808)");
+    expectFolded("-9223372036854775808 - 1", "(Subtraction (Negative 9223372036854775808) 1)",
+        { "-9223372036854775808 - 1: Integer overflow." });
+    expectFolded("9223372036854775807 + 1", "(Addition 9223372036854775807 1)", { "9223372036854775807 + 1: Integer overflow." });
+    expectFolded("1 << 63", "(ShiftLeft 1 63)", { "1 << 63: Integer overflow." });
+    expectFolded("1 << 64 + 0", "(ShiftLeft 1 64)", { "1 << 64 + 0: Shift count out of range." });
+    expectFolded("0xffffffffffffffff * 1", "(Multiplication 0xffffffffffffffff 1)",
+        { "0xffffffffffffffff: Integer literal does not fit in 64 bits." });
+    // Only strings concatenate, and only with each other.
+    expectFolded("\"a\" + 1 - \"b\" * \"c\"", "(Subtraction (Addition \"a\" 1) (Multiplication \"b\" \"c\"))");
+    expectFolded("!0 + a.b + ++c", "(Addition (Addition (LogicalNegation 0) (MemberAccess (Identifier) (Identifier))) (PreIncrement (Identifier)))");
+    // Folded trees read like parsed ones: type inference takes the negative constants.
+    try {
+        auto tree = makeParser("[1 - 2, 0 - 5 + x, 3]").parseExpression();
+        frontend::ConstantFolder folder;
+        folder.fold(tree);
+        auto flat = frontend::FlatAST::fromTree(*tree);
+        frontend::TypeInference inference({ { "x", &frontend::ExpressionType::basic(frontend::BasicExpressionType::Int8) } });
+        inference.infer(flat);
+        for (const auto& diagnostic : inference.diagnostics()) {
+            std::cerr << "Type inference after folding: " << diagnostic.message << std::endl;
+            ++failures;
+        }
+        if (inference.type(0) == nullptr || inference.type(0)->toString() != "int16[]") {
+            std::cerr << "Folded array typed " << (inference.type(0) ? inference.type(0)->toString() : "nothing") << std::endl;
+            ++failures;
+        }
+    } catch (std::exception& exception) {
+        std::cerr << "Folded tree failed: " << exception.what() << std::endl;
+        ++failures;
+    }
+    // Literals of arena trees go to the same arena.
+    try {
+        frontend::Arena arena;
+        auto tree = makeParser("[1 + 2, \"x\" + \"y\"]").parseExpressionInto(&arena);
+        frontend::ConstantFolder folder(&arena);
+        auto removed = folder.fold(tree);
+        std::ostringstream printed;
+        print(printed, *tree);
+        if (removed != 4 || printed.str() != "(ArrayLiteral 3 \"xy\")") {
+            std::cerr << "Arena tree folded into " << printed.str() << std::endl;
+            ++failures;
+        }
+    } catch (std::exception& exception) {
+        std::cerr << "Arena tree failed: " << exception.what() << std::endl;
+        ++failures;
+    }
+    // Deeper than the call stack allows.
+    constexpr std::size_t depth = 200000;
+    try {
+        std::string deep(depth, '~');
+        deep += "5";
+        auto tree = makeParser(deep).parseExpressionIterative();
+        frontend::ConstantFolder folder;
+        auto removed = folder.fold(tree);
+        if (removed != depth || tree->nodeType() != frontend::NodeType::NumericLiteral ||
+            static_cast<const frontend::NumericLiteral&>(*tree).literal().str() != "5") {
+            std::cerr << "Deep input folded " << removed << " nodes." << std::endl;
+            ++failures;
+        }
+    } catch (std::exception& exception) {
+        std::cerr << "Deep input failed: " << exception.what() << std::endl;
+        ++failures;
+    }
+    if (failures > 0) {
+        return 1;
+    }
+    std::cout << "Constant subtrees are folded, errors are reported and kept." << std::endl;
+    return 0;
+}
@@ -0,0 +1,148 @@
+#include <cstddef>
+#include <exception>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Emitter.hpp"
+#include "NodeFactory.hpp"
+#include "Parser.hpp"
+
+#include "TestSupport.hpp"
+
+// Compares the output of the emitters with the expected text in both formats,
+// checks the blocks handed to a sink and a large tree, and pins the text of dump().
+
+namespace {
+
+using Format = frontend::Emitter::Format;
+
+std::string emit(std::string_view text, frontend::Emitter::Options options)
+{
+    frontend::OutputBuffer out;
+    frontend::Emitter emitter(out, options);
+    emitter.emit(*makeParser(text).parseExpression());
+    return std::string(out.view());
+}
+
+void expectEmitted(std::string_view text, frontend::Emitter::Options options, std::string_view expected)
+{
+    try {
+        std::string actual = emit(text, options);
+        expect(actual == expected, "\"" + std::string(text) + "\" emitted as\n" + actual + "instead of\n"
+            + std::string(expected));
+    } catch (std::exception& exception) {
+        expect(false, "\"" + std::string(text) + "\": " + exception.what());
+    }
+}
+
+} // namespace
+
+int main()
+{
+    constexpr frontend::Emitter::Options sexpr{ .format = Format::SExpression };
+    constexpr frontend::Emitter::Options json{ .format = Format::Json };
+    expectEmitted("a", sexpr, "a\n");
+    expectEmitted("\"text\"", sexpr, "\"text\"\n");
+    expectEmitted("a.b + f(1, \"s\")", sexpr, "(Addition (MemberAccess a b) (FunctionCall f 1 \"s\"))\n");
+    expectEmitted("[[], [1]] - -x++ * xs[0x1f]", sexpr,
+        "(Subtraction (ArrayLiteral (ArrayLiteral) (ArrayLiteral 1)) "
+        "(Multiplication (Negative (PostIncrement x)) (SubscriptAccess xs 0x1f)))\n");
+    expectEmitted("a >>> 1 != !b", { .format = Format::SExpression, .indent = 2 },
+        "(NotEquals\n"
+        "  (ShiftRightLogic\n"
+        "    a\n"
+        "    1)\n"
+        "  (LogicalNegation\n"
+        "    b))\n");
+    expectEmitted("a", json, "{\"type\":\"Identifier\",\"from\":0,\"to\":1,\"value\":\"a\"}\n");
+    expectEmitted("f() + [x]", json,
+        "{\"type\":\"Addition\",\"from\":0,\"to\":9,\"children\":["
+        "{\"type\":\"FunctionCall\",\"from\":0,\"to\":3,\"children\":["
+        "{\"type\":\"Identifier\",\"from\":0,\"to\":1,\"value\":\"f\"}]},"
+        "{\"type\":\"ArrayLiteral\",\"from\":6,\"to\":9,\"children\":["
+        "{\"type\":\"Identifier\",\"from\":7,\"to\":8,\"value\":\"x\"}]}]}\n");
+    expectEmitted("[]", json, "{\"type\":\"ArrayLiteral\",\"from\":0,\"to\":2,\"children\":[]}\n");
+    expectEmitted("-a", { .format = Format::Json, .indent = 1 },
+        "{\"type\":\"Negative\",\"from\":0,\"to\":2,\"children\":[\n"
+        " {\"type\":\"Identifier\",\"from\":1,\"to\":2,\"value\":\"a\"}]}\n");
+
+    try {
+        // Strings built by hand may hold anything, they are escaped.
+        frontend::OutputBuffer out;
+        frontend::Emitter emitter(out, json);
+        auto literal = frontend::NodeFactory().make<frontend::StringLiteral>(std::string("q\"b\\n\nt\t\x01"), 0, 1);
+        emitter.emit(*literal);
+        expect(out.view() == "{\"type\":\"StringLiteral\",\"from\":0,\"to\":1,\"value\":\"q\\\"b\\\\n\\nt\\t\\u0001\"}\n",
+            "escapes: " + std::string(out.view()));
+
+        // A sink gets blocks of at least the block size, then the rest on flush().
+        std::string deep(300000, '~');
+        deep += "a";
+        auto deepTree = makeParser(deep).parseExpressionIterative();
+        std::vector<std::size_t> blocks;
+        std::string sunk;
+        {
+            frontend::OutputBuffer sinkOut([&](std::string_view block) {
+                blocks.push_back(block.size());
+                sunk += block;
+            }, 4096);
+            frontend::Emitter sinkEmitter(sinkOut, sexpr);
+            sinkEmitter.emit(*deepTree);
+            sinkOut.flush();
+            expect(sinkOut.view().empty(), "flushed");
+        }
+        bool large = blocks.size() > 1;
+        for (std::size_t i = 0; i + 1 < blocks.size(); ++i) large &= blocks[i] >= 4096;
+        expect(large, "blocks of the block size");
+        expect(sunk.size() == 300000 * std::string_view("(BitwiseNot )").size() + 2, "deep tree");
+        expect(sunk.starts_with("(BitwiseNot (BitwiseNot ") && sunk.ends_with(" a" + std::string(300000, ')') + "\n"), "deep tree text");
+
+        // A large and shallow tree, in both formats.
+        std::string wide = "[a";
+        for (int i = 0; i < 100000; ++i) wide += ", a + f(x, \"s\") * [1, 2][i]";
+        wide += "]";
+        auto tree = makeParser(wide).parseExpressionIterative();
+        auto emitted = [&](frontend::Emitter::Options options) {
+            std::size_t size = 0;
+            frontend::OutputBuffer sized([&](std::string_view block) { size += block.size(); });
+            frontend::Emitter(sized, options).emit(*tree);
+            sized.flush();
+            return size;
+        };
+        std::size_t sexprSize = emitted(sexpr);
+        std::size_t jsonSize = emitted(json);
+        expect(sexprSize > 0 && jsonSize > sexprSize, "sizes of the large tree");
+
+        // dump() stays as it was, the text tests compare with.
+        std::ostringstream dumped;
+        makeParser("f(a, 2)[-i]").parseExpression()->dump(dumped, 0);
+        expect(dumped.str() ==
+                "SubscriptAccess\n"
+                " Argument\n"
+                "  FunctionCall\n"
+                "   Function\n"
+                "    Identifier\n"
+                "    Value: f\n"
+                "   Arguments\n"
+                "    Identifier\n"
+                "    Value: a\n"
+                "    NumericLiteral\n"
+                "    Value: 2\n"
+                " Subscript\n"
+                "  Negative\n"
+                "   Identifier\n"
+                "   Value: i\n",
+            "dump():\n" + dumped.str());
+    } catch (std::exception& exception) {
+        std::cerr << "Failed: " << exception.what() << std::endl;
+        ++failures;
+    }
+    if (failures > 0) {
+        return 1;
+    }
+    std::cout << "The emitters write the expected S-expressions and JSON, dump() its usual text." << std::endl;
+    return 0;
+}
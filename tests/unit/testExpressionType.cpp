@@ -0,0 +1,81 @@
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "ExpressionType.hpp"
+
+#include "TestSupport.hpp"
+
+// Checks that every distinct type has one instance, also when many threads
+// build the same nested array types at once.
+
+namespace {
+
+using frontend::BasicExpressionType;
+using frontend::ExpressionType;
+
+} // namespace
+
+int main()
+{
+    const ExpressionType& int32 = ExpressionType::basic(BasicExpressionType::Int32);
+    const ExpressionType& uint32 = ExpressionType::basic(BasicExpressionType::Uint32);
+    expect(&int32 == &ExpressionType::basic(BasicExpressionType::Int32), "basic types are unique");
+    expect(int32 != uint32, "distinct basic types");
+    expect(int32.elementType() == nullptr && int32.depth() == 0 && !int32.isArray(), "basic type");
+
+    const ExpressionType& matrix = ExpressionType::arrayOf(ExpressionType::arrayOf(int32));
+    expect(matrix == ExpressionType::arrayOf(int32, 2), "nested arrays are unique");
+    expect(matrix != ExpressionType::arrayOf(uint32, 2), "arrays of distinct types");
+    expect(matrix != ExpressionType::arrayOf(int32, 3), "arrays of distinct depths");
+    expect(matrix.isArray() && matrix.depth() == 2 && *matrix.elementType() == ExpressionType::arrayOf(int32),
+        "array type");
+    expect(std::hash<ExpressionType>{}(matrix) == std::hash<ExpressionType>{}(ExpressionType::arrayOf(int32, 2)),
+        "hash");
+    expect(matrix.toString() == "int32[][]", "toString of an array");
+    expect(ExpressionType::basic(BasicExpressionType::Uint256).toString() == "uint256", "toString of uint256");
+    expect(ExpressionType::basic(BasicExpressionType::Bool).toString() == "bool", "toString of bool");
+
+    bool threw = false;
+    try {
+        ExpressionType::basic(BasicExpressionType::Array);
+    } catch (std::logic_error&) {
+        threw = true;
+    }
+    expect(threw, "basic(Array) throws");
+
+    // Repeated types take no memory, deep ones no recursion.
+    std::size_t arrays = ExpressionType::arrayTypeCount();
+    for (int i = 0; i < 1000; ++i) ExpressionType::arrayOf(int32, 2);
+    expect(ExpressionType::arrayTypeCount() == arrays, "no new types for repeated arrays");
+    const ExpressionType& deep = ExpressionType::arrayOf(uint32, 100000);
+    expect(deep.depth() == 100000 && deep == ExpressionType::arrayOf(uint32, 100000), "deep arrays");
+
+    // Threads racing to create the same types all get the same instances.
+    const ExpressionType& text = ExpressionType::basic(BasicExpressionType::String);
+    arrays = ExpressionType::arrayTypeCount();
+    std::vector<std::vector<const ExpressionType*>> seen(8);
+    std::vector<std::thread> threads;
+    for (auto& types : seen) {
+        threads.emplace_back([&text, &types] {
+            for (std::uint32_t depth = 1; depth <= 500; ++depth) {
+                types.push_back(&ExpressionType::arrayOf(text, depth));
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    for (const auto& types : seen) expect(types == seen.front(), "threads see the same types");
+    expect(std::unordered_set<const ExpressionType*>(seen[0].begin(), seen[0].end()).size() == 500, "distinct depths");
+    expect(ExpressionType::arrayTypeCount() == arrays + 500, "one instance per type");
+
+    if (failures > 0) {
+        return 1;
+    }
+    std::cout << "Types are interned (" << ExpressionType::arrayTypeCount() << " array types)." << std::endl;
+    return 0;
+}
@@ -0,0 +1,171 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "FlatAST.hpp"
+#include "IncrementalParser.hpp"
+#include "Parser.hpp"
+#include "TokenStream.hpp"
+
+#include "TestSupport.hpp"
+
+// Applies random edits to random expressions and checks that reparse() gives the
+// tokens and the tree of parsing the new text from scratch, or the same error. The
+// tree is looked at after some of the edits only, so that shifts pile up in between.
+
+namespace {
+
+bool same(const frontend::TokenGapBuffer& lhs, const frontend::TokenStream& rhs)
+{
+    if (lhs.size() != rhs.size()) return false;
+    for (frontend::TokenStream::Index token = 0; token < rhs.size(); ++token) {
+        if (lhs.type(token) != rhs.type(token) || lhs.from(token) != rhs.from(token) || lhs.to(token) != rhs.to(token)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Like reparse(), tokens left over are an error.
+frontend::NodePtr<frontend::Expression> parse(const frontend::TokenStream& tokens)
+{
+    frontend::Parser<frontend::TokenCursor> parser{ frontend::TokenCursor(tokens) };
+    return parser.parseExpressionInto({});
+}
+
+std::string generate(std::mt19937& random)
+{
+    static const char* const elements[] = {
+        "a", "12", "\"s\"", "b.c", "d[1 + e]", "f++", "g()", "h(i, [j, k])", "-l * m", "[]", "n(o)(p, q)", "r /* c */"
+    };
+    std::string text = "[";
+    for (auto count = 1 + random() % 12; count > 0; --count) {
+        text += elements[random() % (sizeof(elements) / sizeof(elements[0]))];
+        if (count > 1) text += random() % 3 ? ", " : ",\n";
+    }
+    return text + "]";
+}
+
+// Sorted disjoint edits of text, applied to it.
+std::vector<frontend::TextEdit> edit(std::mt19937& random, std::string& text)
+{
+    static const char* const insertions[] = {
+        "", "a", "1", "+", ",", "[", "]", "(", ")", " ", "\n", "/*c*/", "\"s\"", "x.y", "-", "f(", "b", "++", "//c\n", "\""
+    };
+    std::vector<std::uint32_t> positions;
+    for (auto count = 1 + random() % 3; count > 0; --count) {
+        positions.push_back(static_cast<std::uint32_t>(random() % (text.size() + 1)));
+    }
+    std::ranges::sort(positions);
+    std::vector<frontend::TextEdit> edits;
+    std::vector<std::string> inserted;
+    for (auto position : positions) {
+        if (!edits.empty() && position <= edits.back().to) continue;
+        auto to = std::min<std::uint32_t>(position + random() % 4, static_cast<std::uint32_t>(text.size()));
+        inserted.emplace_back(insertions[random() % (sizeof(insertions) / sizeof(insertions[0]))]);
+        edits.push_back({ position, to, static_cast<std::uint32_t>(inserted.back().size()) });
+    }
+    // Applied from the last one, so that the offsets stay valid.
+    for (std::size_t i = edits.size(); i-- > 0;) {
+        text.replace(edits[i].from, edits[i].to - edits[i].from, inserted[i]);
+    }
+    return edits;
+}
+
+} // namespace
+
+int main()
+{
+    std::mt19937 random(5);
+    int reparsed = 0;
+    int local = 0;
+    for (int round = 0; round < 2000 && failures < 10; ++round) {
+        // Every text stays alive while a stream refers to it.
+        std::deque<std::string> texts{ generate(random) };
+        frontend::IncrementalParser parser(texts.back());
+        for (int step = 0; step < 5; ++step) {
+            std::string text = texts.back();
+            auto edits = edit(random, text);
+            texts.push_back(std::move(text));
+            std::string_view next = texts.back();
+            bool look = random() % 2 == 0;
+            frontend::FlatAST before;
+            if (look) before = frontend::FlatAST::fromTree(parser.tree());
+            std::string expectedError;
+            frontend::NodePtr<frontend::Expression> expected;
+            try {
+                auto fresh = frontend::TokenStream::tokenize(next);
+                expected = parse(fresh);
+                auto result = parser.reparse(next, edits);
+                expect(same(parser.tokens(), fresh), "tokens match a full tokenization");
+                if (look) {
+                    expect(frontend::FlatAST::fromTree(parser.tree()) == frontend::FlatAST::fromTree(*expected),
+                        "tree matches a full parse");
+                }
+                local += result.reparsedTokens < fresh.size() - 1;
+                ++reparsed;
+            } catch (std::exception& exception) {
+                expectedError = exception.what();
+            }
+            if (!expectedError.empty()) {
+                // Same error, tree and tokens untouched: go on from the old text.
+                std::string error;
+                try {
+                    parser.reparse(next, edits);
+                } catch (std::exception& exception) {
+                    error = exception.what();
+                }
+                expect(error == expectedError, "same error as a full parse");
+                texts.pop_back();
+                expect(same(parser.tokens(), frontend::TokenStream::tokenize(std::string_view(texts.back()))),
+                    "tokens untouched by an error");
+                if (look) expect(frontend::FlatAST::fromTree(parser.tree()) == before, "tree untouched by an error");
+            }
+            if (failures > 0) {
+                std::cerr << "After editing into: \"" << next << '"' << std::endl;
+                break;
+            }
+        }
+    }
+
+    // An edit in one element of a large array costs that element only, and shifts
+    // left pending by the edits before it are applied once.
+    std::string large = "[";
+    for (int i = 0; i < 5000; ++i) large += "a + " + std::to_string(i) + ", ";
+    large += "b]";
+    frontend::IncrementalParser parser(large);
+    std::deque<std::string> texts{ large };
+    for (int i = 0; i < 10; ++i) {
+        std::string edited = texts.back();
+        auto position = static_cast<std::uint32_t>(edited.find(',', edited.size() * (i + 1) / 12));
+        edited.insert(position, " * c");
+        texts.push_back(std::move(edited));
+        frontend::TextEdit insertion{ position, position, 4 };
+        auto result = parser.reparse(texts.back(), { &insertion, 1 });
+        expect(result.relexedTokens <= 3 && result.reparsedTokens <= 5, "an edit only parses its element");
+    }
+    frontend::TextEdit trailing{ static_cast<std::uint32_t>(texts.back().size()), static_cast<std::uint32_t>(texts.back().size()), 2 };
+    texts.push_back(texts.back() + " x");
+    try {
+        parser.reparse(texts.back(), { &trailing, 1 });
+        expect(false, "tokens after the expression are an error");
+    } catch (std::exception&) {
+    }
+    texts.pop_back();
+    auto tokens = frontend::TokenStream::tokenize(std::string_view(texts.back()));
+    expect(same(parser.tokens(), tokens), "large tokens match");
+    expect(frontend::FlatAST::fromTree(parser.tree()) == frontend::FlatAST::fromTree(*parse(tokens)), "large tree matches");
+    if (failures > 0) {
+        return 1;
+    }
+    std::cout << "Incremental parsing matches full parsing (" << reparsed << " valid edits, " << local
+              << " parsed locally)." << std::endl;
+    return 0;
+}
@@ -39,7 +39,7 @@ int main(int argc, char* argv[])
         while (lexer.peek().type != frontend::TokenType::EndOfFile) {
             auto& token = lexer.peek();
             std::cout << "Token type: " << tokenTypeToString(token.type) << std::endl;
-            std::cout << "Lexeme: " << token.lexeme.str() << std::endl;
+            std::cout << "Lexeme: " << lexer.lexeme(token) << std::endl;
             std::cout << "From: " << token.from << std::endl;
             std::cout << "To: " << token.to << std::endl;
             std::cout << std::endl;
@@ -0,0 +1,312 @@
+#include <cctype>
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Lexer.hpp"
+#include "Source.hpp"
+#include "TokenStream.hpp"
+
+// Compares the table-driven Lexer with the original switch-based lexer on random inputs.
+
+namespace {
+
+struct Lexed {
+    frontend::TokenType type;
+    std::size_t from;
+    std::size_t to;
+    std::string lexeme;
+    bool startsLine = false;
+
+    bool operator==(const Lexed&) const = default;
+};
+
+struct Result {
+    std::vector<Lexed> tokens;
+    bool failed = false;
+};
+
+// The original lexer, kept as the reference implementation.
+class ReferenceLexer {
+public:
+    explicit ReferenceLexer(const std::string& text) : m_text(text), m_index(0) {}
+
+    Result run()
+    {
+        Result result;
+        try {
+            std::size_t previousTo = 0;
+            while (true) {
+                Lexed token = next();
+                token.startsLine = m_text.find('\n', previousTo) < token.from;
+                previousTo = token.to;
+                result.tokens.push_back(token);
+                if (token.type == frontend::TokenType::EndOfFile) break;
+            }
+        } catch (std::exception&) {
+            result.failed = true;
+        }
+        return result;
+    }
+
+private:
+    using TokenType = frontend::TokenType;
+
+    char peekChar() const { return m_index < m_text.size() ? m_text[m_index] : EOF; }
+    void skipChar() { ++m_index; }
+
+    Lexed make(TokenType type, std::size_t from, std::string lexeme = {})
+    {
+        if (lexeme.empty()) lexeme = std::string(frontend::tokenSpelling(type));
+        return { type, from, m_index, std::move(lexeme) };
+    }
+
+    // Returns a slash token if one has been found.
+    bool skipWhitespace(Lexed& slash)
+    {
+        while (isspace(peekChar())) skipChar();
+        if (peekChar() == '/') {
+            skipChar();
+            if (peekChar() == '/') {
+                do {
+                    skipChar();
+                } while (peekChar() != '\n' && peekChar() != EOF);
+                return skipWhitespace(slash);
+            } else if (peekChar() == '*') {
+                skipChar();
+                bool terminated = false;
+                while (peekChar() != EOF) {
+                    if (peekChar() == '*') {
+                        skipChar();
+                        if (peekChar() == '/') {
+                            skipChar();
+                            terminated = true;
+                            break;
+                        }
+                    } else {
+                        skipChar();
+                    }
+                }
+                if (!terminated) throw std::range_error("Unterminated multiline comment.");
+                return skipWhitespace(slash);
+            } else {
+                slash = { TokenType::Slash, m_index - 1, m_index, "/" };
+                return true;
+            }
+        }
+        return false;
+    }
+
+    Lexed next()
+    {
+        Lexed slash;
+        if (skipWhitespace(slash)) return slash;
+        std::size_t from = m_index;
+        if (peekChar() == EOF) return make(TokenType::EndOfFile, from);
+        auto single = [&](TokenType type) { skipChar(); return make(type, from); };
+        auto pair = [&](char second, TokenType matched, TokenType otherwise) {
+            skipChar();
+            if (peekChar() == second) {
+                skipChar();
+                return make(matched, from);
+            }
+            return make(otherwise, from);
+        };
+        switch (peekChar()) {
+            case '[': return single(TokenType::OpenBracket);
+            case ']': return single(TokenType::CloseBracket);
+            case '(': return single(TokenType::OpenParenthesis);
+            case ')': return single(TokenType::CloseParenthesis);
+            case '.': return single(TokenType::Dot);
+            case ',': return single(TokenType::Comma);
+            case '*': return single(TokenType::Star);
+            case '/': return single(TokenType::Slash);
+            case '%': return single(TokenType::Percent);
+            case ';': return single(TokenType::Semicolon);
+            case '~': return single(TokenType::Tilde);
+            case '+': return pair('+', TokenType::Increment, TokenType::Plus);
+            case '-': return pair('-', TokenType::Decrement, TokenType::Minus);
+            case '!': return pair('=', TokenType::ExclamationEquals, TokenType::Exclamation);
+            case '=': return pair('=', TokenType::DoubleEquals, TokenType::Equals);
+            case '<': {
+                skipChar();
+                if (peekChar() == '<') {
+                    skipChar();
+                    return make(TokenType::DoubleLessThan, from);
+                } else if (peekChar() == '=') {
+                    skipChar();
+                    return make(TokenType::LessEquals, from);
+                }
+                return make(TokenType::LessThan, from);
+            }
+            case '>': {
+                skipChar();
+                if (peekChar() == '>') {
+                    skipChar();
+                    if (peekChar() == '>') {
+                        skipChar();
+                        return make(TokenType::TripleGreaterThan, from);
+                    }
+                    return make(TokenType::DoubleGreaterThan, from);
+                } else if (peekChar() == '=') {
+                    skipChar();
+                    return make(TokenType::GreaterEquals, from);
+                }
+                return make(TokenType::GreaterThan, from);
+            }
+            case '"': {
+                std::string literal = getStringLiteral();
+                return { TokenType::StringLiteral, from, m_index, literal };
+            }
+            default: {
+                if (isdigit(peekChar())) {
+                    std::string literal = getNumericLiteral();
+                    return { TokenType::NumericLiteral, from, m_index, literal };
+                } else if (isalpha(peekChar()) || peekChar() == '_') {
+                    std::string identifier;
+                    while (isalnum(peekChar()) || peekChar() == '_') {
+                        identifier.push_back(peekChar());
+                        skipChar();
+                    }
+                    return { TokenType::Identifier, from, m_index, identifier };
+                }
+                throw std::logic_error("Unrecognized token.");
+            }
+        }
+    }
+
+    std::string getNumericLiteral()
+    {
+        std::string literal;
+        auto take = [&] { literal.push_back(peekChar()); skipChar(); };
+        if (peekChar() == '0') {
+            take();
+            if (peekChar() == 'b') {
+                take();
+                while (peekChar() == '0' || peekChar() == '1') take();
+                if (literal.size() == 2) throw std::range_error("Binary prefix without a number.");
+            } else if (peekChar() == 'o') {
+                take();
+                while (peekChar() >= '0' && peekChar() <= '7') take();
+                if (literal.size() == 2) throw std::range_error("Octal prefix without a number.");
+            } else if (peekChar() == 'x') {
+                take();
+                while (isdigit(peekChar()) || (toupper(peekChar()) >= 'A' && toupper(peekChar()) <= 'F')) take();
+                if (literal.size() == 2) throw std::range_error("Hexadecimal prefix without a number.");
+            } else if (isdigit(peekChar())) {
+                throw std::range_error("Decimal numbers cannot start with 0.");
+            }
+        } else {
+            do {
+                take();
+            } while (isdigit(peekChar()));
+        }
+        return literal;
+    }
+
+    std::string getStringLiteral()
+    {
+        std::string literal;
+        skipChar();
+        while (peekChar() != '"' && peekChar() != '\n' && peekChar() != EOF) {
+            literal.push_back(peekChar());
+            skipChar();
+        }
+        if (peekChar() != '"') throw std::range_error("Unterminated string literal.");
+        skipChar();
+        return literal;
+    }
+
+    const std::string& m_text;
+    std::size_t m_index;
+};
+
+template <typename Source>
+Result lex(Source&& source)
+{
+    Result result;
+    try {
+        frontend::Lexer<1, Source> lexer(std::move(source));
+        while (true) {
+            const auto& token = lexer.peek();
+            result.tokens.push_back({ token.type, token.from, token.to, std::string(lexer.lexeme(token)), token.startsLine });
+            if (token.type == frontend::TokenType::EndOfFile) break;
+            lexer.skip();
+        }
+    } catch (std::exception&) {
+        result.failed = true;
+    }
+    return result;
+}
+
+Result tokenize(const std::string& text)
+{
+    Result result;
+    try {
+        auto stream = frontend::TokenStream::tokenize(std::string_view(text));
+        for (frontend::TokenStream::Index i = 0; i < stream.size(); ++i) {
+            auto token = stream.token(i);
+            result.tokens.push_back({ token.type, token.from, token.to, std::string(stream.lexeme(token)), token.startsLine });
+        }
+    } catch (std::exception&) {
+        result.failed = true;
+    }
+    return result;
+}
+
+std::string generate(std::mt19937& random)
+{
+    static const char* const pieces[] = {
+        "+", "-", "*", "/", "%", "!", "~", "<", ">", "=", "[", "]", "(", ")", ".", ",", ";",
+        " ", " ", "\n", "\t", "x", "_y1", "Abc", "fF", "0", "7", "42", "0x", "0xaF9", "0b", "0b102", "0o78", "09",
+        "\"str\"", "\"", "// line\n", "/* block */", "/*", "*/", "@", "#"
+    };
+    std::string text;
+    for (auto count = random() % 24; count > 0; --count) {
+        text += pieces[random() % (sizeof(pieces) / sizeof(pieces[0]))];
+    }
+    return text;
+}
+
+} // namespace
+
+int main()
+{
+    std::mt19937 random(1234);
+    std::string path = "testLexerDifferential.input.js";
+    int failures = 0;
+    for (int round = 0; round < 5000 && failures < 10; ++round) {
+        std::string text = generate(random);
+        {
+            std::ofstream output(path, std::ios::binary);
+            output << text;
+        }
+        Result expected = ReferenceLexer(text).run();
+        Result buffered = lex(frontend::BufferSource(text));
+        Result streamed = lex(frontend::StreamSource(std::ifstream(path, std::ios::binary)));
+        for (const Result* actual : { &buffered, &streamed }) {
+            if (actual->failed != expected.failed || actual->tokens != expected.tokens) {
+                std::cerr << "Mismatch for input: \"" << text << '"' << std::endl;
+                ++failures;
+            }
+        }
+        // A batch either yields every token or none.
+        Result batched = tokenize(text);
+        if (batched.failed != expected.failed || (!expected.failed && batched.tokens != expected.tokens)) {
+            std::cerr << "Batch mismatch for input: \"" << text << '"' << std::endl;
+            ++failures;
+        }
+    }
+    std::remove(path.c_str());
+    if (failures > 0) {
+        return 1;
+    }
+    std::cout << "Lexer matches the reference lexer on all inputs." << std::endl;
+    return 0;
+}
@@ -0,0 +1,105 @@
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "BracketIndex.hpp"
+#include "FlatAST.hpp"
+#include "ParallelParser.hpp"
+#include "Parser.hpp"
+#include "ThreadPool.hpp"
+#include "TokenStream.hpp"
+
+#include "TestSupport.hpp"
+
+// Checks that ParallelParser builds the same trees and reports the same errors as
+// the sequential parser, and the bracket pre-pass and thread pool it relies on.
+
+namespace {
+
+int parsed = 0;
+
+void compare(const frontend::ParallelParser& parallel, const std::string& text)
+{
+    auto tokens = frontend::TokenStream::tokenize(std::string_view(text));
+    ParseOutcome sequential = outcomeOf([&] {
+        frontend::Parser<frontend::TokenCursor> parser{ frontend::TokenCursor(tokens) };
+        return frontend::FlatAST::fromTree(parser.parseExpressionInArena().root());
+    });
+    ParseOutcome chunked = outcomeOf([&] { return frontend::FlatAST::fromTree(parallel.parse(tokens).root()); });
+    if (sequential != chunked) {
+        std::cerr << "Mismatch for input: \"" << text << '"' << std::endl;
+        ++failures;
+    }
+    parsed += sequential.error.empty();
+}
+
+// A list of random elements, mostly valid, sometimes with stray tokens.
+std::string generate(std::mt19937& random, std::string_view open, std::string_view close)
+{
+    static const char* const elements[] = {
+        "a", "1", "\"s\"", "b.c", "d[1]", "e++", "f()", "g(h, [i, j])", "[k, l()]", "-m * n", "[]", "o(p)(q, r)"
+    };
+    static const char* const strays[] = { "", ",", "(", ")", "[", "]", "+", " x" };
+    std::string text(open);
+    for (auto count = 1 + random() % 40; count > 0; --count) {
+        text += elements[random() % (sizeof(elements) / sizeof(elements[0]))];
+        if (random() % 50 == 0) {
+            text += strays[random() % (sizeof(strays) / sizeof(strays[0]))];
+        }
+        if (count > 1) text += random() % 2 ? ", " : ",\n";
+    }
+    text += close;
+    return text;
+}
+
+} // namespace
+
+int main()
+{
+    auto tokens = frontend::TokenStream::tokenize(std::string_view("[a, f(b, c), [d, e]](x)"));
+    frontend::BracketIndex brackets(tokens);
+    expect(brackets.match(0) == 15 && brackets.match(15) == 0, "matching brackets");
+    expect(brackets.commas(0) == std::vector<frontend::TokenStream::Index>{ 2, 9 }, "top-level commas");
+    auto unbalanced = frontend::TokenStream::tokenize(std::string_view("[a, (b]"));
+    expect(frontend::BracketIndex(unbalanced).match(0) == frontend::BracketIndex::none, "unbalanced brackets");
+
+    frontend::ThreadPool pool(4);
+    std::vector<std::atomic<int>> visits(10000);
+    pool.parallelFor(visits.size(), [&](std::size_t index) { ++visits[index]; });
+    expect(std::ranges::all_of(visits, [](auto& count) { return count == 1; }), "every index runs once");
+    bool threw = false;
+    try {
+        pool.parallelFor(100, [](std::size_t index) {
+            if (index == 42) throw std::runtime_error("task");
+        });
+    } catch (std::runtime_error&) {
+        threw = true;
+    }
+    expect(threw, "exceptions reach the caller");
+
+    // Split even the smallest lists, into chunks of a few elements.
+    frontend::ParallelParser parallel(pool, { .minimumElements = 1, .chunksPerThread = 3 });
+    for (const char* text : {
+        "[]", "f()", "[a]", "[a, b]", "f(a, b)", "a.b[0](c, d)(e)", "-f(a, b)", "a + f(b, c)", "[a, b] x",
+        "x[a, b]", "[a, , b]", "[a, b,]", "f(a, b", "[a, (b]", "[a b, c]", "f(a)(b, c]", "!a++(b, c)", "\"s\"(1, 2)"
+    }) {
+        compare(parallel, text);
+    }
+    std::mt19937 random(13);
+    for (int round = 0; round < 3000 && failures < 10; ++round) {
+        compare(parallel, generate(random, "[", "]"));
+        compare(parallel, generate(random, "call.member(", ")"));
+    }
+    if (failures > 0) {
+        return 1;
+    }
+    std::cout << "Parallel parsing matches the sequential parser (" << parsed << " valid inputs)." << std::endl;
+    return 0;
+}
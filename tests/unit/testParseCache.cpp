@@ -0,0 +1,104 @@
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "FlatAST.hpp"
+#include "ParseCache.hpp"
+#include "Parser.hpp"
+
+#include "TestSupport.hpp"
+
+// Checks that ParseCache returns the trees a parser builds, shares them, evicts
+// the least recently used ones within its bounds, and stays correct when many
+// threads look up and evict at once.
+
+namespace {
+
+frontend::FlatAST parse(std::string_view text)
+{
+    return frontend::FlatAST::fromTree(*makeParser(text).parseExpression());
+}
+
+} // namespace
+
+int main()
+{
+    std::vector<std::string> texts;
+    for (int i = 0; i < 200; ++i) {
+        texts.push_back("rule" + std::to_string(i) + ".value >= [" + std::to_string(i) + ", f(x)][0] + " + std::to_string(i % 7));
+    }
+    std::vector<frontend::FlatAST> expected;
+    for (const auto& text : texts) expected.push_back(parse(text));
+
+    frontend::ParseCache cache;
+    auto first = cache.parse(texts[0]);
+    auto again = cache.parse(std::string(texts[0]));
+    expect(first == again, "a hit shares the tree");
+    expect(frontend::FlatAST::fromTree(first->root()) == expected[0], "cached tree matches a parse");
+    auto stats = cache.stats();
+    expect(stats.hits == 1 && stats.misses == 1 && stats.entries == 1, "hit and miss counters");
+    bool threw = false;
+    try {
+        cache.parse("a +");
+    } catch (std::exception&) {
+        threw = true;
+    }
+    expect(threw && cache.stats().entries == 1, "errors are thrown and not cached");
+    // The key is the whole text: a first expression followed by more tokens is no tree of it.
+    threw = false;
+    try {
+        cache.parse("a b )))");
+    } catch (std::exception&) {
+        threw = true;
+    }
+    expect(threw && cache.stats().entries == 1, "trailing tokens are an error");
+
+    // One shard holding a few entries: the least recently used goes first.
+    frontend::ParseCache small({ .maxBytes = 20000, .shards = 1 });
+    auto kept = small.parse(texts[0]);
+    for (int i = 1; i < 50; ++i) {
+        small.parse(texts[0]);
+        small.parse(texts[i]);
+    }
+    stats = small.stats();
+    expect(stats.evictions > 0 && stats.bytes <= 20000, "evicts within its bounds");
+    expect(small.parse(texts[0]) == kept, "recently used entries stay");
+    expect(frontend::FlatAST::fromTree(kept->root()) == expected[0], "evicted trees stay valid while held");
+
+    // Tiny trees are charged for the arena chunk each of them holds, which is sized from the tree.
+    frontend::ParseCache tiny({ .maxBytes = 1024 * 1024, .shards = 1 });
+    for (int i = 0; i < 10000; ++i) tiny.parse("x" + std::to_string(i));
+    stats = tiny.stats();
+    expect(stats.entries > 0 && stats.bytes <= 1024 * 1024, "one-token trees within the bytes");
+    expect(stats.entries * 512 > 1024 * 1024, "small arena chunks for one-token trees");
+
+    // Lookups from several threads, with constant evictions.
+    frontend::ParseCache shared({ .maxBytes = 100000, .shards = 4 });
+    std::vector<std::thread> threads;
+    std::vector<int> mismatches(8, 0);
+    for (std::size_t t = 0; t < mismatches.size(); ++t) {
+        threads.emplace_back([&, t] {
+            for (std::size_t i = 0; i < 20000; ++i) {
+                std::size_t index = (i * 7 + t * 13) % texts.size();
+                auto result = shared.parse(texts[index]);
+                if (result->root().to() != expected[index].tos()[0] || result->root().nodeType() != expected[index].types()[0]) {
+                    ++mismatches[t];
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    stats = shared.stats();
+    expect(std::ranges::count(mismatches, 0) == std::ranges::ssize(mismatches), "concurrent lookups return the right trees");
+    expect(stats.hits + stats.misses == 8 * 20000 && stats.evictions > 0, "counters under concurrency");
+    if (failures > 0) {
+        return 1;
+    }
+    std::cout << "ParseCache shares, evicts and stays consistent (" << stats.hits << " concurrent hits)." << std::endl;
+    return 0;
+}
@@ -1,34 +1,69 @@
+#include <cstdio>
 #include <cstdlib>
 #include <exception>
 #include <iostream>
 #include <fstream>
+#include <optional>
+#include <string_view>
 #include <utility>
 
+#include "Emitter.hpp"
 #include "Lexer.hpp"
 #include "Parser.hpp"
 
 void Usage()
 {
-    std::cerr << "Usage: ./testParser <file>" << std::endl;
+    std::cerr << "Usage: ./testParser [--format=dump|sexpr|json] <file>" << std::endl;
     exit(1);
 }
 
 int main(int argc, char* argv[])
 {
-    if (argc != 2) Usage();
-    std::ifstream file(argv[1]);
+    // No format: the dump() of every tree, as the tests expect.
+    std::optional<frontend::Emitter::Format> format;
+    if (argc == 3) {
+        std::string_view option = argv[1];
+        if (option == "--format=sexpr") {
+            format = frontend::Emitter::Format::SExpression;
+        } else if (option == "--format=json") {
+            format = frontend::Emitter::Format::Json;
+        } else if (option != "--format=dump") {
+            Usage();
+        }
+    } else if (argc != 2) {
+        Usage();
+    }
+    const char* path = argv[argc - 1];
+    std::ifstream file(path);
     if (!file.is_open()) {
-        std::cerr << "Failed to open file \"" << argv[1] << '"' << std::endl;
+        std::cerr << "Failed to open file \"" << path << '"' << std::endl;
         return 1;
     }
     try {
         frontend::Lexer<2> lexer(std::move(file));
         frontend::Parser parser(std::move(lexer));
-        auto ast = parser.parseExpression();
-        ast->dump(std::cout, 0);
+        if (format) {
+            // One tree per line, written in large blocks.
+            frontend::OutputBuffer out(stdout);
+            frontend::Emitter emitter(out, { .format = *format });
+            while (auto ast = parser.parseNext()) {
+                emitter.emit(*ast);
+            }
+            out.flush();
+            return 0;
+        }
+        // Every expression of the file, separated by a blank line.
+        bool first = true;
+        while (auto ast = parser.parseNext()) {
+            if (!first) {
+                std::cout << '\n';
+            }
+            first = false;
+            ast->dump(std::cout, 0);
+        }
     } catch (std::exception& exception) {
         std::cerr << "Error: " << exception.what() << std::endl;
         return 1;
     }
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,90 @@
+#include <cstddef>
+#include <exception>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+
+#include "FlatAST.hpp"
+#include "Parser.hpp"
+
+#include "TestSupport.hpp"
+
+// Checks that the iterative parser builds the same trees and reports the same
+// errors as the recursive one, and that it survives very deep nesting.
+
+namespace {
+
+std::string generate(std::mt19937& random)
+{
+    static const char* const pieces[] = {
+        "a", "1", "\"s\"", "+", "-", "*", "/", "%", "<<", ">>", ">>>", "<", "<=", ">", ">=", "==", "!=",
+        "++", "--", "!", "~", ".", "b", "(", ")", "[", "]", ",", " "
+    };
+    std::string text;
+    for (auto count = 1 + random() % 30; count > 0; --count) {
+        text += pieces[random() % (sizeof(pieces) / sizeof(pieces[0]))];
+    }
+    return text;
+}
+
+std::string nested(std::string_view open, std::string_view middle, std::string_view close, std::size_t depth)
+{
+    std::string text;
+    text.reserve(depth * (open.size() + close.size()) + middle.size());
+    for (std::size_t i = 0; i < depth; ++i) text += open;
+    text += middle;
+    for (std::size_t i = 0; i < depth; ++i) text += close;
+    return text;
+}
+
+} // namespace
+
+int main()
+{
+    std::mt19937 random(2024);
+    int parsed = 0;
+    for (int round = 0; round < 20000 && failures < 10; ++round) {
+        std::string text = generate(random);
+        ParseOutcome recursive = outcomeOf([&] { return frontend::FlatAST::fromTree(*makeParser(text).parseExpression()); });
+        ParseOutcome iterative = outcomeOf([&] { return frontend::FlatAST::fromTree(*makeParser(text).parseExpressionIterative()); });
+        ParseOutcome arena = outcomeOf([&] {
+            auto result = makeParser(text).parseExpressionIterativeInArena();
+            return frontend::FlatAST::fromTree(result.root());
+        });
+        if (recursive != iterative || recursive != arena) {
+            std::cerr << "Mismatch for input: \"" << text << '"' << std::endl;
+            ++failures;
+        }
+        parsed += recursive.error.empty();
+    }
+    // Deep enough to overflow the call stack of the recursive parser and destructors.
+    constexpr std::size_t depth = 200000;
+    const std::string deep[] = {
+        nested("[", "a", "]", depth),
+        nested("~", "a", "", depth),
+        nested("f(", "a", ")", depth),
+        nested("a[", "0", "]", depth),
+        nested("[a, -", "b", "]", depth)
+    };
+    for (const auto& text : deep) {
+        try {
+            auto tree = makeParser(text).parseExpressionIterative();
+            auto flat = frontend::FlatAST::fromTree(*tree);
+            if (flat.size() < depth) {
+                std::cerr << "Deep input parsed into " << flat.size() << " nodes." << std::endl;
+                ++failures;
+            }
+            auto result = makeParser(text).parseExpressionIterativeInArena();
+        } catch (std::exception& exception) {
+            std::cerr << "Deep input failed: " << exception.what() << std::endl;
+            ++failures;
+        }
+    }
+    if (failures > 0) {
+        return 1;
+    }
+    std::cout << "Iterative parser matches the recursive parser (" << parsed << " valid inputs) and handles depth "
+              << depth << "." << std::endl;
+    return 0;
+}
@@ -0,0 +1,112 @@
+#include <cstddef>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Arena.hpp"
+#include "Parser.hpp"
+#include "TokenStream.hpp"
+
+#include "TestSupport.hpp"
+
+// Checks how parseAll() and the arena-backed expression stream split their input.
+
+namespace {
+
+// The source ranges of every expression.
+std::vector<std::string> split(std::string_view text)
+{
+    std::vector<std::string> ranges;
+    auto parser = makeParser(text);
+    for (const auto& expression : parser.parseAll()) {
+        ranges.emplace_back(text.substr(expression->from(), expression->to() - expression->from()));
+    }
+    // The same split from the arena stream and from a token stream.
+    std::vector<std::string> streamed;
+    frontend::Arena arena;
+    auto again = makeParser(text);
+    for (const auto& expression : again.expressions(arena)) {
+        streamed.emplace_back(text.substr(expression.from(), expression.to() - expression.from()));
+    }
+    std::vector<std::string> tokenized;
+    auto tokens = frontend::TokenStream::tokenize(text);
+    frontend::Parser<frontend::TokenCursor> cursor{ frontend::TokenCursor(tokens) };
+    while (auto expression = cursor.parseNext()) {
+        tokenized.emplace_back(text.substr(expression->from(), expression->to() - expression->from()));
+    }
+    if (streamed != ranges || tokenized != ranges) {
+        std::cerr << "Streams disagree for: \"" << text << '"' << std::endl;
+        ++failures;
+    }
+    return ranges;
+}
+
+void expectSplit(std::string_view text, const std::vector<std::string>& expected)
+{
+    try {
+        if (split(text) != expected) {
+            std::cerr << "Wrong split for: \"" << text << '"' << std::endl;
+            ++failures;
+        }
+    } catch (std::exception& exception) {
+        std::cerr << "Failed on \"" << text << "\": " << exception.what() << std::endl;
+        ++failures;
+    }
+}
+
+// Every way of splitting text must throw.
+void expectRejected(std::string_view text)
+{
+    auto throws = [](auto&& parse) {
+        try {
+            parse();
+        } catch (std::exception&) {
+            return true;
+        }
+        return false;
+    };
+    bool all = throws([&] { makeParser(text).parseAll(); }) && throws([&] {
+        frontend::Arena arena;
+        auto parser = makeParser(text);
+        for (const auto& expression : parser.expressions(arena)) static_cast<void>(expression);
+    }) && throws([&] {
+        auto tokens = frontend::TokenStream::tokenize(text);
+        frontend::Parser<frontend::TokenCursor> cursor{ frontend::TokenCursor(tokens) };
+        while (cursor.parseNext()) {}
+    });
+    if (!all) {
+        std::cerr << "Accepted: \"" << text << '"' << std::endl;
+        ++failures;
+    }
+}
+
+} // namespace
+
+int main()
+{
+    expectSplit("", {});
+    expectSplit(" ;; // nothing\n", {});
+    expectSplit("a", { "a" });
+    expectSplit("a; b;c", { "a", "b", "c" });
+    expectSplit("a + b;\n", { "a + b" });
+    // A line break ends a complete expression, even before an operator.
+    expectSplit("a\nb\n-c", { "a", "b", "-c" });
+    expectSplit("[1, 2]\n[3][0]\nf\n[x]", { "[1, 2]", "[3][0]", "f", "[x]" });
+    // Incomplete expressions and brackets continue on the next line.
+    expectSplit("a +\n b", { "a +\n b" });
+    expectSplit("[1,\n 2\n + 3]\nf(a\n, b)", { "[1,\n 2\n + 3]", "f(a\n, b)" });
+    expectSplit("x[\n0\n]++ /* a\nb */ y", { "x[\n0\n]++", "y" });
+    // Expressions on the same line need a ';' between them.
+    expectRejected("a b");
+    expectRejected("1 2 3");
+    expectRejected("a + b c * d");
+    expectRejected("a;\nb c");
+    expectRejected("x[0] f(a)\n");
+    if (failures > 0) {
+        return 1;
+    }
+    std::cout << "Expressions are split on separators and line breaks." << std::endl;
+    return 0;
+}
@@ -0,0 +1,73 @@
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "Scanner.hpp"
+
+using frontend::scanner::Isa;
+
+namespace {
+
+const char* name(Isa isa)
+{
+    switch (isa) {
+        case Isa::Scalar: return "Scalar";
+        case Isa::SSE2: return "SSE2";
+        case Isa::AVX2: return "AVX2";
+    }
+    return "?";
+}
+
+// Runs every kernel from every offset of the input and compares against the scalar kernels.
+int check(Isa isa, const std::string& input)
+{
+    namespace scanner = frontend::scanner;
+    int failures = 0;
+    const char* begin = input.data();
+    const char* end = begin + input.size();
+    for (const char* p = begin; p <= end; ++p) {
+        scanner::use(Isa::Scalar);
+        const char* expected[] = {
+            scanner::skipWhitespace(p, end), scanner::findLineEnd(p, end), scanner::findBlockCommentEnd(p, end),
+            scanner::skipIdentifier(p, end), scanner::skipDigits(p, end)
+        };
+        scanner::use(isa);
+        const char* actual[] = {
+            scanner::skipWhitespace(p, end), scanner::findLineEnd(p, end), scanner::findBlockCommentEnd(p, end),
+            scanner::skipIdentifier(p, end), scanner::skipDigits(p, end)
+        };
+        for (int kernel = 0; kernel < 5; ++kernel) {
+            if (expected[kernel] != actual[kernel]) {
+                std::cerr << name(isa) << ": kernel " << kernel << " differs at offset " << (p - begin) << std::endl;
+                ++failures;
+            }
+        }
+    }
+    return failures;
+}
+
+} // namespace
+
+int main()
+{
+    static const char alphabet[] = " \t\n\r\v\f*/_azAZ09@[`{\x80\xff";
+    std::mt19937 random(7);
+    int failures = 0;
+    for (int round = 0; round < 200 && failures == 0; ++round) {
+        std::string input(random() % 160, ' ');
+        for (auto& c : input) {
+            c = alphabet[random() % (sizeof(alphabet) - 1)];
+        }
+        for (Isa isa : { Isa::SSE2, Isa::AVX2 }) {
+            if (static_cast<int>(isa) <= static_cast<int>(frontend::scanner::detect())) {
+                failures += check(isa, input);
+            }
+        }
+    }
+    if (failures > 0) {
+        return 1;
+    }
+    std::cout << "Scanner kernels match the scalar implementation up to " << name(frontend::scanner::detect()) << "." << std::endl;
+    return 0;
+}
@@ -0,0 +1,83 @@
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "StringRepository.hpp"
+
+#include "TestSupport.hpp"
+
+// Checks the handles of the interning table, alone and from many threads at once.
+
+namespace {
+
+using frontend::string::StringRepository;
+
+// More strings than a chunk of the table holds, so that interning them from several
+// threads publishes new chunks while others read.
+constexpr std::size_t stringCount = 20000;
+constexpr std::size_t threadCount = 8;
+
+std::string nameOf(std::size_t index)
+{
+    return "interned_" + std::to_string(index);
+}
+
+} // namespace
+
+int main()
+{
+    auto& repository = StringRepository::instance();
+    expect(repository.get(0).empty(), "handle 0 is the empty string");
+    expect(repository.intern("") == 0, "the empty string interns as handle 0");
+
+    auto a = repository.intern("alpha");
+    auto b = repository.intern("beta");
+    expect(a != b, "different strings, different handles");
+    expect(repository.intern(std::string("alp") + "ha") == a, "equal strings, equal handles");
+    expect(repository.get(a) == "alpha" && repository.get(b) == "beta", "get() of intern()");
+    // Not cut at a null character.
+    std::string_view withNull("a\0b", 3);
+    expect(repository.get(repository.intern(withNull)) == withNull, "a string holding a null character");
+
+    // Every thread interns all the strings in an order of its own, half of them twice,
+    // and checks get() of each handle it gets.
+    std::vector<std::vector<StringRepository::Handle>> handles(threadCount,
+        std::vector<StringRepository::Handle>(stringCount));
+    std::vector<std::size_t> mismatches(threadCount);
+    {
+        std::vector<std::jthread> threads;
+        for (std::size_t thread = 0; thread < threadCount; ++thread) {
+            threads.emplace_back([&, thread] {
+                std::vector<std::size_t> order(stringCount + stringCount / 2);
+                for (std::size_t i = 0; i < order.size(); ++i) order[i] = i % stringCount;
+                std::shuffle(order.begin(), order.end(), std::mt19937(static_cast<unsigned>(thread)));
+                for (std::size_t index : order) {
+                    std::string name = nameOf(index);
+                    auto handle = repository.intern(name);
+                    mismatches[thread] += repository.get(handle) != name;
+                    handles[thread][index] = handle;
+                }
+            });
+        }
+    }
+    for (std::size_t thread = 0; thread < threadCount; ++thread) {
+        expect(mismatches[thread] == 0, "get() of intern() from thread " + std::to_string(thread));
+        expect(handles[thread] == handles[0], "the handles of thread " + std::to_string(thread));
+    }
+    auto distinct = handles[0];
+    std::sort(distinct.begin(), distinct.end());
+    expect(std::adjacent_find(distinct.begin(), distinct.end()) == distinct.end(), "one handle per string");
+    expect(repository.size() >= stringCount + 3, "size()");
+
+    if (failures > 0) {
+        return 1;
+    }
+    std::cout << "The string repository gives one handle per string, from " << threadCount << " threads."
+              << std::endl;
+    return 0;
+}
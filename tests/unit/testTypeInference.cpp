@@ -0,0 +1,171 @@
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include "ExpressionType.hpp"
+#include "FlatAST.hpp"
+#include "Parser.hpp"
+#include "TypeInference.hpp"
+
+#include "TestSupport.hpp"
+
+// Infers the types of small expressions and compares them with the rules, then
+// types a chain of two million nodes.
+
+namespace {
+
+using frontend::BasicExpressionType;
+using frontend::ExpressionType;
+
+frontend::TypeInference::Environment environment()
+{
+    const auto& int32 = ExpressionType::basic(BasicExpressionType::Int32);
+    return {
+        { "a", &int32 },
+        { "b", &ExpressionType::basic(BasicExpressionType::Uint8) },
+        { "c", &ExpressionType::basic(BasicExpressionType::Uint64) },
+        { "u", &ExpressionType::basic(BasicExpressionType::Uint256) },
+        { "s", &ExpressionType::basic(BasicExpressionType::String) },
+        { "xs", &ExpressionType::arrayOf(int32) },
+        { "m", &ExpressionType::arrayOf(ExpressionType::basic(BasicExpressionType::Uint16), 2) }
+    };
+}
+
+// The type of the whole expression, or the first diagnostic.
+std::string typeOf(std::string_view text)
+{
+    auto tree = makeParser(text).parseExpression();
+    auto flat = frontend::FlatAST::fromTree(*tree);
+    frontend::TypeInference inference(environment());
+    inference.infer(flat);
+    if (!inference.diagnostics().empty()) return inference.diagnostics().front().message;
+    const ExpressionType* type = inference.type(0);
+    return type ? type->toString() : "untyped";
+}
+
+void expectType(std::string_view text, std::string_view type)
+{
+    try {
+        std::string actual = typeOf(text);
+        if (actual != type) {
+            std::cerr << "Failed: \"" << text << "\" has type " << actual << " instead of " << type << std::endl;
+            ++failures;
+        }
+    } catch (std::exception& exception) {
+        std::cerr << "Failed: \"" << text << "\": " << exception.what() << std::endl;
+        ++failures;
+    }
+}
+
+} // namespace
+
+int main()
+{
+    // Literals take the narrowest unsigned type.
+    expectType("0", "uint8");
+    expectType("255", "uint8");
+    expectType("256", "uint16");
+    expectType("0xffffffff", "uint32");
+    expectType("0b100000000000000000000000000000000", "uint40");
+    expectType("18446744073709551616", "uint72");
+    expectType("0x" + std::string(64, 'f'), "uint256");
+    expectType("0x1" + std::string(64, '0'), "Integer literal does not fit in 256 bits.");
+    expectType("\"text\"", "string");
+    // Arithmetic promotes to the common type.
+    expectType("b + 1", "uint8");
+    expectType("b * 1000", "uint16");
+    expectType("a + b", "int32");
+    expectType("a - c", "int72");
+    expectType("c / 3 % b", "uint64");
+    expectType("-b", "int16");
+    expectType("-a", "int32");
+    expectType("~c", "uint64");
+    expectType("a++", "int32");
+    expectType("s + \"x\"", "string");
+    // Shifts keep their left operand.
+    expectType("b << 64", "uint8");
+    expectType("a >> c >>> b", "int32");
+    // Comparisons and ! give booleans.
+    expectType("a < c", "bool");
+    expectType("s <= \"x\"", "bool");
+    expectType("xs == xs", "bool");
+    expectType("a != c", "bool");
+    expectType("!a", "bool");
+    expectType("!a == !b", "bool");
+    // Arrays.
+    expectType("[1, 300, b]", "uint16[]");
+    expectType("[a, c]", "int72[]");
+    expectType("[[1], [2, 3]]", "uint8[][]");
+    expectType("[s, \"x\"]", "string[]");
+    expectType("xs[b]", "int32");
+    expectType("m[0][1] + 1", "uint16");
+    // Errors.
+    expectType("a + s", "Expected integers, got int32 and string.");
+    expectType("[a, s]", "Expected elements of one type, got int32 and string.");
+    expectType("[]", "The element type of an empty array is unknown.");
+    expectType("a[0]", "Expected an array and an integer, got int32 and uint8.");
+    expectType("-s", "Expected an integer, got string.");
+    expectType("!xs", "Expected a boolean or an integer, got int32[].");
+    expectType("a < b < c", "Expected integers or strings, got bool and uint64.");
+    expectType("\"s\" == 1", "Expected integers or operands of one type, got string and uint8.");
+    expectType("[1] != \"s\"", "Expected integers or operands of one type, got uint8[] and string.");
+    expectType("xs == 1", "Expected integers or operands of one type, got int32[] and uint8.");
+    expectType("unknown + 1", "Unknown variable 'unknown'.");
+    // Mixed signs widen, up to 256 bits.
+    expectType("u + 1", "uint256");
+    expectType("-c + 0x" + std::string(62, 'f'), "int256");
+    expectType("u - a", "No integer type holds both uint256 and int32.");
+    expectType("[-1, u]", "No integer type holds both int16 and uint256.");
+    expectType("-u", "No integer type holds the negation of uint256.");
+    // Members and calls are untyped, only the variables among them are looked up.
+    expectType("s.length", "untyped");
+    expectType("f(a)", "untyped");
+    expectType("f(a)(b) + xs.n * 2", "untyped");
+    expectType("f(unknown)", "Unknown variable 'unknown'.");
+    expectType("unknown.f(a)", "Unknown variable 'unknown'.");
+    // Untyped operands give no more diagnostics.
+    try {
+        auto tree = makeParser("a + s - 1 + s.n * 2").parseExpression();
+        auto flat = frontend::FlatAST::fromTree(*tree);
+        frontend::TypeInference inference(environment());
+        inference.infer(flat);
+        if (inference.diagnostics().size() != 1 || inference.type(0) != nullptr) {
+            std::cerr << "Failed: diagnostics of untyped operands" << std::endl;
+            ++failures;
+        }
+    } catch (std::exception& exception) {
+        std::cerr << "Failed: " << exception.what() << std::endl;
+        ++failures;
+    }
+
+    // Every node of a long chain, in linear time.
+    std::string chain = "a";
+    for (int i = 0; i < 250000; ++i) chain += " + b * [1, c][0]";
+    try {
+        auto tree = makeParser(chain).parseExpressionIterative();
+        auto flat = frontend::FlatAST::fromTree(*tree);
+        frontend::TypeInference inference(environment());
+        auto start = std::chrono::steady_clock::now();
+        inference.infer(flat);
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        std::size_t typed = 0;
+        for (const auto* type : inference.types()) typed += type != nullptr;
+        if (typed != flat.size() || inference.type(0)->toString() != "int72") {
+            std::cerr << "Failed: " << typed << " of " << flat.size() << " nodes typed in a chain" << std::endl;
+            ++failures;
+        } else {
+            std::cout << "Typed " << flat.size() << " nodes in " << elapsed.count() << " ms." << std::endl;
+        }
+    } catch (std::exception& exception) {
+        std::cerr << "Failed: " << exception.what() << std::endl;
+        ++failures;
+    }
+    if (failures > 0) {
+        return 1;
+    }
+    std::cout << "Type inference follows the rules." << std::endl;
+    return 0;
+}
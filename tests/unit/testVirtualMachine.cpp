@@ -0,0 +1,185 @@
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <iostream>
+#include <random>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Bytecode.hpp"
+#include "Parser.hpp"
+#include "TreeInterpreter.hpp"
+#include "Value.hpp"
+#include "VirtualMachine.hpp"
+
+#include "TestSupport.hpp"
+
+// Runs random expressions on the virtual machine and on the tree interpreter and
+// compares the results, the side effects on the inputs and the errors.
+
+namespace {
+
+// Fresh inputs for every evaluation, arrays and objects are shared by reference.
+backend::TreeInterpreter::Environment environment()
+{
+    backend::Object object;
+    object.emplace("n", backend::Value(std::int64_t(5)));
+    object.emplace("s", backend::Value("member"));
+    return {
+        { "a", backend::Value(std::int64_t(7)) },
+        { "b", backend::Value(std::int64_t(-3)) },
+        { "s", backend::Value("text") },
+        { "xs", backend::Value(backend::Array{ std::int64_t(1), std::int64_t(2), std::int64_t(3) }) },
+        { "o", backend::Value(std::move(object)) },
+        { "f", backend::Value(backend::Function([](std::span<const backend::Value> arguments) {
+              backend::Integer sum = std::int64_t(arguments.size());
+              for (const auto& argument : arguments) {
+                  if (argument.isInteger()) sum = sum * 31 + argument.integer();
+              }
+              return backend::Value(sum);
+          })) }
+    };
+}
+
+std::string generate(std::mt19937& random, int depth)
+{
+    static const char* const leaves[] = { "a", "b", "s", "xs", "o", "f", "0", "1", "2", "64", "-1",
+        "9223372036854775807", "\"x\"", "\"y\"", "o.n", "o.s", "xs[1]" };
+    static const char* const binary[] = { "+", "-", "*", "/", "%", "<<", ">>", ">>>", "<", "<=", ">", ">=",
+        "==", "!=" };
+    static const char* const unary[] = { "-", "+", "!", "~" };
+    static const char* const targets[] = { "a", "b", "s", "xs[0]", "xs[2]", "o.n", "o.s", "o.m", "f", "1" };
+    if (depth == 0) return leaves[random() % std::size(leaves)];
+    switch (random() % 8) {
+        case 0:
+        case 1:
+        case 2:
+            return generate(random, depth - 1) + ' ' + binary[random() % std::size(binary)] + ' ' +
+                generate(random, depth - 1);
+        case 3:
+            return std::string(unary[random() % std::size(unary)]) + ' ' + generate(random, 0);
+        case 4: {
+            std::string target = targets[random() % std::size(targets)];
+            switch (random() % 4) {
+                case 0: return target + "++";
+                case 1: return target + "--";
+                case 2: return "++" + target;
+                default: return "--" + target;
+            }
+        }
+        case 5:
+            return "[" + generate(random, depth - 1) + ", " + generate(random, depth - 1) + "]";
+        case 6:
+            return "f(" + generate(random, depth - 1) + ", " + generate(random, depth - 1) + ")";
+        default:
+            return "xs[" + generate(random, depth - 1) + "]";
+    }
+}
+
+// The result or the error, then the inputs after the evaluation.
+struct Outcome {
+    std::string result;
+    bool threw = false;
+    std::vector<std::string> inputs;
+};
+
+Outcome interpret(const frontend::Expression& expression)
+{
+    auto variables = environment();
+    Outcome outcome;
+    try {
+        outcome.result = backend::TreeInterpreter(variables).evaluate(expression).toString();
+    } catch (std::exception&) {
+        outcome.threw = true;
+        return outcome;
+    }
+    for (const char* name : { "a", "b", "s", "xs", "o" }) {
+        outcome.inputs.push_back(variables.at(name).toString());
+    }
+    return outcome;
+}
+
+Outcome execute(backend::VirtualMachine& machine, const frontend::Expression& expression)
+{
+    auto variables = environment();
+    Outcome outcome;
+    try {
+        auto program = backend::Compiler::compile(expression);
+        std::vector<backend::Value> inputs;
+        for (const auto& name : program.inputs()) {
+            inputs.push_back(variables.at(name.str()));
+        }
+        outcome.result = machine.run(program, inputs).toString();
+        for (std::size_t i = 0; i < inputs.size(); ++i) {
+            variables.at(program.inputs()[i].str()) = inputs[i];
+        }
+    } catch (std::exception&) {
+        outcome.threw = true;
+        return outcome;
+    }
+    for (const char* name : { "a", "b", "s", "xs", "o" }) {
+        outcome.inputs.push_back(variables.at(name).toString());
+    }
+    return outcome;
+}
+
+} // namespace
+
+int main()
+{
+    std::mt19937 random(18);
+    backend::VirtualMachine machine;
+    int evaluated = 0;
+    for (int round = 0; round < 20000 && failures < 10; ++round) {
+        std::string text = generate(random, 1 + random() % 4);
+        try {
+            auto tree = makeParser(text).parseExpression();
+            Outcome expected = interpret(*tree);
+            Outcome actual = execute(machine, *tree);
+            if (actual.threw != expected.threw || actual.result != expected.result || actual.inputs != expected.inputs) {
+                std::cerr << "Mismatch for \"" << text << "\": " << actual.result << " instead of " << expected.result
+                          << std::endl;
+                ++failures;
+            }
+            evaluated += !expected.threw;
+        } catch (std::exception& exception) {
+            std::cerr << "Failed to parse \"" << text << "\": " << exception.what() << std::endl;
+            ++failures;
+        }
+    }
+    // Running a program again reuses its registers, with new inputs.
+    try {
+        auto tree = makeParser("a * 3 + b / 7 - a % 5 + [a, b][1]++").parseExpression();
+        auto program = backend::Compiler::compile(*tree);
+        for (std::int64_t i = 0; i < 100; ++i) {
+            std::vector<backend::Value> inputs{ i, i * 7 + 1 };
+            auto result = machine.run(program, inputs);
+            expect(result == backend::Value(i * 3 + (i * 7 + 1) / 7 - i % 5 + i * 7 + 1), "repeated runs");
+        }
+        // Temporaries are reused: a chain of any length needs one.
+        std::string chain = "a";
+        for (int i = 0; i < 100000; ++i) chain += " + a";
+        auto chainTree = makeParser(chain).parseExpressionIterative();
+        auto chainProgram = backend::Compiler::compile(*chainTree);
+        std::vector<backend::Value> inputs{ std::int64_t(2) };
+        expect(chainProgram.registerCount() == 2, "registers of a chain");
+        expect(machine.run(chainProgram, inputs) == backend::Value(std::int64_t(200002)), "chain");
+        // Deeper than the call stack allows.
+        std::string deep(200000, '~');
+        deep += "a";
+        auto deepTree = makeParser(deep).parseExpressionIterative();
+        auto deepProgram = backend::Compiler::compile(*deepTree);
+        expect(machine.run(deepProgram, inputs) == backend::Value(std::int64_t(2)), "deep nesting");
+    } catch (std::exception& exception) {
+        std::cerr << "Failed: " << exception.what() << std::endl;
+        ++failures;
+    }
+    if (failures > 0) {
+        return 1;
+    }
+    std::cout << "The virtual machine matches the tree interpreter (" << evaluated << " valid expressions)."
+              << std::endl;
+    return 0;
+}
@@ -0,0 +1,147 @@
+#include <array>
+#include <cstddef>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Parser.hpp"
+#include "Visitor.hpp"
+
+#include "TestSupport.hpp"
+
+// Checks that the static dispatch of the visitors reaches every node once, and the
+// mutating and rewriting forms.
+
+static_assert(std::is_same_v<frontend::NodeClass<frontend::NodeType::ShiftRightLogic>, frontend::ShiftRightLogic>);
+static_assert(std::is_same_v<frontend::NodeClass<frontend::NodeType::MemberAccess>, frontend::MemberAccess>);
+
+namespace {
+
+constexpr std::size_t nodeTypeCount = static_cast<std::size_t>(frontend::NodeType::NotEquals) + 1;
+
+// Counts the nodes of each type, and checks that every handler gets its class.
+struct Counter : frontend::ConstVisitor<Counter> {
+    std::array<std::size_t, nodeTypeCount> counts{};
+    std::size_t unary = 0;
+    std::size_t binary = 0;
+
+    void visitIdentifier(const frontend::Identifier& node) { count(node); }
+    void visitNumericLiteral(const frontend::NumericLiteral& node) { count(node); }
+    void visitMemberAccess(const frontend::MemberAccess& node) { count(node); }
+    void visitUnaryOperator(const frontend::UnaryOperator& node)
+    {
+        ++unary;
+        count(node);
+    }
+    void visitBinaryOperator(const frontend::BinaryOperator& node)
+    {
+        ++binary;
+        count(node);
+    }
+    void visitExpression(const frontend::Expression& node) { count(node); }
+
+    void count(const frontend::Expression& node) { ++counts[static_cast<std::size_t>(node.nodeType())]; }
+};
+
+// Moves every node, through the mutable form.
+struct Mover : frontend::MutableVisitor<Mover> {
+    void visitExpression(frontend::Expression& node) { node.shift(100); }
+};
+
+// The name of an identifier, empty for the other nodes.
+struct Names : frontend::ConstVisitor<Names, std::string> {
+    std::string visitIdentifier(const frontend::Identifier& node) { return node.identifier().str(); }
+};
+
+// Replaces - of a literal by a negative literal.
+struct NegativeLiterals : frontend::Rewriter<NegativeLiterals> {
+    frontend::NodePtr<frontend::Expression> rewriteNegative(frontend::Negative& node)
+    {
+        if (node.argument().nodeType() != frontend::NodeType::NumericLiteral) return nullptr;
+        const auto& literal = static_cast<const frontend::NumericLiteral&>(node.argument());
+        return frontend::NodeFactory().make<frontend::NumericLiteral>("-" + literal.literal().str(), node.from(),
+            node.to());
+    }
+};
+
+} // namespace
+
+int main()
+{
+    try {
+        auto tree = makeParser("a.b[1](c, \"s\", [2, -3]) + -x++ * ~y << 4 != !z >>> -5 - -w").parseExpression();
+
+        Counter counter;
+        counter.traverse(*tree);
+        std::array<std::size_t, nodeTypeCount> expected{};
+        using frontend::NodeType;
+        for (auto [type, count] : { std::pair{ NodeType::Identifier, 7 }, { NodeType::NumericLiteral, 5 },
+                 { NodeType::StringLiteral, 1 }, { NodeType::ArrayLiteral, 1 }, { NodeType::MemberAccess, 1 },
+                 { NodeType::SubscriptAccess, 1 }, { NodeType::FunctionCall, 1 }, { NodeType::Negative, 4 },
+                 { NodeType::PostIncrement, 1 }, { NodeType::BitwiseNot, 1 }, { NodeType::LogicalNegation, 1 },
+                 { NodeType::Addition, 1 }, { NodeType::Subtraction, 1 }, { NodeType::Multiplication, 1 },
+                 { NodeType::ShiftLeft, 1 }, { NodeType::ShiftRightLogic, 1 }, { NodeType::NotEquals, 1 } }) {
+            expected[static_cast<std::size_t>(type)] = static_cast<std::size_t>(count);
+        }
+        expect(counter.counts == expected, "every node once");
+        expect(counter.unary == 7, "unary operators");
+        expect(counter.binary == 6, "binary operators");
+
+        std::vector<std::string> order;
+        struct Order : frontend::ConstVisitor<Order> {
+            std::vector<std::string>* names;
+            void visitIdentifier(const frontend::Identifier& node) { names->push_back(node.identifier().str()); }
+        } collector;
+        collector.names = &order;
+        collector.traverse(*tree);
+        expect(order == std::vector<std::string>{ "a", "b", "c", "x", "y", "z", "w" }, "source order");
+
+        // dispatch() casts to the class, forEachChild() gives the operands.
+        std::string kind = frontend::dispatch(*tree, []<typename T>(const T&) -> std::string {
+            return std::is_same_v<T, frontend::NotEquals> ? "NotEquals" : "other";
+        });
+        expect(kind == "NotEquals", "dispatch");
+        std::size_t children = 0;
+        frontend::forEachChild(*tree, [&](const frontend::Expression&) { ++children; });
+        expect(children == 2, "forEachChild");
+
+        Names names;
+        expect(names.visit(*makeParser("name").parseExpression()) == "name", "visit with a result");
+        expect(names.visit(*tree).empty(), "the default result");
+
+        Mover mover;
+        std::size_t from = tree->from();
+        mover.traverse(*tree);
+        expect(tree->from() == from + 100 && static_cast<const frontend::NotEquals&>(*tree).rhs().from() > 100,
+            "mutable traversal");
+
+        NegativeLiterals negatives;
+        expect(negatives.rewrite(tree) == 2, "rewritten nodes");
+        auto original = makeParser("a.b[1](c, \"s\", [2, -3]) + -x++ * ~y << 4 != !z >>> -5 - -w").parseExpression();
+        std::string text = dump(*tree);
+        expect(text.find("Value: -3") != std::string::npos && text.find("Value: -5") != std::string::npos,
+            "negative literals");
+        expect(text.find("Negative") != std::string::npos, "- of a variable is kept");
+        expect(dump(*original) != text, "the tree changed");
+
+        // Deeper than the call stack allows.
+        std::string deep(200000, '~');
+        deep += "a";
+        auto deepTree = makeParser(deep).parseExpressionIterative();
+        Counter deepCounter;
+        deepCounter.traverse(*deepTree);
+        expect(deepCounter.unary == 200000, "deep traversal");
+    } catch (std::exception& exception) {
+        std::cerr << "Failed: " << exception.what() << std::endl;
+        ++failures;
+    }
+    if (failures > 0) {
+        return 1;
+    }
+    std::cout << "Static dispatch visits the same nodes as the virtual calls." << std::endl;
+    return 0;
+}
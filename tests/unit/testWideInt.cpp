@@ -0,0 +1,188 @@
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include "ExpressionType.hpp"
+#include "WideInt.hpp"
+
+#include "TestSupport.hpp"
+
+// Compares every WideInt width with __int128 arithmetic where it fits, with
+// bit-by-bit shifts and with division identities, on random and extreme values.
+
+using Int256 = frontend::WideInt<256, true>;
+using Uint256 = frontend::WideInt<256, false>;
+
+// Everything works at compile time.
+static_assert(Int256::max() + 1 == Int256::min());
+static_assert(Int256::min() / -1 == Int256::min());
+static_assert(frontend::WideInt<200, false>(-1) == frontend::WideInt<200, false>::max());
+static_assert(frontend::WideInt<72, true>(-7) / 2 == -3 && frontend::WideInt<72, true>(-7) % 2 == -1);
+static_assert((frontend::WideInt<24, true>(1) << 23) == frontend::WideInt<24, true>::min());
+static_assert(frontend::WideInt<24, true>(-1).shiftRightLogic(4) == 0x0fffff);
+static_assert(frontend::WideInt<160, true>(-1234).toString() == "-1234");
+static_assert(*Uint256::parse("0xffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff") == Uint256::max());
+static_assert(!frontend::WideInt<8, false>::parse("256") && *frontend::WideInt<8, true>::parse("-128") == -128);
+static_assert(frontend::integerWidth(frontend::BasicExpressionType::Int136) == 136);
+static_assert(std::is_same_v<frontend::WideIntOf<frontend::BasicExpressionType::Uint40>, frontend::WideInt<40, false>>);
+
+namespace {
+
+using frontend::detail::Int128;
+using frontend::detail::Uint128;
+
+// The first failures only, with the type they happened for.
+void expectFor(bool condition, const char* what, unsigned width, bool isSigned)
+{
+    if (!condition && failures < 20) {
+        expect(false, std::string(what) + " for " + (isSigned ? "Int" : "Uint") + std::to_string(width));
+    }
+}
+
+template <typename T>
+bool bit(const T& value, unsigned index)
+{
+    return value.limbs()[index / 64] >> (index % 64) & 1;
+}
+
+// Small, extreme and random values, the random ones spread over every limb count.
+template <typename T>
+T generate(std::mt19937_64& random)
+{
+    switch (random() % 8) {
+        case 0:
+            return T(static_cast<std::int64_t>(random() % 21) - 10);
+        case 1:
+            return random() % 2 ? T::min() : T::max();
+        case 2:
+            return T::min() + T(static_cast<std::int64_t>(random() % 3)) - 1;
+        default: {
+            typename T::Limbs limbs{};
+            std::size_t used = 1 + random() % T::limbCount;
+            for (std::size_t i = 0; i < used; ++i) limbs[i] = random();
+            T value = T::fromLimbs(limbs);
+            return random() % 2 ? value : -value;
+        }
+    }
+}
+
+// The value of a width up to 128, extended like the type.
+template <typename T>
+Uint128 native(const T& value)
+{
+    Uint128 result = value.limbs()[0];
+    if constexpr (T::limbCount == 2) {
+        result |= Uint128(value.limbs()[1]) << 64;
+    } else if (value.isNegative()) {
+        result |= ~Uint128(0) << 64;
+    }
+    return result;
+}
+
+template <typename T>
+T fromNative(Uint128 value)
+{
+    typename T::Limbs limbs{};
+    limbs[0] = static_cast<std::uint64_t>(value);
+    if constexpr (T::limbCount == 2) limbs[1] = static_cast<std::uint64_t>(value >> 64);
+    return T::fromLimbs(limbs);
+}
+
+template <typename T>
+void check(std::mt19937_64& random)
+{
+    constexpr unsigned width = T::bits;
+    constexpr bool isSigned = T::signedness;
+    using Wide = frontend::WideInt<256, isSigned>;
+    for (int round = 0; round < 2000; ++round) {
+        T a = generate<T>(random);
+        T b = generate<T>(random);
+        // Wrapping around is truncating the wider result.
+        expectFor(a + b == T(Wide(a) + Wide(b)), "addition", width, isSigned);
+        expectFor(a - b == T(Wide(a) - Wide(b)), "subtraction", width, isSigned);
+        expectFor(a * b == T(Wide(a) * Wide(b)), "multiplication", width, isSigned);
+        expectFor((a < b) == (Wide(a) < Wide(b)) && (a == b) == (Wide(a) == Wide(b)), "comparison", width, isSigned);
+        expectFor(~a == T(-1) - a && -a == T() - a, "negation", width, isSigned);
+        if constexpr (width <= 128) {
+            expectFor(a + b == fromNative<T>(native(a) + native(b)), "native addition", width, isSigned);
+            expectFor(a * b == fromNative<T>(native(a) * native(b)), "native multiplication", width, isSigned);
+            bool less = isSigned ? Int128(native(a)) < Int128(native(b)) : native(a) < native(b);
+            expectFor((a < b) == less, "native comparison", width, isSigned);
+        }
+        if (!b.isZero()) {
+            auto [quotient, remainder] = T::divide(a, b);
+            expectFor(quotient * b + remainder == a, "division identity", width, isSigned);
+            if (b != T::min() && a != T::min()) {
+                T magnitude = b.isNegative() ? -b : b;
+                expectFor((remainder.isNegative() ? -remainder : remainder) < magnitude, "remainder range", width, isSigned);
+                expectFor(remainder.isZero() || remainder.isNegative() == a.isNegative(), "remainder sign", width, isSigned);
+            }
+            if constexpr (width <= 64) {
+                Int128 x = Int128(native(a));
+                Int128 y = Int128(native(b));
+                if (!isSigned) {
+                    x &= ~std::uint64_t(0);
+                    y &= ~std::uint64_t(0);
+                }
+                expectFor(quotient == fromNative<T>(Uint128(x / y)), "native division", width, isSigned);
+                expectFor(remainder == fromNative<T>(Uint128(x % y)), "native remainder", width, isSigned);
+            }
+        } else {
+            bool threw = false;
+            try {
+                static_cast<void>(a / b);
+            } catch (std::domain_error&) {
+                threw = true;
+            }
+            expectFor(threw, "division by zero", width, isSigned);
+        }
+        unsigned count = static_cast<unsigned>(random() % (width + 2));
+        T left = a << count;
+        T right = a >> count;
+        T logic = a.shiftRightLogic(count);
+        bool shifted = true;
+        for (unsigned i = 0; i < width; ++i) {
+            bool sign = isSigned && bit(a, width - 1);
+            shifted = shifted && bit(left, i) == (i >= count && bit(a, i - count));
+            shifted = shifted && bit(right, i) == (i + count < width ? bit(a, i + count) : sign);
+            shifted = shifted && bit(logic, i) == (i + count < width && bit(a, i + count));
+        }
+        expectFor(shifted, "shifts", width, isSigned);
+        auto parsed = T::parse(a.toString());
+        expectFor(parsed && *parsed == a, "decimal round trip", width, isSigned);
+    }
+}
+
+} // namespace
+
+int main()
+{
+    std::mt19937_64 random(256);
+    try {
+        for (auto type = static_cast<unsigned>(frontend::BasicExpressionType::Uint8);
+             type <= static_cast<unsigned>(frontend::BasicExpressionType::Int256); ++type) {
+            frontend::visitIntegerType(static_cast<frontend::BasicExpressionType>(type),
+                [&]<typename T>() { check<T>(random); });
+        }
+    } catch (std::exception& exception) {
+        expect(false, exception.what());
+    }
+    expect(Uint256::max().toString() ==
+            "115792089237316195423570985008687907853269984665640564039457584007913129639935" &&
+        Int256::min().toString() ==
+            "-57896044618658097711785492504343953926634992332820282019728792003956564819968" &&
+        *Int256::parse("-57896044618658097711785492504343953926634992332820282019728792003956564819968") ==
+            Int256::min() &&
+        !Int256::parse("57896044618658097711785492504343953926634992332820282019728792003956564819968"),
+        "256-bit limits");
+    if (failures > 0) {
+        return 1;
+    }
+    std::cout << "WideInt matches the reference arithmetic for every width." << std::endl;
+    return 0;
+}